@@ -0,0 +1,88 @@
+#include "channel_binder.hpp"
+
+#include <algorithm>
+#include <utility>
+
+ChannelBinder::ChannelBinder(Gtk::Widget& host, ChannelBus& bus)
+: host_(host), bus_(bus) {
+  wake_.connect(sigc::mem_fun(*this, &ChannelBinder::schedule_));
+  listener_ = bus_.add_listener([this] { wake_.emit(); });
+}
+
+ChannelBinder::~ChannelBinder() {
+  bus_.remove_listener(listener_);
+  if (stale_timer_ != 0) g_source_remove(stale_timer_);
+  if (tick_id_ != 0) host_.remove_tick_callback(tick_id_);
+}
+
+void ChannelBinder::bind(std::string_view channel, Handler fn, double max_rate_hz) {
+  bindings_.push_back({ChannelSubscription(bus_.channel(channel), max_rate_hz), std::move(fn)});
+  schedule_();  // shows what the channel already holds
+}
+
+void ChannelBinder::bind(GaugeControl& gauge, std::string_view channel, double max_rate_hz) {
+  bind(channel, [&gauge](const Reading& r) {
+    if (r.valid) gauge.set_value(r.value);
+    gauge.set_stale(r.stale);
+  }, max_rate_hz);
+}
+
+void ChannelBinder::clear() {
+  bindings_.clear();
+  if (stale_timer_ != 0) g_source_remove(stale_timer_);
+  stale_timer_ = 0;
+}
+
+void ChannelBinder::schedule_() {
+  if (tick_id_ != 0) return;
+  tick_id_ = gtk_widget_add_tick_callback(host_.gobj(), &ChannelBinder::tick_, this, nullptr);
+}
+
+gboolean ChannelBinder::tick_(GtkWidget*, GdkFrameClock* clock, gpointer self) {
+  return static_cast<ChannelBinder*>(self)->on_tick_(gdk_frame_clock_get_frame_time(clock));
+}
+
+gboolean ChannelBinder::stale_timeout_(gpointer self) {
+  auto* b = static_cast<ChannelBinder*>(self);
+  b->stale_timer_ = 0;
+  b->schedule_();
+  return G_SOURCE_REMOVE;
+}
+
+bool ChannelBinder::on_tick_(gint64 now_us) {
+  // Re-arm first: a value published after this point must wake us again.
+  bus_.rearm(listener_);
+
+  bool delivered = false;
+  bool pending = false;
+  Reading r;
+  for (auto& b : bindings_) {
+    if (b.subscription.poll(now_us, r)) {
+      b.fn(r);
+      delivered = true;
+    }
+    pending |= b.subscription.pending();
+  }
+  if (delivered && after_deliver_) after_deliver_();
+  arm_stale_timer_(now_us);
+
+  if (pending) return true;
+  tick_id_ = 0;
+  return false;
+}
+
+void ChannelBinder::arm_stale_timer_(gint64 now_us) {
+  gint64 next = -1;
+  for (const auto& b : bindings_) {
+    const std::int64_t at = b.subscription.stale_at_us();
+    if (at >= 0 && (next < 0 || at < next)) next = at;
+  }
+  if (next < 0) return;
+  // A timer due no later is good enough: its tick re-arms for the rest.
+  if (stale_timer_ != 0 && stale_timer_at_us_ <= next) return;
+
+  if (stale_timer_ != 0) g_source_remove(stale_timer_);
+  stale_timer_at_us_ = next;
+  const auto ms = static_cast<unsigned>(std::clamp<gint64>((next - now_us + 999) / 1000, 1, 60'000));
+  stale_timer_ = g_timeout_add(ms, &ChannelBinder::stale_timeout_, this);
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "channel_bus.hpp"
+#include "gauge_control.hpp"
+
+#include <gtkmm.h>
+#include <cstddef>
+#include <functional>
+#include <string_view>
+#include <vector>
+
+// Connects ChannelBus channels to gauges (or any UI callback) of one
+// window. Values are pulled on the host widget's frame clock, at most once
+// per frame, however often producers publish.
+//
+// Nothing runs while the bound channels are quiet: a publish wakes the
+// binder through a Glib::Dispatcher, which installs a tick callback for the
+// next frame. The tick keeps running only while a rate limit holds a value
+// back. A timer wakes it once more when the newest value shown goes stale.
+class ChannelBinder {
+public:
+  using Reading = ChannelBus::Reading;
+  using Handler = std::function<void(const Reading&)>;
+
+  ChannelBinder(Gtk::Widget& host, ChannelBus& bus);
+  ~ChannelBinder();
+
+  ChannelBinder(const ChannelBinder&) = delete;
+  ChannelBinder& operator=(const ChannelBinder&) = delete;
+
+  // Calls `fn` on the UI thread with each new value of `channel`, at most
+  // `max_rate_hz` times per second (0: every frame with a new value), and
+  // once more when the value goes stale.
+  void bind(std::string_view channel, Handler fn, double max_rate_hz = 0.0);
+  // Drives a gauge: a new value moves it, and a stale one greys it out
+  // (GaugeControl::set_stale). The gauge must outlive the binding.
+  void bind(GaugeControl& gauge, std::string_view channel, double max_rate_hz = 0.0);
+
+  // Runs after each frame that delivered at least one value, e.g. to act on
+  // several channels together.
+  void set_after_deliver(std::function<void()> fn) { after_deliver_ = std::move(fn); }
+
+  void clear();
+  std::size_t size() const { return bindings_.size(); }
+
+private:
+  struct Binding {
+    ChannelSubscription subscription;
+    Handler fn;
+  };
+
+  void schedule_();
+  // C callbacks: sigc slots would be copied to the heap on every re-arm.
+  static gboolean tick_(GtkWidget* widget, GdkFrameClock* clock, gpointer self);
+  static gboolean stale_timeout_(gpointer self);
+  bool on_tick_(gint64 now_us);
+  void arm_stale_timer_(gint64 now_us);
+
+  Gtk::Widget& host_;
+  ChannelBus& bus_;
+  int listener_ = -1;
+  Glib::Dispatcher wake_;
+
+  std::vector<Binding> bindings_;
+  std::function<void()> after_deliver_;
+
+  guint tick_id_ = 0;
+  guint stale_timer_ = 0;  // GLib source id
+  gint64 stale_timer_at_us_ = 0;
+};
@@ -0,0 +1,176 @@
+#include "channel_bus.hpp"
+
+#include <bit>
+#include <cmath>
+#include <limits>
+
+// ---------------- Channel ----------------
+
+void ChannelBus::Channel::publish(double value, std::int64_t time_us) {
+  store_(std::bit_cast<std::uint64_t>(value), time_us);
+}
+
+void ChannelBus::Channel::invalidate(std::int64_t time_us) {
+  store_(std::bit_cast<std::uint64_t>(std::numeric_limits<double>::quiet_NaN()), time_us);
+}
+
+void ChannelBus::Channel::store_(std::uint64_t value_bits, std::int64_t time_us) {
+  // Claim the slot. An odd sequence means another writer is mid-store; its
+  // value is as new as ours, so ours is dropped rather than waiting.
+  std::uint64_t s = seq_.load(std::memory_order_relaxed);
+  do {
+    if (s & 1u) return;
+  } while (!seq_.compare_exchange_weak(s, s + 1, std::memory_order_relaxed));
+
+  std::atomic_thread_fence(std::memory_order_release);
+  value_bits_.store(value_bits, std::memory_order_relaxed);
+  time_us_.store(time_us, std::memory_order_relaxed);
+  seq_.store(s + 2, std::memory_order_release);
+
+  bus_->notify_();
+}
+
+ChannelBus::Reading ChannelBus::Channel::read(std::int64_t now_us) const {
+  Reading r;
+  std::uint64_t bits = 0;
+  std::uint64_t s0 = 0;
+  std::uint64_t s1 = 0;
+  do {
+    s0 = seq_.load(std::memory_order_acquire);
+    if (s0 & 1u) continue;
+    bits = value_bits_.load(std::memory_order_relaxed);
+    r.time_us = time_us_.load(std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    s1 = seq_.load(std::memory_order_relaxed);
+  } while ((s0 & 1u) || s0 != s1);
+
+  r.sequence = s0;
+  r.value = std::bit_cast<double>(bits);
+  r.valid = s0 != 0 && !std::isnan(r.value);
+  const std::int64_t max_age = max_age_us();
+  r.stale = !r.valid || (max_age > 0 && now_us - r.time_us > max_age);
+  return r;
+}
+
+// ---------------- Registry ----------------
+
+ChannelBus::Channel& ChannelBus::channel(std::string_view name) {
+  std::lock_guard lock(mutex_);
+  if (const auto it = by_name_.find(name); it != by_name_.end()) return *it->second;
+  Channel& c = channels_.emplace_back(*this, std::string(name));
+  by_name_.emplace(c.name(), &c);
+  return c;
+}
+
+ChannelBus::Channel* ChannelBus::find(std::string_view name) {
+  std::lock_guard lock(mutex_);
+  const auto it = by_name_.find(name);
+  return it != by_name_.end() ? it->second : nullptr;
+}
+
+std::size_t ChannelBus::size() const {
+  std::lock_guard lock(mutex_);
+  return channels_.size();
+}
+
+int ChannelBus::add_listener(std::function<void()> fn) {
+  std::lock_guard lock(mutex_);
+  for (std::size_t i = 0; i < kMaxListeners; ++i) {
+    Listener& l = listeners_[i];
+    if (l.active.load(std::memory_order_relaxed)) continue;
+    l.fn = std::move(fn);
+    l.armed.store(true, std::memory_order_relaxed);
+    l.active.store(true, std::memory_order_release);  // publishes fn to notify_()
+    if (i + 1 > listener_end_.load(std::memory_order_relaxed)) {
+      listener_end_.store(i + 1, std::memory_order_release);
+    }
+    return static_cast<int>(i);
+  }
+  return -1;
+}
+
+void ChannelBus::rearm(int id) {
+  if (id < 0 || static_cast<std::size_t>(id) >= kMaxListeners) return;
+  listeners_[id].armed.store(true, std::memory_order_release);
+}
+
+void ChannelBus::remove_listener(int id) {
+  if (id < 0 || static_cast<std::size_t>(id) >= kMaxListeners) return;
+  std::lock_guard lock(mutex_);
+  Listener& l = listeners_[id];
+  l.active.store(false, std::memory_order_release);
+  l.armed.store(false, std::memory_order_relaxed);
+  l.fn = nullptr;
+}
+
+void ChannelBus::notify_() {
+  const std::size_t end = listener_end_.load(std::memory_order_acquire);
+  for (std::size_t i = 0; i < end; ++i) {
+    Listener& l = listeners_[i];
+    if (!l.active.load(std::memory_order_acquire)) continue;
+    if (l.armed.exchange(false, std::memory_order_acq_rel)) l.fn();
+  }
+}
+
+// ---------------- Subscription ----------------
+
+ChannelSubscription::ChannelSubscription(const ChannelBus::Channel& channel, double max_rate_hz)
+: channel_(&channel) {
+  set_max_rate_hz(max_rate_hz);
+}
+
+void ChannelSubscription::set_max_rate_hz(double hz) {
+  min_interval_us_ = hz > 0.0 ? static_cast<std::int64_t>(1e6 / hz) : 0;
+}
+
+bool ChannelSubscription::poll(std::int64_t now_us, ChannelBus::Reading& out) {
+  const bool newer = channel_->sequence() != last_seq_;
+  if (newer && delivered_ && now_us - last_delivered_us_ < min_interval_us_) {
+    pending_ = true;
+    return false;
+  }
+
+  if (!newer) {
+    // Nothing new: only the age of the value shown can change.
+    const std::int64_t max_age = channel_->max_age_us();
+    const bool stale = !last_valid_ || (max_age > 0 && now_us - last_time_us_ > max_age);
+    if (stale == last_stale_) return false;
+  }
+
+  out = channel_->read(now_us);
+  if (newer) last_delivered_us_ = now_us;
+  last_seq_ = out.sequence;
+  last_time_us_ = out.time_us;
+  last_valid_ = out.valid;
+  last_stale_ = out.stale;
+  delivered_ = true;
+  pending_ = false;
+  return true;
+}
+
+std::int64_t ChannelSubscription::stale_at_us() const {
+  const std::int64_t max_age = channel_->max_age_us();
+  if (last_stale_ || max_age <= 0) return -1;
+  return last_time_us_ + max_age + 1;
+}
+
+// ---------------- Wind channels ----------------
+
+WindChannels::WindChannels(ChannelBus& bus)
+: awa(bus.channel(channels::kWindAngleApparent)),
+  aws(bus.channel(channels::kWindSpeedApparent)),
+  stw(bus.channel(channels::kSpeedThroughWater)),
+  heading(bus.channel(channels::kHeadingTrue)),
+  cog(bus.channel(channels::kCourseOverGround)),
+  sog(bus.channel(channels::kSpeedOverGround)) {}
+
+void WindChannels::publish(const WindSample& s) {
+  if (s.has_angle) awa.publish(s.awa_deg, s.time_us);
+  if (s.has_speed) aws.publish(s.aws_kn, s.time_us);
+  if (s.has_stw) stw.publish(s.stw_kn, s.time_us);
+  if (s.has_heading) heading.publish(s.heading_deg, s.time_us);
+  if (s.has_ground) {
+    cog.publish(s.cog_deg, s.time_us);
+    sog.publish(s.sog_kn, s.time_us);
+  }
+}
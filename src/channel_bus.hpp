@@ -0,0 +1,173 @@
+#pragma once
+
+#include "wind_sample.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+
+// Registry of named instrument values ("environment.wind.angleApparent"),
+// each a lock-free latest-value slot with a timestamp. Producers on any
+// thread publish without waiting; any number of displays read the newest
+// value, so one producer fans out to many gauges at constant cost.
+//
+// Channels are created at setup time and never removed; references to
+// them stay valid for the bus's lifetime. Only creation and lookup by name
+// take a lock; publishing and reading never do.
+class ChannelBus {
+public:
+  struct Reading {
+    double value = 0.0;
+    std::int64_t time_us = 0;    // sample clock of the producer (steady, microseconds)
+    std::uint64_t sequence = 0;  // grows with every publish; 0 = never written
+    bool valid = false;          // written, and not invalidated by the producer
+    bool stale = true;           // not valid, or older than the channel's max age
+  };
+
+  class Channel {
+  public:
+    Channel(ChannelBus& bus, std::string name) : bus_(&bus), name_(std::move(name)) {}
+
+    Channel(const Channel&) = delete;
+    Channel& operator=(const Channel&) = delete;
+
+    const std::string& name() const { return name_; }
+
+    // Any thread. If two threads publish to one channel at the same
+    // moment, one of the two values is kept and neither waits.
+    void publish(double value, std::int64_t time_us);
+    // The producer has no value (e.g. sensor reports "not available").
+    void invalidate(std::int64_t time_us);
+
+    // Any thread. `now_us` decides staleness.
+    Reading read(std::int64_t now_us) const;
+    // Cheap change check: differs from the last read's sequence once a new value is in.
+    std::uint64_t sequence() const { return seq_.load(std::memory_order_acquire); }
+
+    // A value older than this reads as stale; 0 means values never age.
+    void set_max_age_us(std::int64_t us) { max_age_us_.store(us, std::memory_order_relaxed); }
+    std::int64_t max_age_us() const { return max_age_us_.load(std::memory_order_relaxed); }
+
+  private:
+    void store_(std::uint64_t value_bits, std::int64_t time_us);
+
+    ChannelBus* bus_;
+    const std::string name_;
+    // Seqlock: odd while a writer is storing value/time. Writers claim it
+    // with a CAS instead of assuming they are alone.
+    std::atomic<std::uint64_t> seq_{0};
+    std::atomic<std::uint64_t> value_bits_{0};
+    std::atomic<std::int64_t> time_us_{0};
+    std::atomic<std::int64_t> max_age_us_{3'000'000};
+  };
+
+  ChannelBus() = default;
+
+  ChannelBus(const ChannelBus&) = delete;
+  ChannelBus& operator=(const ChannelBus&) = delete;
+
+  // Finds or creates the channel; the reference stays valid.
+  Channel& channel(std::string_view name);
+  // Null if no channel of that name exists.
+  Channel* find(std::string_view name);
+  std::size_t size() const;
+
+  // Change notification for displays that sleep while nothing changes.
+  // `fn` runs on the publishing thread after a publish, at most once until
+  // the listener calls rearm(): typically it emits a Glib::Dispatcher, and
+  // the UI re-arms when it starts reading. Returns -1 once all slots are
+  // taken. remove_listener() must not race with a notification in flight.
+  int add_listener(std::function<void()> fn);
+  void rearm(int id);
+  void remove_listener(int id);
+
+  static constexpr std::size_t kMaxListeners = 16;
+
+private:
+
+  struct Listener {
+    std::function<void()> fn;
+    std::atomic<bool> active{false};
+    std::atomic<bool> armed{false};
+  };
+
+  void notify_();
+
+  mutable std::mutex mutex_;  // channel creation and lookup, listener slots
+  std::deque<Channel> channels_;  // deque: stable addresses
+  std::unordered_map<std::string_view, Channel*> by_name_;  // keys view Channel::name()
+
+  std::array<Listener, kMaxListeners> listeners_;
+  std::atomic<std::size_t> listener_end_{0};  // one past the highest slot ever used
+};
+
+// One display's view of a channel: reports a value only when there is
+// something new to show, and at most `max_rate_hz` times per second.
+// Owned and polled by a single (usually the UI) thread.
+class ChannelSubscription {
+public:
+  ChannelSubscription(const ChannelBus::Channel& channel, double max_rate_hz = 0.0);
+
+  const ChannelBus::Channel& channel() const { return *channel_; }
+
+  // 0 = every new value.
+  void set_max_rate_hz(double hz);
+
+  // True with `out` filled when a new value arrived (and the rate limit
+  // allows it) or the value just went stale. With nothing new this is one
+  // atomic load and a compare.
+  bool poll(std::int64_t now_us, ChannelBus::Reading& out);
+
+  // A new value is being held back by the rate limit; poll again later.
+  bool pending() const { return pending_; }
+  // When the value shown last will go stale, or -1 if it can't (already
+  // stale, never written, or values never age).
+  std::int64_t stale_at_us() const;
+
+private:
+  const ChannelBus::Channel* channel_;
+  std::int64_t min_interval_us_ = 0;
+
+  std::uint64_t last_seq_ = 0;
+  std::int64_t last_delivered_us_ = 0;
+  std::int64_t last_time_us_ = 0;   // producer time of the value shown
+  bool last_valid_ = false;
+  bool last_stale_ = true;
+  bool delivered_ = false;
+  bool pending_ = false;
+};
+
+// Well-known channel names: Signal K paths, in WindSample's units.
+namespace channels {
+inline constexpr std::string_view kWindAngleApparent = "environment.wind.angleApparent";   // deg, -180..180
+inline constexpr std::string_view kWindSpeedApparent = "environment.wind.speedApparent";   // kn
+inline constexpr std::string_view kSpeedThroughWater = "navigation.speedThroughWater";      // kn
+inline constexpr std::string_view kHeadingTrue       = "navigation.headingTrue";            // deg, 0..360
+inline constexpr std::string_view kCourseOverGround  = "navigation.courseOverGroundTrue";   // deg, 0..360
+inline constexpr std::string_view kSpeedOverGround   = "navigation.speedOverGround";        // kn
+} // namespace channels
+
+// The wind and boat-motion channels, resolved once so producers publish
+// without name lookups.
+struct WindChannels {
+  explicit WindChannels(ChannelBus& bus);
+
+  // Publishes each field the sample carries, stamped with its time_us.
+  // Any thread.
+  void publish(const WindSample& s);
+
+  ChannelBus::Channel& awa;
+  ChannelBus::Channel& aws;
+  ChannelBus::Channel& stw;
+  ChannelBus::Channel& heading;
+  ChannelBus::Channel& cog;
+  ChannelBus::Channel& sog;
+};
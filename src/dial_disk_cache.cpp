@@ -0,0 +1,295 @@
+#include "dial_disk_cache.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <system_error>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// Bump when dial rendering changes what it draws for the same key.
+constexpr std::uint32_t kRenderVersion = 2;
+
+constexpr char kMagic[8] = {'G', 'D', 'I', 'A', 'L', '\0', '\0', '\1'};
+constexpr std::uint32_t kByteOrder = 0x01020304;  // reads back swapped on the wrong endianness
+
+struct FileHeader {
+  char magic[8];
+  std::uint32_t byte_order;
+  std::uint32_t render_version;
+  std::int32_t format;  // Cairo::Surface::Format
+  std::int32_t width;   // device pixels
+  std::int32_t height;
+  std::int32_t stride;
+  std::int32_t scale;
+  std::uint32_t key_size;
+  std::uint64_t pixels_offset;  // page-aligned, so the pixels can be mapped on their own
+  std::uint64_t pixels_size;
+};
+
+// Stable across runs and builds, unlike std::hash.
+std::uint64_t fnv1a(const std::string& bytes) {
+  std::uint64_t h = 0xcbf29ce484222325ull;
+  for (const unsigned char c : bytes) {
+    h ^= c;
+    h *= 0x100000001b3ull;
+  }
+  return h;
+}
+
+class KeyWriter {
+public:
+  template <class T>
+  void pod(const T& v) {
+    out.append(reinterpret_cast<const char*>(&v), sizeof(v));
+  }
+  void str(const std::string& s) {
+    pod(static_cast<std::uint32_t>(s.size()));
+    out.append(s);
+  }
+  void color(const Gdk::RGBA& c) {
+    for (const double v : {c.get_red(), c.get_green(), c.get_blue(), c.get_alpha()}) pod(v);
+  }
+
+  std::string out;
+};
+
+struct Mapping {
+  void* addr;
+  std::size_t size;
+};
+
+const cairo_user_data_key_t kMappingKey{};
+
+void unmap(void* p) {
+  auto* m = static_cast<Mapping*>(p);
+  ::munmap(m->addr, m->size);
+  delete m;
+}
+
+bool write_all(int fd, const void* data, std::size_t size) {
+  const auto* p = static_cast<const char*>(data);
+  while (size > 0) {
+    const ssize_t n = ::write(fd, p, size);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      return false;
+    }
+    p += n;
+    size -= static_cast<std::size_t>(n);
+  }
+  return true;
+}
+
+} // namespace
+
+std::string DialDiskCache::default_directory() {
+  const char* xdg = std::getenv("XDG_CACHE_HOME");
+  if (xdg && *xdg == '/') return std::string(xdg) + "/gtk-gauges/dials";
+  const char* home = std::getenv("HOME");
+  return std::string(home ? home : ".") + "/.cache/gtk-gauges/dials";
+}
+
+bool DialDiskCache::open(const std::string& directory, std::size_t budget_bytes, std::string* error) {
+  std::error_code ec;
+  std::filesystem::create_directories(directory, ec);
+  if (ec) {
+    if (error) *error = directory + ": " + ec.message();
+    return false;
+  }
+  dir_ = directory;
+  prune_(budget_bytes);
+  return true;
+}
+
+std::string DialDiskCache::serialize_key(const DialKey& key) {
+  KeyWriter w;
+  w.pod(kRenderVersion);
+  w.str(key.face_type.name());
+
+  const GaugeFace::Style& s = *key.style;
+  for (const double v : {s.start_deg, s.end_deg, s.value_precision, s.ring_width_frac,
+                         s.tick_len_major_frac, s.tick_len_minor_frac, s.label_radius_frac,
+                         s.value_radius_frac, s.zone_width_mul, s.zone_radius_mul}) {
+    w.pod(v);
+  }
+  w.pod(s.major_ticks);
+  w.pod(s.minor_ticks);
+  for (const auto* c : {&s.bg, &s.ring, &s.face, &s.tick, &s.text, &s.subtext, &s.needle, &s.hub}) w.color(*c);
+  w.str(s.font_family);
+
+  w.pod(key.min_v);
+  w.pod(key.max_v);
+  w.pod(static_cast<std::uint32_t>(key.zones.size()));
+  for (const auto& z : key.zones) {
+    w.pod(z.from_value);
+    w.pod(z.to_value);
+    w.color(z.color);
+    w.pod(z.alpha);
+  }
+  if (key.zone_ramp) {
+    const auto& r = *key.zone_ramp;
+    w.pod(r.alpha);
+    w.pod(static_cast<std::uint32_t>(r.buckets.size()));
+    for (const auto& c : r.buckets) w.color(c);
+    w.pod(static_cast<std::uint32_t>(r.stops.size()));
+    for (const auto& st : r.stops) {
+      w.pod(st.value);
+      w.color(st.color);
+    }
+  } else {
+    w.pod(std::uint32_t{0xffffffffu});  // no ramp, distinct from an empty one
+  }
+  w.pod(static_cast<std::uint32_t>(key.labels.size()));
+  for (const auto& l : key.labels) w.str(l);
+  w.str(key.title);
+  w.str(key.unit);
+  w.pod(key.width);
+  w.pod(key.height);
+  w.pod(key.scale);
+  return std::move(w.out);
+}
+
+std::string DialDiskCache::path_for_(const std::string& serialized) const {
+  char name[32];
+  std::snprintf(name, sizeof(name), "%016llx.dial", static_cast<unsigned long long>(fnv1a(serialized)));
+  return dir_ + "/" + name;
+}
+
+DialDiskCache::Stats DialDiskCache::stats() const {
+  return {hits_.load(), misses_.load(), writes_.load(), errors_.load()};
+}
+
+Cairo::RefPtr<Cairo::ImageSurface> DialDiskCache::load(const DialKey& key) {
+  if (!is_open()) return {};
+  const std::string serialized = serialize_key(key);
+  const std::string path = path_for_(serialized);
+
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    ++misses_;
+    return {};
+  }
+
+  auto fail = [&] {
+    ::close(fd);
+    ++errors_;
+    ++misses_;
+    return Cairo::RefPtr<Cairo::ImageSurface>{};
+  };
+
+  FileHeader h{};
+  struct stat st{};
+  if (::pread(fd, &h, sizeof(h), 0) != static_cast<ssize_t>(sizeof(h)) || ::fstat(fd, &st) != 0) return fail();
+  const auto format = static_cast<Cairo::Surface::Format>(h.format);
+  if (std::memcmp(h.magic, kMagic, sizeof(kMagic)) != 0 || h.byte_order != kByteOrder ||
+      h.render_version != kRenderVersion || h.key_size != serialized.size() ||
+      h.width <= 0 || h.height <= 0 ||
+      h.stride != Cairo::ImageSurface::format_stride_for_width(format, h.width) ||
+      h.pixels_size != static_cast<std::uint64_t>(h.stride) * h.height ||
+      h.pixels_offset % static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE)) != 0 ||
+      h.pixels_offset + h.pixels_size > static_cast<std::uint64_t>(st.st_size)) {
+    return fail();
+  }
+
+  std::string stored(serialized.size(), '\0');
+  if (::pread(fd, stored.data(), stored.size(), sizeof(h)) != static_cast<ssize_t>(stored.size()) ||
+      stored != serialized) {
+    return fail();
+  }
+
+  // Private and writable: cairo may treat the data as its own, and a
+  // write would only ever touch this process's copy.
+  void* addr = ::mmap(nullptr, h.pixels_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd,
+                      static_cast<off_t>(h.pixels_offset));
+  if (addr == MAP_FAILED) return fail();
+  ::close(fd);
+
+  auto surface = Cairo::ImageSurface::create(static_cast<unsigned char*>(addr), format,
+                                             h.width, h.height, h.stride);
+  cairo_surface_set_user_data(surface->cobj(), &kMappingKey, new Mapping{addr, h.pixels_size}, unmap);
+  surface->set_device_scale(h.scale, h.scale);
+
+  // Recently used dials survive pruning.
+  ::utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+  ++hits_;
+  return surface;
+}
+
+void DialDiskCache::store(const DialKey& key, const Cairo::RefPtr<Cairo::ImageSurface>& surface) {
+  if (!is_open() || !surface) return;
+  const std::string serialized = serialize_key(key);
+  const std::string path = path_for_(serialized);
+  const std::string tmp = path + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(next_tmp_++);
+
+  surface->flush();
+  const auto page = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+  FileHeader h{};
+  std::memcpy(h.magic, kMagic, sizeof(kMagic));
+  h.byte_order = kByteOrder;
+  h.render_version = kRenderVersion;
+  h.format = static_cast<std::int32_t>(surface->get_format());
+  h.width = surface->get_width();
+  h.height = surface->get_height();
+  h.stride = surface->get_stride();
+  h.scale = key.scale;
+  h.key_size = static_cast<std::uint32_t>(serialized.size());
+  h.pixels_offset = (sizeof(h) + serialized.size() + page - 1) / page * page;
+  h.pixels_size = static_cast<std::uint64_t>(h.stride) * h.height;
+
+  const int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+  if (fd < 0) {
+    ++errors_;
+    return;
+  }
+  const std::vector<char> pad(h.pixels_offset - sizeof(h) - serialized.size(), '\0');
+  const bool ok = write_all(fd, &h, sizeof(h)) && write_all(fd, serialized.data(), serialized.size()) &&
+                  write_all(fd, pad.data(), pad.size()) &&
+                  write_all(fd, surface->get_data(), h.pixels_size);
+  if (::close(fd) != 0 || !ok || ::rename(tmp.c_str(), path.c_str()) != 0) {
+    ::unlink(tmp.c_str());
+    ++errors_;
+    return;
+  }
+  ++writes_;
+}
+
+void DialDiskCache::prune_(std::size_t budget_bytes) {
+  struct File {
+    std::filesystem::path path;
+    std::filesystem::file_time_type time;
+    std::uintmax_t size;
+  };
+  std::vector<File> files;
+  std::uintmax_t total = 0;
+  std::error_code ec;
+  for (const auto& e : std::filesystem::directory_iterator(dir_, ec)) {
+    if (!e.is_regular_file(ec)) continue;
+    const auto& p = e.path();
+    if (p.extension() != ".dial") {
+      // Leftovers of a writer that died mid-store.
+      if (p.filename().string().find(".dial.tmp.") != std::string::npos) std::filesystem::remove(p, ec);
+      continue;
+    }
+    File f{p, e.last_write_time(ec), e.file_size(ec)};
+    if (ec) continue;
+    total += f.size;
+    files.push_back(std::move(f));
+  }
+  if (total <= budget_bytes) return;
+
+  std::sort(files.begin(), files.end(), [](const File& a, const File& b) { return a.time < b.time; });
+  for (const auto& f : files) {
+    if (total <= budget_bytes) break;
+    if (std::filesystem::remove(f.path, ec)) total -= f.size;
+  }
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "dial_surface_cache.hpp"
+
+#include <cairomm/surface.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Rendered dial rasters persisted across runs, so a cold start maps its
+// dials from disk instead of rendering them (POSIX mmap).
+//
+// One file per dial, named by a 64-bit hash of a stable serialization of
+// its DialKey (face type, style, range, zones, zone ramp, labels, title,
+// unit, size, scale). The file holds the full serialization, too, so a hash collision
+// is a miss rather than a wrong dial. A loaded surface reads its pixels
+// straight from the mapping; nothing is copied.
+//
+// Files are written once, to a temporary name and renamed into place, so
+// a crash or a second instance never leaves a half-written dial behind.
+//
+// load() and store() may run on several threads at once (raster workers
+// missing a shared DialSurfaceCache); open() must come first.
+class DialDiskCache {
+public:
+  struct Stats {
+    std::uint64_t hits = 0;
+    std::uint64_t misses = 0;
+    std::uint64_t writes = 0;
+    std::uint64_t errors = 0;  // unreadable, mismatched or unwritable files
+  };
+
+  // $XDG_CACHE_HOME/gtk-gauges/dials, or ~/.cache/gtk-gauges/dials.
+  static std::string default_directory();
+
+  DialDiskCache() = default;
+
+  // Creates `directory` if needed and deletes the least recently used
+  // files beyond `budget_bytes`.
+  bool open(const std::string& directory, std::size_t budget_bytes = 32u << 20, std::string* error = nullptr);
+  bool is_open() const { return !dir_.empty(); }
+  const std::string& directory() const { return dir_; }
+
+  // The persisted raster for `key`, or null.
+  Cairo::RefPtr<Cairo::ImageSurface> load(const DialKey& key);
+  // Best effort: failures are only counted.
+  void store(const DialKey& key, const Cairo::RefPtr<Cairo::ImageSurface>& surface);
+
+  Stats stats() const;
+
+  // Everything a dial raster depends on, as bytes that are the same across
+  // runs (unlike DialKeyHash, which may differ between processes).
+  static std::string serialize_key(const DialKey& key);
+
+private:
+  std::string path_for_(const std::string& serialized) const;
+  void prune_(std::size_t budget_bytes);
+
+  std::string dir_;
+  std::atomic<std::uint64_t> hits_{0};
+  std::atomic<std::uint64_t> misses_{0};
+  std::atomic<std::uint64_t> writes_{0};
+  std::atomic<std::uint64_t> errors_{0};
+  std::atomic<std::uint64_t> next_tmp_{0};  // temporary file names, unique per store()
+};
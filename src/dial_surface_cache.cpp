@@ -0,0 +1,141 @@
+#include "dial_surface_cache.hpp"
+#include "startup_trace.hpp"
+#include "style_interner.hpp"
+
+#if GAUGES_HAVE_DIAL_DISK_CACHE
+#include "dial_disk_cache.hpp"
+#endif
+
+#include <algorithm>
+#include <utility>
+
+bool DialKey::operator==(const DialKey& o) const {
+  return face_type == o.face_type &&
+         (style == o.style || *style == *o.style) &&
+         min_v == o.min_v && max_v == o.max_v &&
+         width == o.width && height == o.height && scale == o.scale &&
+         title == o.title && unit == o.unit &&
+         zones == o.zones && labels == o.labels &&
+         (zone_ramp == o.zone_ramp || (zone_ramp && o.zone_ramp && *zone_ramp == *o.zone_ramp));
+}
+
+std::size_t DialKeyHash::operator()(const DialKey& k) const {
+  std::size_t seed = k.face_type.hash_code();
+  hash_combine(seed, hash_value(*k.style));
+  hash_combine(seed, std::hash<double>{}(k.min_v));
+  hash_combine(seed, std::hash<double>{}(k.max_v));
+  for (const auto& z : k.zones) hash_combine(seed, hash_value(z));
+  if (k.zone_ramp) hash_combine(seed, hash_value(*k.zone_ramp));
+  for (const auto& l : k.labels) hash_combine(seed, std::hash<std::string>{}(l));
+  hash_combine(seed, std::hash<std::string>{}(k.title));
+  hash_combine(seed, std::hash<std::string>{}(k.unit));
+  hash_combine(seed, std::hash<int>{}(k.width));
+  hash_combine(seed, std::hash<int>{}(k.height));
+  hash_combine(seed, std::hash<int>{}(k.scale));
+  return seed;
+}
+
+DialSurfaceCache::DialSurfaceCache(std::size_t budget_bytes)
+: budget_bytes_(budget_bytes) {}
+
+void DialSurfaceCache::set_disk_cache(std::shared_ptr<DialDiskCache> disk) {
+  std::lock_guard lock(mutex_);
+  disk_ = std::move(disk);
+}
+
+std::shared_ptr<DialDiskCache> DialSurfaceCache::disk_cache() const {
+  std::lock_guard lock(mutex_);
+  return disk_;
+}
+
+DialSurfaceCache::Stats DialSurfaceCache::stats() const {
+  std::lock_guard lock(mutex_);
+  return stats_;
+}
+
+Cairo::RefPtr<Cairo::ImageSurface> DialSurfaceCache::find_or_render(DialKey key, const Render& render) {
+  std::promise<Cairo::RefPtr<Cairo::ImageSurface>> done;
+  std::shared_ptr<DialDiskCache> disk;
+  {
+    std::unique_lock lock(mutex_);
+    ++clock_;
+    if (auto it = entries_.find(key); it != entries_.end()) {
+      ++stats_.hits;
+      it->second.last_use = clock_;
+      return it->second.surface;
+    }
+    if (auto it = rendering_.find(key); it != rendering_.end()) {
+      ++stats_.hits;
+      auto pending = it->second;
+      lock.unlock();
+      return pending.get();
+    }
+    ++stats_.misses;
+    rendering_.emplace(key, done.get_future().share());
+    disk = disk_;
+  }
+
+  Cairo::RefPtr<Cairo::ImageSurface> surface;
+  try {
+#if GAUGES_HAVE_DIAL_DISK_CACHE
+    if (disk) {
+      const std::int64_t t0 = startup_trace::enabled() ? startup_trace::now_us() : 0;
+      surface = disk->load(key);
+      if (surface) {
+        startup_trace::first("first dial from disk", t0);
+      } else {
+        surface = render();
+        disk->store(key, surface);
+      }
+    }
+#endif
+    if (!surface) surface = render();
+  } catch (...) {
+    // Waiters get the exception; the next caller renders again.
+    {
+      std::lock_guard lock(mutex_);
+      rendering_.erase(key);
+    }
+    done.set_exception(std::current_exception());
+    throw;
+  }
+
+  {
+    std::lock_guard lock(mutex_);
+    Entry e;
+    e.surface  = surface;
+    e.bytes    = static_cast<std::size_t>(surface->get_stride()) * surface->get_height();
+    e.last_use = clock_;
+
+    if (stats_.bytes + e.bytes > budget_bytes_) evict_(budget_bytes_ - std::min(budget_bytes_, e.bytes));
+
+    stats_.bytes += e.bytes;
+    rendering_.erase(key);
+    entries_.emplace(std::move(key), std::move(e));
+    stats_.entries = entries_.size();
+  }
+  done.set_value(surface);
+  return surface;
+}
+
+void DialSurfaceCache::trim() {
+  std::lock_guard lock(mutex_);
+  evict_(0);
+}
+
+void DialSurfaceCache::evict_(std::size_t target_bytes) {
+  // Only entries held by the cache alone are candidates; oldest first.
+  std::vector<decltype(entries_)::iterator> idle;
+  for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+    if (it->second.surface.use_count() == 1) idle.push_back(it);
+  }
+  std::sort(idle.begin(), idle.end(),
+            [](const auto& a, const auto& b) { return a->second.last_use < b->second.last_use; });
+
+  for (auto it : idle) {
+    if (stats_.bytes <= target_bytes) break;
+    stats_.bytes -= it->second.bytes;
+    entries_.erase(it);
+  }
+  stats_.entries = entries_.size();
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "gauge_face.hpp"
+
+#include <cairomm/surface.h>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
+
+// Everything a dial raster depends on. Built by GaugeFace when its dial is
+// stale; interned styles make the style comparison a pointer check.
+struct DialKey {
+  std::type_index face_type;  // hooks (angle mapping, labels) are per type
+  GaugeFace::SharedStyle style;
+  double min_v = 0.0;
+  double max_v = 0.0;
+  std::vector<GaugeFace::Zone> zones;
+  GaugeFace::SharedZoneRamp zone_ramp;  // null when none
+  std::vector<std::string> labels;
+  std::string title;
+  std::string unit;
+  int width  = 0;
+  int height = 0;
+  int scale  = 1;
+
+  bool operator==(const DialKey& o) const;
+};
+
+struct DialKeyHash {
+  std::size_t operator()(const DialKey& k) const;
+};
+
+class DialDiskCache;
+
+// Dial rasters shared between faces with identical dials (e.g. a dashboard
+// of tank gauges differing only in value). Faces hold a reference to the
+// surface they draw; entries nobody references are evicted LRU once the
+// cache grows past its byte budget.
+//
+// With a disk cache set, a miss maps the raster from disk before rendering
+// it, and a rendered raster is persisted for the next run.
+//
+// Thread-safe, so raster workers (see RasterPool) can share it with the UI
+// thread. A miss renders (or loads from disk) outside the cache's lock, so
+// different dials render in parallel; callers after a dial that is being
+// rendered wait for it instead of rendering it again.
+class DialSurfaceCache {
+public:
+  using Render = std::function<Cairo::RefPtr<Cairo::ImageSurface>()>;
+
+  struct Stats {
+    std::size_t entries = 0;
+    std::size_t bytes   = 0;  // raster memory held by the cache
+    std::uint64_t hits   = 0;
+    std::uint64_t misses = 0;
+  };
+
+  explicit DialSurfaceCache(std::size_t budget_bytes = 64u << 20);
+
+  // Returns the cached raster for `key`, or calls `render` and caches it.
+  Cairo::RefPtr<Cairo::ImageSurface> find_or_render(DialKey key, const Render& render);
+
+  // Drops every entry not currently referenced by a face.
+  void trim();
+
+  // Null disables it. Without POSIX support the disk cache is never consulted.
+  void set_disk_cache(std::shared_ptr<DialDiskCache> disk);
+  std::shared_ptr<DialDiskCache> disk_cache() const;
+
+  Stats stats() const;
+
+private:
+  struct Entry {
+    Cairo::RefPtr<Cairo::ImageSurface> surface;
+    std::size_t bytes = 0;
+    std::uint64_t last_use = 0;
+  };
+
+  void evict_(std::size_t target_bytes);
+
+  mutable std::mutex mutex_;
+  std::unordered_map<DialKey, Entry, DialKeyHash> entries_;
+  // Misses being rendered, for callers after the same dial meanwhile.
+  std::unordered_map<DialKey, std::shared_future<Cairo::RefPtr<Cairo::ImageSurface>>, DialKeyHash> rendering_;
+  std::size_t budget_bytes_;
+  std::shared_ptr<DialDiskCache> disk_;
+  std::uint64_t clock_ = 0;
+  Stats stats_;
+};
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+
+// Fixed-capacity text for strings rebuilt every frame: gauge readouts and
+// the panel's summary line. Numbers are formatted with std::to_chars into
+// the inline buffer, so building one never allocates. Text past the
+// capacity is dropped at a UTF-8 character boundary. The buffer stays
+// NUL-terminated for C APIs.
+template <std::size_t N>
+class FixedText {
+public:
+  static constexpr std::size_t capacity() { return N; }
+
+  std::string_view view() const { return {buf_.data(), size_}; }
+  const char* c_str() const { return buf_.data(); }
+  std::size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  void clear() {
+    size_ = 0;
+    buf_[0] = '\0';
+  }
+
+  FixedText& assign(std::string_view s) {
+    clear();
+    return append(s);
+  }
+
+  FixedText& append(std::string_view s) {
+    std::size_t n = std::min(s.size(), N - size_);
+    if (n < s.size()) {
+      while (n > 0 && (static_cast<unsigned char>(s[n]) & 0xC0) == 0x80) --n;
+    }
+    std::copy_n(s.data(), n, buf_.data() + size_);
+    size_ += n;
+    buf_[size_] = '\0';
+    return *this;
+  }
+
+  FixedText& append_int(long long v) {
+    const auto r = std::to_chars(buf_.data() + size_, buf_.data() + N, v);
+    if (r.ec == std::errc{}) size_ = static_cast<std::size_t>(r.ptr - buf_.data());
+    buf_[size_] = '\0';
+    return *this;
+  }
+
+  // Like printf("%.*f"). Values too wide for the buffer fall back to
+  // scientific notation.
+  FixedText& append_fixed(double v, int precision) {
+    char* const first = buf_.data() + size_;
+    char* const last = buf_.data() + N;
+    auto r = std::to_chars(first, last, v, std::chars_format::fixed, precision);
+    if (r.ec != std::errc{}) r = std::to_chars(first, last, v, std::chars_format::general, 6);
+    if (r.ec == std::errc{}) size_ = static_cast<std::size_t>(r.ptr - buf_.data());
+    buf_[size_] = '\0';
+    return *this;
+  }
+
+  friend bool operator==(const FixedText& a, const FixedText& b) { return a.view() == b.view(); }
+  friend bool operator==(const FixedText& a, std::string_view b) { return a.view() == b; }
+
+private:
+  std::array<char, N + 1> buf_{};
+  std::size_t size_ = 0;
+};
@@ -0,0 +1,166 @@
+#include "frame_output.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+bool FrameRingOutput::open(const std::string& shm_name, int width, int height, int scale, int slots,
+                           std::string* error) {
+  close();
+  width_ = std::max(1, width);
+  height_ = std::max(1, height);
+  scale_ = std::max(1, scale);
+  return ring_.create(shm_name, width_ * scale_, height_ * scale_, slots, error);
+}
+
+void FrameRingOutput::close() {
+  // Surfaces point into the mapping; drop them first.
+  contexts_.fill({});
+  surfaces_.fill({});
+  ring_.close();
+  for (auto& g : gauges_) g.drawn = false;
+  full_ = true;
+}
+
+void FrameRingOutput::set_background(const Gdk::RGBA& color) {
+  if (color == background_) return;
+  background_ = color;
+  full_ = true;
+}
+
+void FrameRingOutput::add_gauge(const GaugeFace& source, std::unique_ptr<GaugeFace> mirror,
+                                int x, int y, int w, int h, SyncHook sync) {
+  Gauge g;
+  g.source = &source;
+  g.face = std::move(mirror);
+  g.x = x;
+  g.y = y;
+  g.w = std::max(1, w);
+  g.h = std::max(1, h);
+  g.sync = std::move(sync);
+  gauges_.push_back(std::move(g));
+  full_ = true;
+}
+
+void FrameRingOutput::sync_(Gauge& g) {
+  g.source->mirror_to(*g.face);
+  if (g.sync) g.sync(*g.source, *g.face);
+}
+
+void FrameRingOutput::add_damage_(const Gauge& g, const GaugeFace::Box& box) {
+  if (box.empty()) return;
+  // To device pixels, clipped to the gauge's rectangle.
+  const int x0 = static_cast<int>(std::floor((g.x + std::max(0.0, box.x0)) * scale_));
+  const int y0 = static_cast<int>(std::floor((g.y + std::max(0.0, box.y0)) * scale_));
+  const int x1 = static_cast<int>(std::ceil((g.x + std::min<double>(g.w, box.x1)) * scale_));
+  const int y1 = static_cast<int>(std::ceil((g.y + std::min<double>(g.h, box.y1)) * scale_));
+  if (x1 <= x0 || y1 <= y0) return;
+
+  // Overlapping boxes (e.g. old and new needle around the hub) become one.
+  for (auto& d : damage_) {
+    if (x0 < d.x + d.w && d.x < x1 && y0 < d.y + d.h && d.y < y1) {
+      const int ux0 = std::min(d.x, x0), uy0 = std::min(d.y, y0);
+      const int ux1 = std::max(d.x + d.w, x1), uy1 = std::max(d.y + d.h, y1);
+      d = {ux0, uy0, ux1 - ux0, uy1 - uy0};
+      return;
+    }
+  }
+  damage_.push_back({x0, y0, x1 - x0, y1 - y0});
+}
+
+void FrameRingOutput::collect_damage_(Gauge& g) {
+  const GaugeFace& f = *g.face;
+  const double angle = f.needle_angle_rad();
+  const GaugeFace::Text readout = f.readout_text();
+
+  if (!g.drawn || f.dial_dirty() || f.style_generation() != g.style_generation) {
+    add_damage_(g, {0.0, 0.0, static_cast<double>(g.w), static_cast<double>(g.h)});
+  } else {
+    if (f.stale() != g.stale) {
+      add_damage_(g, f.needle_bounds(g.w, g.h, angle));  // dimmed or undimmed in place
+    }
+    if (angle != g.needle_angle) {
+      add_damage_(g, f.needle_bounds(g.w, g.h, g.needle_angle));
+      add_damage_(g, f.needle_bounds(g.w, g.h, angle));
+    }
+    if (readout != g.readout) {
+      add_damage_(g, g.readout_box);
+      add_damage_(g, f.readout_bounds(g.w, g.h));
+    }
+    const auto& marks = f.marks();
+    const std::size_t n = std::max(marks.size(), g.marks.size());
+    for (std::size_t i = 0; i < n; ++i) {
+      const bool had = i < g.marks.size();
+      const bool has = i < marks.size();
+      if (had && has && g.marks[i] == marks[i]) continue;
+      if (had) add_damage_(g, f.mark_bounds(g.w, g.h, g.marks[i]));
+      if (has) add_damage_(g, f.mark_bounds(g.w, g.h, marks[i]));
+    }
+  }
+
+  g.drawn = true;
+  g.style_generation = f.style_generation();
+  g.needle_angle = angle;
+  g.stale = f.stale();
+  if (readout != g.readout) {
+    g.readout = readout;
+    g.readout_box = f.readout_bounds(g.w, g.h);
+  }
+  if (g.marks != f.marks()) g.marks = f.marks();
+}
+
+bool FrameRingOutput::publish(std::int64_t time_us) {
+  if (!ring_.is_open()) return false;
+
+  damage_.clear();
+  for (auto& g : gauges_) {
+    sync_(g);
+    collect_damage_(g);
+  }
+  if (!full_ && damage_.empty()) return false;
+  if (full_) {
+    damage_.assign(1, {0, 0, ring_.width(), ring_.height()});
+  }
+
+  const int slot = ring_.next_slot();
+  unsigned char* pixels = ring_.begin_frame();
+  if (!surfaces_[slot]) {
+    surfaces_[slot] = Cairo::ImageSurface::create(pixels, Cairo::Surface::Format::ARGB32,
+                                                  ring_.width(), ring_.height(), ring_.stride());
+    surfaces_[slot]->set_device_scale(scale_, scale_);
+    contexts_[slot] = Cairo::Context::create(surfaces_[slot]);
+  }
+  const auto& cr = contexts_[slot];
+
+  // Everything below only rasterizes inside the damage.
+  cr->save();
+  const double inv = 1.0 / scale_;
+  for (const auto& d : damage_) cr->rectangle(d.x * inv, d.y * inv, d.w * inv, d.h * inv);
+  cr->clip();
+
+  cr->set_operator(Cairo::Context::Operator::SOURCE);
+  cr->set_source_rgba(background_.get_red(), background_.get_green(), background_.get_blue(),
+                      background_.get_alpha());
+  cr->paint();
+  cr->set_operator(Cairo::Context::Operator::OVER);
+
+  for (auto& g : gauges_) {
+    const bool damaged = std::any_of(damage_.begin(), damage_.end(), [&](const frame_ring::Rect& d) {
+      return d.x < (g.x + g.w) * scale_ && g.x * scale_ < d.x + d.w &&
+             d.y < (g.y + g.h) * scale_ && g.y * scale_ < d.y + d.h;
+    });
+    if (!damaged) continue;
+    cr->save();
+    cr->translate(g.x, g.y);
+    g.face->draw(cr, g.w, g.h, scale_);
+    cr->restore();
+  }
+  cr->restore();
+  surfaces_[slot]->flush();
+
+  ring_.publish(damage_, time_us, full_);
+  full_ = false;
+
+  ++frames_;
+  for (const auto& d : damage_) damaged_px_ += static_cast<double>(d.w) * d.h;
+  return true;
+}
@@ -0,0 +1,101 @@
+#pragma once
+
+#include "frame_ring.hpp"
+#include "gauge_face.hpp"
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Renders a set of gauges into a shared-memory FrameRingWriter, repainting
+// only what changed: the needle's old and new position, the readout when
+// its text changes, and marks that moved. A full frame is drawn only for
+// the first frame, a re-rendered dial, or a background change.
+//
+// Each gauge is drawn through a mirror face owned by the output, so its
+// dial cache and shaped text stay at the output size while the on-screen
+// widget resizes freely. publish() copies the source face's state first.
+//
+// Runs on the thread that owns the source faces (the GTK main loop).
+class FrameRingOutput {
+public:
+  // Copies state GaugeFace::mirror_to() does not know about.
+  using SyncHook = std::function<void(const GaugeFace& source, GaugeFace& mirror)>;
+
+  FrameRingOutput() = default;
+
+  FrameRingOutput(const FrameRingOutput&) = delete;
+  FrameRingOutput& operator=(const FrameRingOutput&) = delete;
+
+  // Logical size; the ring holds width*scale x height*scale device pixels.
+  bool open(const std::string& shm_name, int width, int height, int scale = 1, int slots = 3,
+            std::string* error = nullptr);
+  void close();
+  bool is_open() const { return ring_.is_open(); }
+
+  void set_background(const Gdk::RGBA& color);
+
+  // Shows `source` (which must outlive this output) in the logical
+  // rectangle (x, y, w, h), drawn through `mirror`: a face of the same type
+  // that nothing else draws (e.g. source.create_mirror()). Every publish()
+  // brings it up to date with GaugeFace::mirror_to(), then runs `sync` for
+  // anything that doesn't cover.
+  void add_gauge(const GaugeFace& source, std::unique_ptr<GaugeFace> mirror,
+                 int x, int y, int w, int h, SyncHook sync = {});
+
+  // Renders and publishes a frame if anything visible changed since the
+  // last one. Returns true if a frame was published.
+  bool publish(std::int64_t time_us);
+
+  const FrameRingWriter& ring() const { return ring_; }
+
+  // Average share of the frame repainted per published frame.
+  std::uint64_t frames_published() const { return frames_; }
+  double damaged_fraction() const {
+    return frames_ ? damaged_px_ / (static_cast<double>(frames_) * ring_.width() * ring_.height()) : 0.0;
+  }
+
+private:
+  struct Gauge {
+    const GaugeFace* source = nullptr;
+    std::unique_ptr<GaugeFace> face;
+    int x = 0;
+    int y = 0;
+    int w = 0;
+    int h = 0;
+    SyncHook sync;
+
+    // As last drawn.
+    bool drawn = false;
+    std::uint64_t style_generation = 0;
+    double needle_angle = 0.0;
+    bool stale = false;
+    GaugeFace::Text readout;
+    GaugeFace::Box readout_box;
+    std::vector<GaugeFace::Mark> marks;
+  };
+
+  static void sync_(Gauge& g);
+  void collect_damage_(Gauge& g);
+  void add_damage_(const Gauge& g, const GaugeFace::Box& box);
+
+  FrameRingWriter ring_;
+  int width_ = 0;
+  int height_ = 0;
+  int scale_ = 1;
+  Gdk::RGBA background_ = Gdk::RGBA("transparent");
+
+  std::vector<Gauge> gauges_;
+  std::vector<frame_ring::Rect> damage_;
+  bool full_ = true;
+
+  // Cairo views of the ring slots, created on first use.
+  std::array<Cairo::RefPtr<Cairo::ImageSurface>, frame_ring::kMaxSlots> surfaces_;
+  std::array<Cairo::RefPtr<Cairo::Context>, frame_ring::kMaxSlots> contexts_;
+
+  std::uint64_t frames_ = 0;
+  double damaged_px_ = 0.0;
+};
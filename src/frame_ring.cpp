@@ -0,0 +1,295 @@
+#include "frame_ring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using frame_ring::Rect;
+
+namespace {
+
+constexpr std::size_t round_up(std::size_t n, std::size_t to) {
+  return (n + to - 1) / to * to;
+}
+
+Rect clip(const Rect& r, int width, int height) {
+  const int x0 = std::clamp(r.x, 0, width);
+  const int y0 = std::clamp(r.y, 0, height);
+  const int x1 = std::clamp(r.x + r.w, 0, width);
+  const int y1 = std::clamp(r.y + r.h, 0, height);
+  return {x0, y0, std::max(0, x1 - x0), std::max(0, y1 - y0)};
+}
+
+Rect bounding_box(std::span<const Rect> rects) {
+  if (rects.empty()) return {};
+  int x0 = rects[0].x, y0 = rects[0].y;
+  int x1 = rects[0].x + rects[0].w, y1 = rects[0].y + rects[0].h;
+  for (const Rect& r : rects.subspan(1)) {
+    x0 = std::min(x0, r.x);
+    y0 = std::min(y0, r.y);
+    x1 = std::max(x1, r.x + r.w);
+    y1 = std::max(y1, r.y + r.h);
+  }
+  return {x0, y0, x1 - x0, y1 - y0};
+}
+
+} // namespace
+
+// ---------------- Writer ----------------
+
+FrameRingWriter::~FrameRingWriter() {
+  close();
+}
+
+void FrameRingWriter::close() {
+  if (header_) {
+    ::munmap(header_, map_size_);
+    ::shm_unlink(name_.c_str());
+  }
+  header_ = nullptr;
+  map_size_ = 0;
+  name_.clear();
+  frame_ = 0;
+  in_frame_ = false;
+  for (auto& s : stale_) s.clear();
+  stale_full_.fill(false);
+}
+
+bool FrameRingWriter::create(const std::string& name, int width, int height, int slots, std::string* error) {
+  close();
+
+  auto fail = [&](const std::string& what) {
+    if (error) *error = name + ": " + what;
+    return false;
+  };
+  if (width <= 0 || height <= 0) return fail("bad frame size");
+
+  width_ = width;
+  height_ = height;
+  stride_ = width * 4;  // what Cairo picks for ARGB32
+  slots_ = std::clamp(slots, 2, frame_ring::kMaxSlots);
+
+  const std::size_t pixels_offset = round_up(sizeof(frame_ring::Header), 4096);
+  const std::size_t slot_bytes = round_up(static_cast<std::size_t>(stride_) * height_, 4096);
+  const std::size_t size = pixels_offset + slot_bytes * static_cast<std::size_t>(slots_);
+
+  ::shm_unlink(name.c_str());
+  const int fd = ::shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0644);
+  if (fd < 0) return fail(std::strerror(errno));
+  if (::ftruncate(fd, static_cast<off_t>(size)) != 0) {
+    const int e = errno;
+    ::close(fd);
+    ::shm_unlink(name.c_str());
+    return fail(std::strerror(e));
+  }
+  void* p = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  const int e = errno;
+  ::close(fd);
+  if (p == MAP_FAILED) {
+    ::shm_unlink(name.c_str());
+    return fail(std::strerror(e));
+  }
+
+  // Fresh shared memory is zeroed: every slot is empty and transparent.
+  auto* h = new (p) frame_ring::Header();
+  h->version = frame_ring::kVersion;
+  h->width = static_cast<std::uint32_t>(width_);
+  h->height = static_cast<std::uint32_t>(height_);
+  h->stride = static_cast<std::uint32_t>(stride_);
+  h->slot_count = static_cast<std::uint32_t>(slots_);
+  h->slot_bytes = slot_bytes;
+  h->pixels_offset = pixels_offset;
+  std::atomic_thread_fence(std::memory_order_release);
+  h->magic = frame_ring::kMagic;
+
+  header_ = h;
+  map_size_ = size;
+  name_ = name;
+  return true;
+}
+
+unsigned char* FrameRingWriter::slot_pixels_(int slot) const {
+  return reinterpret_cast<unsigned char*>(header_) + header_->pixels_offset +
+         header_->slot_bytes * static_cast<std::size_t>(slot);
+}
+
+void FrameRingWriter::copy_rect_(int from, int to, const Rect& r) const {
+  const unsigned char* src = slot_pixels_(from);
+  unsigned char* dst = slot_pixels_(to);
+  const std::size_t offset = static_cast<std::size_t>(r.x) * 4;
+  const std::size_t bytes = static_cast<std::size_t>(r.w) * 4;
+  for (int y = r.y; y < r.y + r.h; ++y) {
+    const std::size_t row = static_cast<std::size_t>(y) * stride_ + offset;
+    std::memcpy(dst + row, src + row, bytes);
+  }
+}
+
+unsigned char* FrameRingWriter::begin_frame() {
+  if (!header_) return nullptr;
+  const int slot = static_cast<int>((frame_ + 1) % slots_);
+  auto& sh = header_->slots[slot];
+
+  // Readers still on this slot's previous frame see the odd sequence and back off.
+  sh.seq.store(sh.seq.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  if (frame_ > 0) {
+    const int latest = static_cast<int>(frame_ % slots_);
+    if (stale_full_[slot]) {
+      std::memcpy(slot_pixels_(slot), slot_pixels_(latest), static_cast<std::size_t>(stride_) * height_);
+    } else {
+      for (const Rect& r : stale_[slot]) copy_rect_(latest, slot, r);
+    }
+  }
+  stale_[slot].clear();
+  stale_full_[slot] = false;
+
+  in_frame_ = true;
+  return slot_pixels_(slot);
+}
+
+void FrameRingWriter::publish(std::span<const Rect> damage, std::int64_t time_us, bool full_frame) {
+  if (!header_ || !in_frame_) return;
+  in_frame_ = false;
+
+  const int slot = static_cast<int>((frame_ + 1) % slots_);
+  auto& sh = header_->slots[slot];
+
+  // Plain fields are covered by the slot sequence, like the pixels.
+  full_frame = full_frame || frame_ == 0;
+  std::uint32_t n = 0;
+  if (full_frame) {
+    sh.damage[n++] = {0, 0, width_, height_};
+  } else if (damage.size() > static_cast<std::size_t>(frame_ring::kMaxDamage)) {
+    sh.damage[n++] = clip(bounding_box(damage), width_, height_);
+  } else {
+    for (const Rect& r : damage) {
+      const Rect c = clip(r, width_, height_);
+      if (c.w > 0 && c.h > 0) sh.damage[n++] = c;
+    }
+  }
+  sh.frame = frame_ + 1;
+  sh.time_us = time_us;
+  sh.flags = full_frame ? frame_ring::kFullFrame : 0u;
+  sh.damage_count = n;
+
+  sh.seq.store(sh.seq.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  header_->latest.store(++frame_, std::memory_order_release);
+
+  // Every other slot now lags behind by this frame's damage.
+  for (int s = 0; s < slots_; ++s) {
+    if (s == slot || stale_full_[s]) continue;
+    if (full_frame || stale_[s].size() + n > kMaxStale) {
+      stale_full_[s] = true;
+      stale_[s].clear();
+      continue;
+    }
+    stale_[s].insert(stale_[s].end(), sh.damage, sh.damage + n);
+  }
+}
+
+// ---------------- Reader ----------------
+
+FrameRingReader::~FrameRingReader() {
+  close();
+}
+
+void FrameRingReader::close() {
+  if (header_) ::munmap(const_cast<frame_ring::Header*>(header_), map_size_);
+  header_ = nullptr;
+  map_size_ = 0;
+}
+
+bool FrameRingReader::open(const std::string& name, std::string* error) {
+  close();
+
+  auto fail = [&](const std::string& what) {
+    if (error) *error = name + ": " + what;
+    close();
+    return false;
+  };
+
+  const int fd = ::shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+  if (fd < 0) return fail(std::strerror(errno));
+
+  struct stat st{};
+  if (::fstat(fd, &st) != 0) {
+    const int e = errno;
+    ::close(fd);
+    return fail(std::strerror(e));
+  }
+  const std::size_t size = static_cast<std::size_t>(st.st_size);
+  if (size < sizeof(frame_ring::Header)) {
+    ::close(fd);
+    return fail("not a frame ring");
+  }
+  void* p = ::mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+  const int e = errno;
+  ::close(fd);
+  if (p == MAP_FAILED) return fail(std::strerror(e));
+
+  header_ = static_cast<const frame_ring::Header*>(p);
+  map_size_ = size;
+
+  const auto& h = *header_;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  if (h.magic != frame_ring::kMagic) return fail("not a frame ring");
+  if (h.version != frame_ring::kVersion) return fail("unsupported frame ring version");
+  if (h.slot_count < 2 || h.slot_count > static_cast<std::uint32_t>(frame_ring::kMaxSlots) ||
+      h.stride < h.width * 4 || h.slot_bytes < static_cast<std::uint64_t>(h.stride) * h.height ||
+      h.pixels_offset + h.slot_bytes * h.slot_count > size) {
+    return fail("corrupt frame ring header");
+  }
+  return true;
+}
+
+bool FrameRingReader::acquire(Frame& f, std::uint64_t since) const {
+  if (!header_) return false;
+  const auto& h = *header_;
+
+  // Only fails repeatedly if the writer laps the whole ring meanwhile.
+  for (int attempt = 0; attempt < 8; ++attempt) {
+    const std::uint64_t latest = h.latest.load(std::memory_order_acquire);
+    if (latest == 0 || latest <= since) return false;
+
+    const int slot = static_cast<int>(latest % h.slot_count);
+    const auto& sh = h.slots[slot];
+    const std::uint64_t s0 = sh.seq.load(std::memory_order_acquire);
+    if (s0 & 1u) continue;
+
+    Frame out;
+    out.number = sh.frame;
+    out.time_us = sh.time_us;
+    out.full = (sh.flags & frame_ring::kFullFrame) != 0;
+    out.damage_count = std::min<std::uint32_t>(sh.damage_count, frame_ring::kMaxDamage);
+    std::copy_n(sh.damage, out.damage_count, out.damage.begin());
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sh.seq.load(std::memory_order_relaxed) != s0 || out.number != latest) continue;
+
+    if (out.full || out.number != since + 1) {
+      out.full = true;
+      out.damage_count = 1;
+      out.damage[0] = {0, 0, static_cast<std::int32_t>(h.width), static_cast<std::int32_t>(h.height)};
+    }
+    out.pixels = reinterpret_cast<const unsigned char*>(header_) + h.pixels_offset +
+                 h.slot_bytes * static_cast<std::size_t>(slot);
+    out.slot = slot;
+    out.seq = s0;
+    f = out;
+    return true;
+  }
+  return false;
+}
+
+bool FrameRingReader::still_valid(const Frame& f) const {
+  if (!header_ || !f.pixels) return false;
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return header_->slots[f.slot].seq.load(std::memory_order_relaxed) == f.seq;
+}
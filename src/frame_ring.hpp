@@ -0,0 +1,162 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+// Live frame output through POSIX shared memory, for external displays
+// (e-paper, network repeaters) that mirror the gauges without scraping
+// the window.
+//
+// One writer publishes frames into a ring of 2..4 pixel slots; any number
+// of readers map the same object read-only and read pixels in place. Each
+// slot carries the rectangles that changed since the previous frame, so a
+// reader that keeps up only pushes those pixels. A reader that skipped
+// frames (or sees kFullFrame) refreshes everything.
+//
+// Pixels are Cairo ARGB32: native-endian 32-bit words, premultiplied
+// alpha, `stride` bytes per row.
+namespace frame_ring {
+
+inline constexpr std::uint32_t kMagic = 0x31524647;  // "GFR1" little-endian
+inline constexpr std::uint32_t kVersion = 1;
+inline constexpr int kMaxSlots = 4;
+inline constexpr int kMaxDamage = 16;
+
+// Device pixels.
+struct Rect {
+  std::int32_t x = 0;
+  std::int32_t y = 0;
+  std::int32_t w = 0;
+  std::int32_t h = 0;
+};
+
+enum Flags : std::uint32_t {
+  kFullFrame = 1u,  // damage lists the whole frame (first frame, resize, overflow)
+};
+
+struct alignas(64) SlotHeader {
+  std::atomic<std::uint64_t> seq;  // odd while the writer fills the slot
+  std::uint64_t frame;             // 1, 2, ...; frame f lives in slot f % slot_count
+  std::int64_t time_us;
+  std::uint32_t flags;
+  std::uint32_t damage_count;
+  Rect damage[kMaxDamage];         // changed since frame - 1
+};
+
+struct alignas(64) Header {
+  std::uint32_t magic;
+  std::uint32_t version;
+  std::uint32_t width;
+  std::uint32_t height;
+  std::uint32_t stride;
+  std::uint32_t slot_count;
+  std::uint64_t slot_bytes;
+  std::uint64_t pixels_offset;      // of slot 0, from the start of the mapping
+  std::atomic<std::uint64_t> latest;  // newest complete frame; 0 before the first
+  SlotHeader slots[kMaxSlots];
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free,
+              "shared-memory atomics must be lock-free");
+
+} // namespace frame_ring
+
+// Producer side. Not thread-safe; one writer per ring.
+class FrameRingWriter {
+public:
+  FrameRingWriter() = default;
+  ~FrameRingWriter();
+
+  FrameRingWriter(const FrameRingWriter&) = delete;
+  FrameRingWriter& operator=(const FrameRingWriter&) = delete;
+
+  // `name` is a shm_open() name ("/gauges"). Replaces an existing object of
+  // that name; it is unlinked again by close().
+  bool create(const std::string& name, int width, int height, int slots = 3, std::string* error = nullptr);
+  void close();
+  bool is_open() const { return header_ != nullptr; }
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  int stride() const { return stride_; }
+  int slots() const { return slots_; }
+  std::uint64_t frame() const { return frame_; }  // last published
+  // Slot the next begin_frame() will fill.
+  int next_slot() const { return slots_ ? static_cast<int>((frame_ + 1) % slots_) : 0; }
+
+  // Starts the next frame and returns its slot's pixels. The slot is first
+  // brought up to date with the last published frame by copying only the
+  // regions that changed since the slot was last written, so the caller
+  // just redraws this frame's damage.
+  unsigned char* begin_frame();
+  // Publishes the frame started by begin_frame(). `damage` lists what
+  // changed since the previous frame; more than kMaxDamage rectangles are
+  // merged into their bounding box. The first frame is always full.
+  void publish(std::span<const frame_ring::Rect> damage, std::int64_t time_us, bool full_frame = false);
+
+private:
+  unsigned char* slot_pixels_(int slot) const;
+  void copy_rect_(int from, int to, const frame_ring::Rect& r) const;
+
+  std::string name_;
+  frame_ring::Header* header_ = nullptr;
+  std::size_t map_size_ = 0;
+  int width_ = 0;
+  int height_ = 0;
+  int stride_ = 0;
+  int slots_ = 0;
+  std::uint64_t frame_ = 0;
+  bool in_frame_ = false;
+
+  // Regions each slot is behind the latest frame by.
+  static constexpr std::size_t kMaxStale = 64;
+  std::array<std::vector<frame_ring::Rect>, frame_ring::kMaxSlots> stale_;
+  std::array<bool, frame_ring::kMaxSlots> stale_full_{};
+};
+
+// Consumer side (any process). Pixels are read in place from the mapping.
+class FrameRingReader {
+public:
+  struct Frame {
+    std::uint64_t number = 0;  // 0: nothing published yet
+    std::int64_t time_us = 0;
+    bool full = false;         // kFullFrame, or frames were skipped since `since`
+    std::uint32_t damage_count = 0;
+    std::array<frame_ring::Rect, frame_ring::kMaxDamage> damage{};
+    const unsigned char* pixels = nullptr;  // into the mapping; see still_valid()
+    int slot = 0;
+    std::uint64_t seq = 0;
+  };
+
+  FrameRingReader() = default;
+  ~FrameRingReader();
+
+  FrameRingReader(const FrameRingReader&) = delete;
+  FrameRingReader& operator=(const FrameRingReader&) = delete;
+
+  bool open(const std::string& name, std::string* error = nullptr);
+  void close();
+  bool is_open() const { return header_ != nullptr; }
+
+  int width() const { return header_ ? static_cast<int>(header_->width) : 0; }
+  int height() const { return header_ ? static_cast<int>(header_->height) : 0; }
+  int stride() const { return header_ ? static_cast<int>(header_->stride) : 0; }
+  std::uint64_t latest() const { return header_ ? header_->latest.load(std::memory_order_acquire) : 0; }
+
+  // Newest frame. `since` is the last frame the caller consumed: unless the
+  // result is exactly the next one, it is marked full. Returns false if
+  // nothing newer than `since` is available.
+  bool acquire(Frame& f, std::uint64_t since = 0) const;
+  // True while the writer has not started overwriting f's slot; check after
+  // reading the pixels and retry (as a full frame) if it fails.
+  bool still_valid(const Frame& f) const;
+
+private:
+  const frame_ring::Header* header_ = nullptr;
+  std::size_t map_size_ = 0;
+};
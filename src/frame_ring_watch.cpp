@@ -0,0 +1,112 @@
+// Example consumer of a shared-memory frame ring (see frame_ring.hpp).
+//
+// Keeps a local copy of the frame current by copying only the damaged
+// rectangles of each new frame, and prints what changed. This is the loop
+// an e-paper or network repeater would run, with the print replaced by a
+// partial refresh of the changed pixels.
+//
+// Usage:
+//   frame_ring_watch NAME [--frames N] [--ppm FILE]
+//
+// --ppm writes the local copy (composited over black) when done.
+
+#include "frame_ring.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+bool write_ppm(const std::string& path, const std::vector<unsigned char>& argb, int w, int h, int stride) {
+  std::FILE* f = std::fopen(path.c_str(), "wb");
+  if (!f) return false;
+  std::fprintf(f, "P6\n%d %d\n255\n", w, h);
+  std::vector<unsigned char> row(static_cast<std::size_t>(w) * 3);
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      std::uint32_t p;
+      std::memcpy(&p, &argb[static_cast<std::size_t>(y) * stride + x * 4], sizeof(p));
+      // Premultiplied color is already the composite over black.
+      row[x * 3 + 0] = static_cast<unsigned char>(p >> 16);
+      row[x * 3 + 1] = static_cast<unsigned char>(p >> 8);
+      row[x * 3 + 2] = static_cast<unsigned char>(p);
+    }
+    std::fwrite(row.data(), 1, row.size(), f);
+  }
+  return std::fclose(f) == 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  if (argc < 2) {
+    std::fprintf(stderr, "usage: %s NAME [--frames N] [--ppm FILE]\n", argv[0]);
+    return 2;
+  }
+  const std::string name = argv[1];
+  long max_frames = 0;
+  std::string ppm;
+  for (int i = 2; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) max_frames = std::atol(argv[++i]);
+    else if (std::strcmp(argv[i], "--ppm") == 0 && i + 1 < argc) ppm = argv[++i];
+    else {
+      std::fprintf(stderr, "unknown option %s\n", argv[i]);
+      return 2;
+    }
+  }
+
+  FrameRingReader ring;
+  std::string err;
+  if (!ring.open(name, &err)) {
+    std::fprintf(stderr, "%s\n", err.c_str());
+    return 1;
+  }
+
+  const int w = ring.width();
+  const int h = ring.height();
+  const int stride = ring.stride();
+  std::vector<unsigned char> local(static_cast<std::size_t>(stride) * h);
+  std::printf("%s: %dx%d\n", name.c_str(), w, h);
+
+  std::uint64_t last = 0;
+  long seen = 0;
+  FrameRingReader::Frame f;
+  while (max_frames <= 0 || seen < max_frames) {
+    if (!ring.acquire(f, last)) {
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      continue;
+    }
+
+    double area = 0.0;
+    for (std::uint32_t i = 0; i < f.damage_count; ++i) {
+      const auto& r = f.damage[i];
+      for (int y = r.y; y < r.y + r.h; ++y) {
+        const std::size_t at = static_cast<std::size_t>(y) * stride + static_cast<std::size_t>(r.x) * 4;
+        std::memcpy(&local[at], f.pixels + at, static_cast<std::size_t>(r.w) * 4);
+      }
+      area += static_cast<double>(r.w) * r.h;
+    }
+    // The writer lapped us mid-copy: take the next frame in full.
+    if (!ring.still_valid(f)) {
+      last = 0;
+      continue;
+    }
+
+    std::printf("frame %llu  %u rect%s  %5.1f%%%s\n", static_cast<unsigned long long>(f.number),
+                f.damage_count, f.damage_count == 1 ? " " : "s", 100.0 * area / (static_cast<double>(w) * h),
+                f.full ? "  full" : "");
+    last = f.number;
+    ++seen;
+  }
+
+  if (!ppm.empty() && !write_ppm(ppm, local, w, h, stride)) {
+    std::perror(ppm.c_str());
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,548 @@
+// Headless render benchmark for GaugeFace and the wind gauge faces.
+//
+// Renders into Cairo image surfaces (no display, no GTK init) and sweeps
+// gauge kind, size, zone count and major tick count. Each case is timed in
+// two modes:
+//   cached - dial blitted from the cache, only readout + needle drawn
+//   full   - dial invalidated every frame (cost of a complete repaint)
+//
+// --raster-threads times a dashboard frame instead: --gauges faces (64 by
+// default) each drawn into their own surface, by a RasterPool with that
+// many workers, or one after another on the calling thread for 0.
+//
+// Usage:
+//   gauge_bench [--frames N] [--warmup N] [--sizes 128,256,...]
+//               [--zones 0,4,...] [--ticks 5,9,...] [--mode cached|full|both]
+//               [--kind all|circular|wind_angle|wind_speed]
+//               [--format table|csv|json] [--out FILE]
+//               [--raster-threads 0,2,4,... [--gauges N]]
+//   gauge_bench --true-wind N [--frames N] [--format ...] [--out FILE]
+//   gauge_bench --true-wind-log FILE [--frames N] [--format ...] [--out FILE]
+//   (either one) --polar FILE
+//
+// --true-wind skips rendering and measures the true wind kernel instead:
+// N synthetic samples per pass, once as one batch and once sample by
+// sample through the live entry point. --true-wind-log uses the columns of
+// a recorded instrument log instead of synthetic data. --polar adds the
+// polar lookups over the same samples: score_against_polar() over the
+// batch, and the per-sample target speed and VMG lookups the panel does.
+
+#include "gauge_face.hpp"
+#include "log_replay.hpp"
+#include "polar.hpp"
+#include "raster_pool.hpp"
+#include "true_wind.hpp"
+#include "wind_face.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Options {
+  int frames = 200;
+  int warmup = 10;
+  std::vector<int> sizes  = {128, 256, 512, 1024, 2048};
+  std::vector<int> zones  = {0, 4, 16, 64};
+  std::vector<int> majors = {5, 9, 13, 37};
+  bool mode_cached = true;
+  bool mode_full   = true;
+  std::string kind   = "all";
+  std::string format = "table";
+  std::string out;
+  int true_wind_samples = 0;
+  std::string true_wind_log;
+  std::string polar;
+  std::vector<int> raster_threads;  // empty: one gauge, drawn inline
+  int gauges = 64;
+};
+
+struct Case {
+  std::string kind;
+  int size = 0;
+  int zones = 0;
+  int majors = 0;
+  int minors = 0;
+  bool full = false;
+  int gauges = 1;
+  int threads = 0;  // RasterPool workers; 0 draws inline
+};
+
+struct Result {
+  Case c;
+  double fps = 0.0;
+  double mean_ms = 0.0;
+  double p50_ms = 0.0;
+  double p99_ms = 0.0;
+  double max_ms = 0.0;
+};
+
+std::vector<int> parse_int_list(const std::string& s) {
+  std::vector<int> v;
+  size_t pos = 0;
+  while (pos < s.size()) {
+    const size_t comma = s.find(',', pos);
+    const std::string item = s.substr(pos, comma == std::string::npos ? std::string::npos : comma - pos);
+    if (!item.empty()) v.push_back(std::atoi(item.c_str()));
+    if (comma == std::string::npos) break;
+    pos = comma + 1;
+  }
+  return v;
+}
+
+void usage(const char* argv0) {
+  std::fprintf(stderr,
+               "usage: %s [--frames N] [--warmup N] [--sizes a,b,..] [--zones a,b,..]\n"
+               "          [--ticks a,b,..] [--mode cached|full|both]\n"
+               "          [--kind all|circular|ramp|wind_angle|wind_speed]\n"
+               "          [--format table|csv|json] [--out FILE]\n"
+               "          [--raster-threads a,b,.. [--gauges N]]\n"
+               "       %s --true-wind N|--true-wind-log FILE [--polar FILE] [--frames N] [--format ...] [--out FILE]\n",
+               argv0, argv0);
+}
+
+bool parse_args(int argc, char** argv, Options& o) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    auto next = [&]() -> std::string {
+      if (i + 1 >= argc) return {};
+      return argv[++i];
+    };
+
+    if (a == "--frames")      o.frames = std::max(1, std::atoi(next().c_str()));
+    else if (a == "--warmup") o.warmup = std::max(0, std::atoi(next().c_str()));
+    else if (a == "--sizes")  o.sizes  = parse_int_list(next());
+    else if (a == "--zones")  o.zones  = parse_int_list(next());
+    else if (a == "--ticks")  o.majors = parse_int_list(next());
+    else if (a == "--kind")   o.kind   = next();
+    else if (a == "--format") o.format = next();
+    else if (a == "--out")    o.out    = next();
+    else if (a == "--true-wind") o.true_wind_samples = std::max(1, std::atoi(next().c_str()));
+    else if (a == "--true-wind-log") o.true_wind_log = next();
+    else if (a == "--polar") o.polar = next();
+    else if (a == "--raster-threads") o.raster_threads = parse_int_list(next());
+    else if (a == "--gauges") o.gauges = std::max(1, std::atoi(next().c_str()));
+    else if (a == "--mode") {
+      const std::string m = next();
+      o.mode_cached = (m == "cached" || m == "both");
+      o.mode_full   = (m == "full"   || m == "both");
+      if (!o.mode_cached && !o.mode_full) return false;
+    } else {
+      return false;
+    }
+  }
+  return o.format == "table" || o.format == "csv" || o.format == "json";
+}
+
+// Alternating zones covering the whole range.
+std::vector<GaugeFace::Zone> make_zones(int n, double min_v, double max_v) {
+  static const Gdk::RGBA palette[] = {
+      Gdk::RGBA("#34c759"), Gdk::RGBA("#ff9f0a"), Gdk::RGBA("#ff3b30"), Gdk::RGBA("#0a84ff")};
+
+  std::vector<GaugeFace::Zone> z;
+  const double step = (max_v - min_v) / std::max(1, n);
+  for (int i = 0; i < n; ++i) {
+    z.push_back({min_v + i * step, min_v + (i + 1) * step, palette[i % 4], 0.9});
+  }
+  return z;
+}
+
+// Same zones the wind panel puts on the AWA dial.
+std::vector<GaugeFace::Zone> wind_angle_zones() {
+  return {
+      {-60.0, -20.0, Gdk::RGBA("#ff3b30"), 1.0},
+      { 20.0,  60.0, Gdk::RGBA("#34c759"), 1.0},
+      {160.0, 180.0, Gdk::RGBA("#ff9f0a"), 1.0},
+      {-180.0, -160.0, Gdk::RGBA("#ff9f0a"), 1.0},
+  };
+}
+
+// `n` buckets shading from green through amber to red, like a VMG% band.
+GaugeFace::ZoneRamp make_ramp(int n) {
+  GaugeFace::ZoneRamp ramp;
+  ramp.buckets.reserve(static_cast<std::size_t>(n));
+  for (int i = 0; i < n; ++i) {
+    const double t = static_cast<double>(i) / std::max(1, n - 1);
+    Gdk::RGBA c;
+    c.set_rgba(std::min(1.0, 2.0 * t), std::min(1.0, 2.0 * (1.0 - t)), 0.2, 1.0);
+    ramp.buckets.push_back(c);
+  }
+  ramp.alpha = 0.9;
+  return ramp;
+}
+
+std::unique_ptr<GaugeFace> make_face(Case& c) {
+  if (c.kind == "wind_angle") {
+    auto f = std::make_unique<WindAngleFace>();
+    f->set_zones(wind_angle_zones());
+    c.zones  = static_cast<int>(f->zones().size());
+    c.majors = f->style().major_ticks;
+    c.minors = f->style().minor_ticks;
+    return f;
+  }
+  if (c.kind == "wind_speed") {
+    auto f = std::make_unique<WindSpeedFace>();
+    c.zones  = 0;
+    c.majors = f->style().major_ticks;
+    c.minors = f->style().minor_ticks;
+    return f;
+  }
+
+  auto f = std::make_unique<GaugeFace>();
+  f->set_title("BENCH");
+  f->set_unit("units");
+  f->set_range(0.0, 100.0);
+  if (c.kind == "ramp") f->set_zone_ramp(make_ramp(c.zones));
+  else f->set_zones(make_zones(c.zones, 0.0, 100.0));
+  f->style().major_ticks = c.majors;
+  f->style().minor_ticks = c.minors;
+  return f;
+}
+
+void set_frame_value(GaugeFace& face, const Case& c, int frame) {
+  // Sweep the needle so every frame is a real update.
+  const double s = 0.5 + 0.5 * std::sin(frame * 0.05);
+  if (c.kind == "wind_angle") {
+    auto& w = static_cast<WindAngleFace&>(face);
+    w.set_angle_deg(-180.0 + 360.0 * s);
+    w.set_speed_kn(40.0 * s);
+  } else {
+    face.set_value(face.min_value() + (face.max_value() - face.min_value()) * s);
+  }
+}
+
+double percentile(const std::vector<double>& sorted, double p) {
+  if (sorted.empty()) return 0.0;
+  const size_t idx = static_cast<size_t>(std::ceil(p * static_cast<double>(sorted.size())));
+  return sorted[std::min(sorted.size() - 1, idx > 0 ? idx - 1 : 0)];
+}
+
+// One frame is every gauge of the case drawn once; the faces are offset
+// in phase so they don't all show the same value.
+Result run_case(Case c, const Options& o) {
+  struct Target {
+    std::unique_ptr<GaugeFace> face;
+    Cairo::RefPtr<Cairo::ImageSurface> surface;
+    Cairo::RefPtr<Cairo::Context> cr;
+  };
+  std::vector<Target> targets(static_cast<std::size_t>(c.gauges));
+  for (auto& t : targets) {
+    t.face = make_face(c);
+    t.surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, c.size, c.size);
+    t.cr = Cairo::Context::create(t.surface);
+  }
+  std::unique_ptr<RasterPool> pool;
+  if (c.threads > 0) pool = std::make_unique<RasterPool>(static_cast<unsigned>(c.threads));
+
+  auto draw = [&c](Target& t) {
+    t.face->draw(t.cr, c.size, c.size);
+    t.surface->flush();
+  };
+
+  std::vector<double> ms;
+  ms.reserve(o.frames);
+
+  using clock = std::chrono::steady_clock;
+
+  for (int i = 0; i < o.warmup + o.frames; ++i) {
+    for (std::size_t g = 0; g < targets.size(); ++g) {
+      auto& t = targets[g];
+      t.cr->save();
+      t.cr->set_operator(Cairo::Context::Operator::CLEAR);
+      t.cr->paint();
+      t.cr->restore();
+
+      set_frame_value(*t.face, c, i + static_cast<int>(g) * 7);
+      if (c.full) t.face->invalidate_dial();
+    }
+
+    const auto t0 = clock::now();
+    if (pool) {
+      for (std::size_t g = 0; g < targets.size(); ++g) pool->submit(g, [&draw, &t = targets[g]] { draw(t); });
+      pool->wait_idle();
+    } else {
+      for (auto& t : targets) draw(t);
+    }
+    const auto t1 = clock::now();
+
+    if (i >= o.warmup) {
+      ms.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+    }
+  }
+
+  std::vector<double> sorted = ms;
+  std::sort(sorted.begin(), sorted.end());
+
+  double sum = 0.0;
+  for (double v : ms) sum += v;
+
+  Result r;
+  r.c = c;
+  r.mean_ms = sum / static_cast<double>(ms.size());
+  r.fps = r.mean_ms > 0.0 ? 1000.0 / r.mean_ms : 0.0;
+  r.p50_ms = percentile(sorted, 0.50);
+  r.p99_ms = percentile(sorted, 0.99);
+  r.max_ms = sorted.back();
+  return r;
+}
+
+std::vector<Case> build_cases(const Options& o) {
+  std::vector<Case> cases;
+  const bool all = (o.kind == "all");
+
+  auto add = [&](Case c) {
+    auto add_mode = [&](Case m) {
+      if (o.raster_threads.empty()) {
+        cases.push_back(m);
+        return;
+      }
+      m.gauges = o.gauges;
+      for (int t : o.raster_threads) {
+        m.threads = std::max(0, t);
+        cases.push_back(m);
+      }
+    };
+    if (o.mode_cached) { c.full = false; add_mode(c); }
+    if (o.mode_full)   { c.full = true;  add_mode(c); }
+  };
+
+  for (int size : o.sizes) {
+    if (size <= 0) continue;
+
+    if (all || o.kind == "circular") {
+      for (int z : o.zones) {
+        for (int m : o.majors) {
+          add({"circular", size, std::max(0, z), std::max(2, m), 4, false});
+        }
+      }
+    }
+    // 360 ramp buckets: one texture, however many bands.
+    if (all || o.kind == "ramp") add({"ramp", size, 360, 9, 4, false});
+    // Wind faces have a fixed layout; only the size is swept.
+    if (all || o.kind == "wind_angle") add({"wind_angle", size, 0, 0, 0, false});
+    if (all || o.kind == "wind_speed") add({"wind_speed", size, 0, 0, 0, false});
+  }
+  return cases;
+}
+
+void print_table(std::FILE* f, const std::vector<Result>& rs) {
+  std::fprintf(f, "%-11s %5s %5s %6s %6s %-6s %6s %7s %10s %9s %9s %9s\n",
+               "kind", "size", "zones", "majors", "minors", "mode", "gauges", "threads",
+               "fps", "p50_ms", "p99_ms", "max_ms");
+  for (const auto& r : rs) {
+    std::fprintf(f, "%-11s %5d %5d %6d %6d %-6s %6d %7d %10.1f %9.3f %9.3f %9.3f\n",
+                 r.c.kind.c_str(), r.c.size, r.c.zones, r.c.majors, r.c.minors,
+                 r.c.full ? "full" : "cached", r.c.gauges, r.c.threads,
+                 r.fps, r.p50_ms, r.p99_ms, r.max_ms);
+  }
+}
+
+void print_csv(std::FILE* f, const std::vector<Result>& rs) {
+  std::fprintf(f, "kind,size,zones,majors,minors,mode,gauges,threads,fps,mean_ms,p50_ms,p99_ms,max_ms\n");
+  for (const auto& r : rs) {
+    std::fprintf(f, "%s,%d,%d,%d,%d,%s,%d,%d,%.3f,%.6f,%.6f,%.6f,%.6f\n",
+                 r.c.kind.c_str(), r.c.size, r.c.zones, r.c.majors, r.c.minors,
+                 r.c.full ? "full" : "cached", r.c.gauges, r.c.threads,
+                 r.fps, r.mean_ms, r.p50_ms, r.p99_ms, r.max_ms);
+  }
+}
+
+void print_json(std::FILE* f, const std::vector<Result>& rs, const Options& o) {
+  std::fprintf(f, "{\n  \"benchmark\": \"gauge_bench\",\n  \"frames\": %d,\n  \"warmup\": %d,\n  \"results\": [\n",
+               o.frames, o.warmup);
+  for (size_t i = 0; i < rs.size(); ++i) {
+    const auto& r = rs[i];
+    std::fprintf(f,
+                 "    {\"kind\": \"%s\", \"size\": %d, \"zones\": %d, \"majors\": %d, \"minors\": %d, "
+                 "\"mode\": \"%s\", \"gauges\": %d, \"threads\": %d, \"fps\": %.3f, \"mean_ms\": %.6f, \"p50_ms\": %.6f, "
+                 "\"p99_ms\": %.6f, \"max_ms\": %.6f}%s\n",
+                 r.c.kind.c_str(), r.c.size, r.c.zones, r.c.majors, r.c.minors,
+                 r.c.full ? "full" : "cached", r.c.gauges, r.c.threads,
+                 r.fps, r.mean_ms, r.p50_ms, r.p99_ms, r.max_ms,
+                 i + 1 < rs.size() ? "," : "");
+  }
+  std::fprintf(f, "  ]\n}\n");
+}
+
+struct TrueWindResult {
+  const char* path;
+  std::size_t samples;
+  double msamples_per_s;
+  double ns_per_sample;
+};
+
+// Synthetic columns: uniform over the whole input domain, with ground data.
+TrueWindBatch synthetic_true_wind(std::size_t n) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> angle(-180.0, 180.0), dir(0.0, 360.0),
+      wind(0.0, 35.0), boat(0.0, 12.0);
+
+  TrueWindBatch b;
+  b.reserve(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    WindSample s{static_cast<std::int64_t>(i) * 100'000, angle(rng), wind(rng), true, true};
+    s.stw_kn = boat(rng);
+    s.heading_deg = dir(rng);
+    s.cog_deg = dir(rng);
+    s.sog_kn = boat(rng);
+    s.has_stw = s.has_heading = s.has_ground = true;
+    b.append(s);
+  }
+  return b;
+}
+
+// Best of several passes over the same columns, in seconds.
+template <class Pass>
+double best_of(const Options& o, Pass&& pass) {
+  using clock = std::chrono::steady_clock;
+  double best = 1e300;
+  for (int f = 0; f < std::max(1, o.frames / 20); ++f) {
+    const auto t0 = clock::now();
+    pass();
+    best = std::min(best, std::chrono::duration<double>(clock::now() - t0).count());
+  }
+  return best;
+}
+
+std::vector<TrueWindResult> run_true_wind(TrueWindBatch& b, const Options& o) {
+  const std::size_t n = b.size();
+  TrueWindConfig config;
+  b.compute(config);  // sizes the outputs
+  const TrueWindInput in = b.input();
+  const TrueWindOutput out{b.twa_deg, b.tws_kn, b.twd_deg};
+
+  const double batch = best_of(o, [&] { compute_true_wind(in, out, config); });
+  volatile double sink = 0.0;  // keeps the single-sample loop from being elided
+  const double single = best_of(o, [&] {
+    double acc = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+      acc += true_wind_one(b.awa_deg[i], b.aws_kn[i], b.stw_kn[i], b.heading_deg[i], 0.0,
+                           b.has_ground, b.cog_deg[i], b.sog_kn[i], config).twd_deg;
+    }
+    sink = acc;
+  });
+  (void)sink;
+
+  auto result = [&](const char* path, double s) {
+    return TrueWindResult{path, n, n / s / 1e6, s * 1e9 / n};
+  };
+  return {result("batch", batch), result("single", single)};
+}
+
+// Needs b.compute() to have run (run_true_wind() does).
+std::vector<TrueWindResult> run_polar(const TrueWindBatch& b, const PolarTable& polar, const Options& o) {
+  const std::size_t n = b.size();
+  volatile double sink = 0.0;
+  const double batch = best_of(o, [&] { sink = score_against_polar(polar, b).size(); });
+  const double single = best_of(o, [&] {
+    double acc = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+      acc += polar.boat_speed(b.tws_kn[i], b.twa_deg[i]) + polar.targets(b.tws_kn[i], b.twa_deg[i]).bsp_kn;
+    }
+    sink = acc;
+  });
+  (void)sink;
+
+  auto result = [&](const char* path, double s) {
+    return TrueWindResult{path, n, n / s / 1e6, s * 1e9 / n};
+  };
+  return {result("polar_batch", batch), result("polar_one", single)};
+}
+
+void print_true_wind(std::FILE* f, const std::vector<TrueWindResult>& rs, const Options& o) {
+  if (o.format == "csv") {
+    std::fprintf(f, "path,samples,msamples_per_s,ns_per_sample\n");
+    for (const auto& r : rs) {
+      std::fprintf(f, "%s,%zu,%.3f,%.3f\n", r.path, r.samples, r.msamples_per_s, r.ns_per_sample);
+    }
+  } else if (o.format == "json") {
+    std::fprintf(f, "{\n  \"benchmark\": \"true_wind\",\n  \"samples\": %zu,\n  \"results\": [\n",
+                 rs.empty() ? std::size_t{0} : rs[0].samples);
+    for (std::size_t i = 0; i < rs.size(); ++i) {
+      std::fprintf(f, "    {\"path\": \"%s\", \"msamples_per_s\": %.3f, \"ns_per_sample\": %.3f}%s\n",
+                   rs[i].path, rs[i].msamples_per_s, rs[i].ns_per_sample, i + 1 < rs.size() ? "," : "");
+    }
+    std::fprintf(f, "  ]\n}\n");
+  } else {
+    std::fprintf(f, "%-11s %10s %14s %13s\n", "path", "samples", "Msamples/s", "ns/sample");
+    for (const auto& r : rs) {
+      std::fprintf(f, "%-11s %10zu %14.2f %13.2f\n", r.path, r.samples, r.msamples_per_s, r.ns_per_sample);
+    }
+  }
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options o;
+  if (!parse_args(argc, argv, o)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  std::FILE* f = stdout;
+  if (!o.out.empty()) {
+    f = std::fopen(o.out.c_str(), "w");
+    if (!f) {
+      std::perror(o.out.c_str());
+      return 1;
+    }
+  }
+
+  if (o.true_wind_samples > 0 || !o.true_wind_log.empty()) {
+    TrueWindBatch batch;
+    if (!o.true_wind_log.empty()) {
+      LogReader log;
+      std::string err;
+      if (!log.open(o.true_wind_log, &err)) {
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+      }
+      batch = true_wind_from_log(log);
+      if (batch.size() == 0) {
+        std::fprintf(stderr, "%s: no samples with both wind and boat data\n", o.true_wind_log.c_str());
+        return 1;
+      }
+    } else {
+      batch = synthetic_true_wind(static_cast<std::size_t>(o.true_wind_samples));
+    }
+    auto results = run_true_wind(batch, o);
+    if (!o.polar.empty()) {
+      PolarTable polar;
+      std::string err;
+      if (!polar.load(o.polar, &err)) {
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+      }
+      const auto p = run_polar(batch, polar, o);
+      results.insert(results.end(), p.begin(), p.end());
+    }
+    print_true_wind(f, results, o);
+    if (f != stdout) std::fclose(f);
+    return 0;
+  }
+
+  std::vector<Result> results;
+  for (const auto& c : build_cases(o)) {
+    results.push_back(run_case(c, o));
+    if (o.format == "table" && o.out.empty()) {
+      // Progress for long sweeps goes to stderr so stdout stays clean.
+      std::fprintf(stderr, ".");
+    }
+  }
+  if (o.format == "table" && o.out.empty()) std::fprintf(stderr, "\n");
+
+  if (o.format == "csv")       print_csv(f, results);
+  else if (o.format == "json") print_json(f, results, o);
+  else                         print_table(f, results);
+
+  if (f != stdout) std::fclose(f);
+  return 0;
+}
@@ -0,0 +1,207 @@
+#include "gauge_control.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+GaugeControl::GaugeControl(Gtk::Widget& host, std::unique_ptr<GaugeFace> face)
+: host_(host), face_(std::move(face)) {}
+
+GaugeControl::~GaugeControl() {
+  if (update_tick_id_ != 0) host_.remove_tick_callback(update_tick_id_);
+}
+
+void GaugeControl::set_range(double min_v, double max_v) {
+  face_->set_range(min_v, max_v);
+  request_update();
+}
+
+void GaugeControl::set_value(double v) {
+  if (!smoothing_.enabled) {
+    face_->set_value(v);
+    request_update();
+    return;
+  }
+
+  // Keep the needle where it is and let the spring carry it to the new value.
+  const double shown = face_->needle_value();
+  face_->set_value(v);
+  face_->set_needle_value(shown);
+  animating_ = true;
+  request_update();
+}
+
+void GaugeControl::set_stale(bool stale) {
+  if (face_->stale() == stale) return;
+  face_->set_stale(stale);
+  request_update();  // the readout text changes, so the update is visible
+}
+
+void GaugeControl::set_needle_smoothing(const NeedleSmoothing& s) {
+  smoothing_ = s;
+  if (!smoothing_.enabled && animating_) {
+    animating_ = false;
+    needle_velocity_ = 0.0;
+    anim_last_us_ = 0;
+    face_->set_needle_value(face_->value());
+    request_update();
+  }
+}
+
+void GaugeControl::set_title(std::string t) {
+  face_->set_title(std::move(t));
+  request_update();
+}
+
+void GaugeControl::set_unit(std::string u) {
+  face_->set_unit(std::move(u));
+  request_update();
+}
+
+void GaugeControl::set_major_labels(std::vector<std::string> labels) {
+  face_->set_major_labels(std::move(labels));
+  request_update();
+}
+
+void GaugeControl::set_zones(std::vector<Zone> z) {
+  face_->set_zones(std::move(z));
+  request_update();
+}
+
+void GaugeControl::set_zone_ramp(GaugeFace::ZoneRamp ramp) {
+  face_->set_zone_ramp(std::move(ramp));
+  request_update();
+}
+
+void GaugeControl::set_marks(std::span<const GaugeFace::Mark> marks) {
+  face_->set_marks(marks);
+  request_update();
+}
+
+void GaugeControl::apply_theme(const Theme& theme) {
+  face_->apply_theme(theme);
+  request_update();
+}
+
+void GaugeControl::set_shared_style(GaugeFace::SharedStyle s) {
+  face_->set_shared_style(std::move(s));
+  request_update();
+}
+
+void GaugeControl::set_dial_cache(std::shared_ptr<DialSurfaceCache> cache) {
+  face_->set_dial_cache(std::move(cache));
+  request_update();
+}
+
+void GaugeControl::invalidate_dial() {
+  face_->invalidate_dial();
+  request_update();
+}
+
+void GaugeControl::set_profiling(bool enabled) {
+  if (enabled == profiling()) return;
+  if (enabled) profiler_ = std::make_unique<RenderProfiler>();
+  else profiler_.reset();
+  face_->set_profiler(profiler_.get());
+  invalidate_dial();
+}
+
+void GaugeControl::request_update() {
+  if (update_tick_id_ != 0) return;
+  // Through the C API: a sigc slot (and a wrapped frame clock per tick)
+  // would allocate every time the gauge goes from idle to dirty.
+  update_tick_id_ = gtk_widget_add_tick_callback(host_.gobj(), &GaugeControl::update_tick_, this, nullptr);
+}
+
+gboolean GaugeControl::update_tick_(GtkWidget*, GdkFrameClock* clock, gpointer self) {
+  return static_cast<GaugeControl*>(self)->on_update_tick(gdk_frame_clock_get_frame_time(clock));
+}
+
+bool GaugeControl::on_update_tick(gint64 frame_time_us) {
+  if (animating_) animating_ = step_needle_(frame_time_us);
+  if (change_is_visible_()) queue_gauge_draw();
+
+  // Removing the callback once settled lets the frame clock stop when idle.
+  if (animating_) return true;
+  update_tick_id_ = 0;
+  return false;
+}
+
+double GaugeControl::tip_radius_() const {
+  return GaugeFace::radius_for(host_.get_width(), host_.get_height()) * GaugeFace::kNeedleLengthFrac;
+}
+
+double GaugeControl::pixels_between_(double a, double b) const {
+  return std::abs(std::remainder(face_->angle_for(face_->normalize_value(a)) -
+                                 face_->angle_for(face_->normalize_value(b)),
+                                 2.0 * std::numbers::pi)) * tip_radius_();
+}
+
+bool GaugeControl::step_needle_(gint64 frame_time_us) {
+  const double target = face_->value();
+  const double period = face_->wrap_period();
+
+  // Error from target, the short way round on wrap-around dials.
+  double e = face_->needle_value() - target;
+  if (period > 0.0) e = std::remainder(e, period);
+
+  // The first tick after a rest only establishes the time base.
+  const double dt = anim_last_us_ ? std::clamp((frame_time_us - anim_last_us_) / 1e6, 0.0, 0.1) : 0.0;
+  anim_last_us_ = frame_time_us;
+
+  // Exact critically damped step: e(t) = (e0 + (v0 + w*e0) t) exp(-w t).
+  const double w = 1.0 / std::max(1e-3, smoothing_.response_s);
+  const double decay = std::exp(-w * dt);
+  const double c = needle_velocity_ + w * e;
+  e = (e + c * dt) * decay;
+  needle_velocity_ = (needle_velocity_ - w * c * dt) * decay;
+
+  // Settle on screen-space error and on the travel still ahead (v/w).
+  const double err_px  = pixels_between_(target + e, target);
+  const double tail_px = pixels_between_(target + e + needle_velocity_ / w, target + e);
+
+  if (err_px < smoothing_.settle_px && tail_px < smoothing_.settle_px) {
+    face_->set_needle_value(target);
+    needle_velocity_ = 0.0;
+    anim_last_us_ = 0;
+    return false;
+  }
+
+  face_->set_needle_value(target + e);
+  return true;
+}
+
+bool GaugeControl::change_is_visible_() const {
+  if (!drawn_ || face_->dial_dirty() || face_->style_generation() != drawn_style_generation_) return true;
+  if (face_->readout_text() != drawn_readout_) return true;
+  if (marks_moved_()) return true;
+
+  const double d = std::remainder(face_->needle_angle_rad() - drawn_angle_, 2.0 * std::numbers::pi);
+  const double deg = std::abs(d) * 180.0 / std::numbers::pi;
+  const double tip_px = std::abs(d) * tip_radius_();
+
+  return deg >= deadband_.degrees && tip_px >= deadband_.pixels;
+}
+
+bool GaugeControl::marks_moved_() const {
+  const auto& marks = face_->marks();
+  if (marks.size() != drawn_marks_.size()) return true;
+
+  for (std::size_t i = 0; i < marks.size(); ++i) {
+    const auto& m = marks[i];
+    const auto& d = drawn_marks_[i];
+    if (m.kind != d.kind || m.color != d.color || m.size != d.size || m.z != d.z) return true;
+    if (pixels_between_(m.value, d.value) >= deadband_.pixels) return true;
+    if (m.kind == GaugeFace::Mark::Kind::range && pixels_between_(m.to_value, d.to_value) >= deadband_.pixels) return true;
+  }
+  return false;
+}
+
+void GaugeControl::note_drawn() {
+  drawn_ = true;
+  drawn_style_generation_ = face_->style_generation();
+  drawn_angle_ = face_->needle_angle_rad();
+  drawn_readout_ = face_->readout_text();
+  drawn_marks_.assign(face_->marks().begin(), face_->marks().end());
+}
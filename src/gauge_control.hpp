@@ -0,0 +1,142 @@
+#pragma once
+
+#include "gauge_face.hpp"
+
+#include <gtkmm.h>
+#include <memory>
+#include <span>
+#include <string>
+#include <vector>
+
+// Gauge API shared by the widget implementations (CircularGauge,
+// SnapshotGauge). It owns the GaugeFace and schedules redraws of the host
+// widget. Customize mapping/formatting by subclassing GaugeFace and passing
+// it to the widget's constructor.
+//
+// Setters never redraw directly. They schedule one evaluation on the next
+// frame-clock tick, which redraws only if the change is visible (dial
+// changed, readout text changed, or the needle moved past the deadband).
+// With no updates no tick callback is installed, so a steady gauge is idle.
+//
+// Optional needle smoothing runs a critically damped spring from the shown
+// needle position to value(). It integrates the closed-form solution over
+// the frame-clock delta, so motion is identical at 30, 60 or 144 Hz, and it
+// stops requesting frames once the needle settles.
+class GaugeControl {
+public:
+  using Zone  = GaugeFace::Zone;
+  using Style = GaugeFace::Style;
+  using Theme = GaugeFace::Theme;
+
+  // Needle motion below either threshold is not redrawn.
+  struct Deadband {
+    double pixels  = 0.5;  // needle tip travel
+    double degrees = 0.0;  // needle rotation
+  };
+
+  struct NeedleSmoothing {
+    bool enabled = false;
+    double response_s = 0.25;  // spring time constant (1/omega)
+    double settle_px  = 0.1;   // tip error and remaining travel to stop at
+  };
+
+  virtual ~GaugeControl();
+
+  GaugeControl(const GaugeControl&) = delete;
+  GaugeControl& operator=(const GaugeControl&) = delete;
+
+  // Model
+  void set_range(double min_v, double max_v);
+  void set_value(double v);
+  double value() const { return face_->value(); }
+  // Marks the value as out of date (see GaugeFace::set_stale).
+  void set_stale(bool stale);
+  bool stale() const { return face_->stale(); }
+
+  void set_title(std::string t);
+  void set_unit(std::string u);
+
+  // Labels
+  void set_major_labels(std::vector<std::string> labels);
+
+  // Zones
+  void set_zones(std::vector<Zone> z);
+  const std::vector<Zone>& zones() const { return face_->zones(); }
+  // Per-value colour band (see GaugeFace::ZoneRamp); empty removes it.
+  void set_zone_ramp(GaugeFace::ZoneRamp ramp);
+
+  // Marks; a change is redrawn once it moves past the needle deadband.
+  // Marks are never part of the dial, so updating them re-renders none.
+  void set_marks(std::span<const GaugeFace::Mark> marks);
+
+  // Theming
+  void apply_theme(const Theme& theme);
+  Style& style() { request_update(); return face_->style(); }
+  const Style& style() const { return face_->style(); }
+  void set_shared_style(GaugeFace::SharedStyle s);
+
+  // Shares dial rasters with other gauges (see GaugeFace::set_dial_cache).
+  void set_dial_cache(std::shared_ptr<DialSurfaceCache> cache);
+
+  void invalidate_dial();
+
+  // Render instrumentation (off by default). Enabling it re-renders the
+  // dial once so the dial phases are measured too.
+  void set_profiling(bool enabled);
+  bool profiling() const { return profiler_ != nullptr; }
+  // Null while profiling is off.
+  const RenderProfiler* profiler() const { return profiler_.get(); }
+  void reset_profiler() { if (profiler_) profiler_->reset(); }
+
+  // Update scheduling
+  void set_deadband(const Deadband& d) { deadband_ = d; }
+  const Deadband& deadband() const { return deadband_; }
+
+  void set_needle_smoothing(const NeedleSmoothing& s);
+  const NeedleSmoothing& needle_smoothing() const { return smoothing_; }
+
+  // Coalesces model changes onto the next frame-clock tick. Call after
+  // changing the face directly.
+  void request_update();
+
+  GaugeFace& face() { return *face_; }
+  const GaugeFace& face() const { return *face_; }
+
+protected:
+  GaugeControl(Gtk::Widget& host, std::unique_ptr<GaugeFace> face);
+
+  // Hosts call this after drawing so the next update can be diffed against it.
+  void note_drawn();
+
+  // Called on the update tick once a change is visible. Queues a draw of
+  // the host widget; hosts that render elsewhere first override it.
+  virtual void queue_gauge_draw() { host_.queue_draw(); }
+
+private:
+  static gboolean update_tick_(GtkWidget* widget, GdkFrameClock* clock, gpointer self);
+  bool on_update_tick(gint64 frame_time_us);
+  bool change_is_visible_() const;
+  bool marks_moved_() const;
+  bool step_needle_(gint64 frame_time_us);  // returns true while still moving
+  double tip_radius_() const;
+  double pixels_between_(double a, double b) const;  // needle-tip travel between values
+
+  Gtk::Widget& host_;
+  std::unique_ptr<GaugeFace> face_;
+  std::unique_ptr<RenderProfiler> profiler_;
+
+  Deadband deadband_;
+  guint update_tick_id_ = 0;
+
+  NeedleSmoothing smoothing_;
+  bool animating_ = false;
+  double needle_velocity_ = 0.0;  // value units per second
+  gint64 anim_last_us_ = 0;
+
+  // What the last draw put on screen.
+  bool drawn_ = false;
+  std::uint64_t drawn_style_generation_ = 0;
+  double drawn_angle_ = 0.0;
+  GaugeFace::Text drawn_readout_;
+  std::vector<GaugeFace::Mark> drawn_marks_;
+};
@@ -0,0 +1,74 @@
+#include "gauge_dashboard.hpp"
+
+#include <algorithm>
+#include <utility>
+
+GaugeDashboard::GaugeDashboard(int columns, bool share)
+: columns_(std::max(1, columns)),
+  share_(share),
+  dials_(share ? std::make_shared<DialSurfaceCache>() : nullptr) {
+  set_row_spacing(8);
+  set_column_spacing(8);
+  set_row_homogeneous(true);
+  set_column_homogeneous(true);
+}
+
+void GaugeDashboard::adopt_(Gtk::Widget& widget, GaugeControl& gauge) {
+  const int i = static_cast<int>(gauges_.size());
+  attach(widget, i % columns_, i / columns_);
+
+  widget.set_hexpand(true);
+  widget.set_vexpand(true);
+  if (cell_px_ > 0) widget.set_size_request(cell_px_, cell_px_);
+
+  gauges_.push_back(&gauge);
+  widgets_.push_back(&widget);
+
+  if (share_) {
+    share_style(gauge);
+    gauge.set_dial_cache(dials_);
+  }
+  if (raster_) {
+    if (auto* g = dynamic_cast<CircularGauge*>(&widget)) g->set_raster_pool(raster_);
+  }
+}
+
+void GaugeDashboard::share_style(GaugeControl& gauge) {
+  if (!share_) return;
+  gauge.set_shared_style(styles_.intern(std::as_const(gauge).style()));
+}
+
+void GaugeDashboard::apply_theme(const GaugeFace::Theme& theme) {
+  for (auto* g : gauges_) {
+    g->apply_theme(theme);
+    share_style(*g);
+  }
+  if (share_) {
+    // Dials of the old theme are unreferenced now; release them and their styles.
+    dials_->trim();
+    styles_.purge();
+  }
+}
+
+void GaugeDashboard::set_cell_size(int px) {
+  cell_px_ = std::max(0, px);
+  for (auto* w : widgets_) {
+    w->set_size_request(cell_px_ > 0 ? cell_px_ : -1, cell_px_ > 0 ? cell_px_ : -1);
+  }
+}
+
+void GaugeDashboard::set_raster_pool(std::shared_ptr<RasterPool> pool) {
+  raster_ = std::move(pool);
+  for (auto* w : widgets_) {
+    if (auto* g = dynamic_cast<CircularGauge*>(w)) g->set_raster_pool(raster_);
+  }
+}
+
+GaugeDashboard::Stats GaugeDashboard::stats() const {
+  Stats s;
+  s.gauges = gauges_.size();
+  s.styles = styles_.size();
+  if (dials_) s.dials = dials_->stats();
+  if (raster_) s.raster = raster_->stats();
+  return s;
+}
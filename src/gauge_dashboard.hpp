@@ -0,0 +1,73 @@
+#pragma once
+
+#include "circular_gauge.hpp"
+#include "dial_surface_cache.hpp"
+#include "raster_pool.hpp"
+#include "style_interner.hpp"
+
+#include <gtkmm.h>
+#include <cstddef>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// Grid of gauges sharing interned styles and one dial-surface cache.
+//
+// Every gauge added is pointed at the pooled instance of its style, and at
+// the dashboard's DialSurfaceCache, so gauges that differ only in value
+// render one dial between them. With sharing off each gauge keeps its own
+// style copy and dial raster, which is useful for comparing the two.
+class GaugeDashboard final : public Gtk::Grid {
+public:
+  struct Stats {
+    std::size_t gauges = 0;
+    std::size_t styles = 0;  // distinct interned styles
+    DialSurfaceCache::Stats dials;
+    RasterPool::Stats raster;
+  };
+
+  explicit GaugeDashboard(int columns = 8, bool share = true);
+
+  // Creates a managed gauge widget (CircularGauge, WindAngleGauge,
+  // SnapshotGauge, ...) in the next grid cell.
+  template <class Gauge = CircularGauge, class... Args>
+  Gauge& add_gauge(Args&&... args) {
+    auto* g = Gtk::make_managed<Gauge>(std::forward<Args>(args)...);
+    adopt_(*g, *g);
+    return *g;
+  }
+
+  // Themes every gauge; subclasses re-apply their geometry on top.
+  void apply_theme(const GaugeFace::Theme& theme);
+
+  // Re-pools a gauge's style after it was edited through style().
+  void share_style(GaugeControl& gauge);
+
+  // Minimum size of each cell; 0 leaves it to the gauges.
+  void set_cell_size(int px);
+
+  // Rasterizes every CircularGauge-based gauge, including ones added later,
+  // on `pool` (see CircularGauge::set_raster_pool()). Other gauges keep
+  // drawing on the UI thread. Null turns it off.
+  void set_raster_pool(std::shared_ptr<RasterPool> pool);
+
+  std::size_t size() const { return gauges_.size(); }
+  GaugeControl& gauge(std::size_t i) { return *gauges_[i]; }
+
+  Stats stats() const;
+
+private:
+  void adopt_(Gtk::Widget& widget, GaugeControl& gauge);
+
+  int columns_;
+  bool share_;
+  int cell_px_ = 0;
+
+  // Owned by the grid (managed widgets).
+  std::vector<GaugeControl*> gauges_;
+  std::vector<Gtk::Widget*> widgets_;
+
+  StyleInterner styles_;
+  std::shared_ptr<DialSurfaceCache> dials_;
+  std::shared_ptr<RasterPool> raster_;
+};
@@ -0,0 +1,815 @@
+#include "gauge_face.hpp"
+#include "dial_surface_cache.hpp"
+#include "startup_trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <initializer_list>
+#include <numbers>
+#include <string>
+#include <typeindex>
+#include <typeinfo>
+#include <utility>
+
+GaugeFace::GaugeFace() : style_(default_style_()) {}
+
+const GaugeFace::SharedStyle& GaugeFace::default_style_() {
+  static const SharedStyle style = std::make_shared<const Style>();
+  return style;
+}
+
+GaugeFace::Style& GaugeFace::style() {
+  if (!own_style_) {
+    auto copy = std::make_shared<Style>(*style_);
+    own_style_ = copy.get();
+    style_ = std::move(copy);
+  }
+  invalidate_dial();
+  tick_dirs_stale_ = true;
+  ++style_generation_;
+  return *own_style_;
+}
+
+GaugeFace::StyleDiff GaugeFace::diff_styles(const Style& a, const Style& b) {
+  StyleDiff d;
+  d.ticks = a.start_deg != b.start_deg || a.end_deg != b.end_deg ||
+            a.major_ticks != b.major_ticks || a.minor_ticks != b.minor_ticks;
+  d.geometry = d.ticks || a.ring_width_frac != b.ring_width_frac ||
+               a.tick_len_major_frac != b.tick_len_major_frac ||
+               a.tick_len_minor_frac != b.tick_len_minor_frac ||
+               a.label_radius_frac != b.label_radius_frac ||
+               a.zone_width_mul != b.zone_width_mul || a.zone_radius_mul != b.zone_radius_mul;
+  // Text colour, font and precision (tick labels, readout) are on both layers.
+  const bool both = a.text != b.text || a.font_family != b.font_family ||
+                    a.value_precision != b.value_precision;
+  d.dial = d.geometry || both || a.bg != b.bg || a.ring != b.ring || a.face != b.face ||
+           a.tick != b.tick || a.subtext != b.subtext;
+  // The sweep moves the needle and marks; the ring width sizes the bugs.
+  d.dynamic = d.ticks || both || a.ring_width_frac != b.ring_width_frac ||
+              a.needle != b.needle || a.hub != b.hub || a.value_radius_frac != b.value_radius_frac;
+  return d;
+}
+
+void GaugeFace::set_style(const Style& s) {
+  const StyleDiff d = diff_styles(*style_, s);
+  if (!d.any()) return;
+
+  if (own_style_) {
+    *own_style_ = s;
+  } else {
+    auto copy = std::make_shared<Style>(s);
+    own_style_ = copy.get();
+    style_ = std::move(copy);
+  }
+  if (d.ticks) tick_dirs_stale_ = true;
+  else if (d.geometry) layout_.width = 0;  // endpoints only
+  if (d.dial) invalidate_dial();
+  if (d.dynamic) ++style_generation_;
+}
+
+void GaugeFace::set_shared_style(SharedStyle style) {
+  if (!style || style == style_) return;
+  style_ = std::move(style);
+  own_style_ = nullptr;
+  invalidate_dial();
+  tick_dirs_stale_ = true;
+  ++style_generation_;
+}
+
+void GaugeFace::set_dial_cache(std::shared_ptr<DialSurfaceCache> cache) {
+  shared_dials_ = std::move(cache);
+  dial_cache_.reset();
+  invalidate_dial();
+}
+
+std::unique_ptr<GaugeFace> GaugeFace::create_mirror() const {
+  return std::make_unique<GaugeFace>();
+}
+
+void GaugeFace::mirror_to(GaugeFace& m) const {
+  if (m.min_v_ != min_v_ || m.max_v_ != max_v_) m.set_range(min_v_, max_v_);
+  // Shared styles are immutable, so the mirror can point at the same one.
+  if (const auto shared = shared_style()) {
+    if (m.shared_style() != shared) m.set_shared_style(shared);
+  } else {
+    m.set_style(style());  // no-op when equal
+  }
+  if (m.zones_ != zones_) m.set_zones(zones_);
+  m.set_zone_ramp(zone_ramp_);  // the same immutable instance; no-op when unchanged
+  if (m.marks_ != marks_) m.set_marks(marks_);
+  if (m.title_ != title_) m.set_title(title_);
+  if (m.unit_ != unit_) m.set_unit(unit_);
+  if (m.major_labels_override_ != major_labels_override_) m.set_major_labels(major_labels_override_);
+  m.set_value(value_);
+  m.set_needle_value(needle_value_);
+  m.set_stale(stale_);
+}
+
+void GaugeFace::set_range(double min_v, double max_v) {
+  min_v_ = min_v;
+  max_v_ = std::max(min_v + 1e-9, max_v);
+  value_ = std::clamp(value_, min_v_, max_v_);
+  needle_value_ = normalize_value(needle_value_);
+  invalidate_dial();
+}
+
+void GaugeFace::set_value(double v) {
+  value_ = std::clamp(v, min_v_, max_v_);
+  needle_value_ = value_;
+}
+
+double GaugeFace::normalize_value(double v) const {
+  const double period = wrap_period();
+  if (period <= 0.0) return std::clamp(v, min_v_, max_v_);
+
+  double w = std::fmod(v - min_v_, period);
+  if (w < 0.0) w += period;
+  return min_v_ + w;
+}
+
+void GaugeFace::set_title(std::string t) {
+  title_ = std::move(t);
+  invalidate_dial();
+}
+
+void GaugeFace::set_unit(std::string u) {
+  unit_ = std::move(u);
+  invalidate_dial();
+}
+
+void GaugeFace::set_major_labels(std::vector<std::string> labels) {
+  major_labels_override_ = std::move(labels);
+  invalidate_dial();
+}
+
+void GaugeFace::set_zones(std::vector<Zone> z) {
+  if (z == zones_) return;  // re-theming often sets the same zones
+  zones_ = std::move(z);
+  invalidate_dial();
+}
+
+void GaugeFace::set_zone_ramp(ZoneRamp ramp) {
+  if (ramp.empty() ? !zone_ramp_ : (zone_ramp_ && *zone_ramp_ == ramp)) return;
+  zone_ramp_ = ramp.empty() ? nullptr : std::make_shared<const ZoneRamp>(std::move(ramp));
+  invalidate_dial();
+}
+
+void GaugeFace::set_zone_ramp(SharedZoneRamp ramp) {
+  if (ramp && ramp->empty()) ramp.reset();
+  if (ramp == zone_ramp_) return;
+  zone_ramp_ = std::move(ramp);
+  invalidate_dial();
+}
+
+Gdk::RGBA GaugeFace::ZoneRamp::color_at(double v, double min_v, double max_v) const {
+  if (!buckets.empty()) {
+    const double t = (v - min_v) / (max_v - min_v);
+    const auto n = static_cast<std::ptrdiff_t>(buckets.size());
+    return buckets[static_cast<std::size_t>(std::clamp<std::ptrdiff_t>(
+        static_cast<std::ptrdiff_t>(std::floor(t * static_cast<double>(n))), 0, n - 1))];
+  }
+  if (stops.empty()) return Gdk::RGBA("transparent");
+
+  const auto hi = std::find_if(stops.begin(), stops.end(), [v](const Stop& s) { return s.value > v; });
+  if (hi == stops.begin()) return hi->color;
+  if (hi == stops.end()) return stops.back().color;
+  const auto lo = hi - 1;
+  const double t = (v - lo->value) / (hi->value - lo->value);
+  auto mix = [t](double a, double b) { return a + (b - a) * t; };
+  Gdk::RGBA c;
+  c.set_rgba(mix(lo->color.get_red(), hi->color.get_red()), mix(lo->color.get_green(), hi->color.get_green()),
+             mix(lo->color.get_blue(), hi->color.get_blue()), mix(lo->color.get_alpha(), hi->color.get_alpha()));
+  return c;
+}
+
+void GaugeFace::set_marks(std::span<const Mark> marks) {
+  marks_.assign(marks.begin(), marks.end());
+  const auto by_z = [](const Mark& a, const Mark& b) { return a.z < b.z; };
+  // Stable insertion sort: lists are short, and std::stable_sort may allocate.
+  for (auto it = marks_.begin(); it != marks_.end(); ++it) {
+    std::rotate(std::upper_bound(marks_.begin(), it, *it, by_z), it, it + 1);
+  }
+}
+
+void GaugeFace::apply_theme(const Theme& theme) {
+  set_style(theme.style);
+}
+
+void GaugeFace::set_source_rgba(const Cairo::RefPtr<Cairo::Context>& cr,
+                                const Gdk::RGBA& c,
+                                double alpha_mul) {
+  cr->set_source_rgba(c.get_red(), c.get_green(), c.get_blue(), c.get_alpha() * alpha_mul);
+}
+
+double GaugeFace::value_to_angle_rad(double v) const {
+  const double t = (v - min_v_) / (max_v_ - min_v_);
+  const double a0 = deg_to_rad(style_->start_deg);
+  const double a1 = deg_to_rad(style_->end_deg);
+  return a0 + t * (a1 - a0);
+}
+
+void GaugeFace::format_major_label(int major_index, double major_value, Text& out) const {
+  if (!major_labels_override_.empty()) {
+    if (major_index >= 0 && major_index < static_cast<int>(major_labels_override_.size())) {
+      out.assign(major_labels_override_[major_index]);
+      return;
+    }
+  }
+
+  const double p = style_->value_precision;
+  const double scale = std::pow(10.0, p);
+  const double rounded = std::round(major_value * scale) / scale;
+
+  if (p <= 0.0) out.append_int(std::llround(rounded));
+  else out.append_fixed(rounded, static_cast<int>(p));
+}
+
+void GaugeFace::format_value_readout(double v, Text& out) const {
+  out.append_fixed(v, static_cast<int>(std::max(0.0, style_->value_precision)));
+}
+
+static void cairo_arc_visual(const Cairo::RefPtr<Cairo::Context>& cr,
+                             double cx, double cy, double rad,
+                             double a0, double a1) {
+  // Cairo draws increasing angles with arc() and decreasing with arc_negative().
+  if (a1 >= a0) cr->arc(cx, cy, rad, a0, a1);
+  else         cr->arc_negative(cx, cy, rad, a0, a1);
+}
+
+void GaugeFace::draw_zone_arc(const Cairo::RefPtr<Cairo::Context>& cr, const GaugeLayout& layout,
+                              const Zone& zone) const {
+  const double v0 = std::clamp(zone.from_value, min_v_, max_v_);
+  const double v1 = std::clamp(zone.to_value,   min_v_, max_v_);
+
+  const double a0 = value_to_angle_rad(v0);
+  const double a1 = value_to_angle_rad(v1);
+
+  set_source_rgba(cr, zone.color, zone.alpha);
+  cr->set_line_width(std::max(1.0, layout.zone_width));
+  cr->set_line_cap(Cairo::Context::LineCap::BUTT);
+
+  cr->begin_new_path();
+  cairo_arc_visual(cr, layout.cx, layout.cy, layout.zone_radius, a0, a1);
+  cr->stroke();
+}
+
+const Cairo::RefPtr<Cairo::ImageSurface>& GaugeFace::zone_ramp_texture_(const GaugeLayout& l, int scale) const {
+  RampTexture& t = ramp_texture_;
+  const double band_width = std::max(1.0, l.zone_width);
+  if (t.surface && t.ramp == zone_ramp_ && t.min_v == min_v_ && t.max_v == max_v_ &&
+      t.start_deg == style_->start_deg && t.end_deg == style_->end_deg &&
+      t.radius == l.zone_radius && t.band_width == band_width &&
+      t.width == l.width && t.height == l.height && t.scale == scale) {
+    return t.surface;
+  }
+
+  const ZoneRamp& ramp = *zone_ramp_;
+  const double two_pi = 2.0 * std::numbers::pi;
+  const double cx = l.cx * scale;
+  const double cy = l.cy * scale;
+  const double r_in  = (l.zone_radius - band_width * 0.5) * scale;
+  const double r_out = (l.zone_radius + band_width * 0.5) * scale;
+
+  // Angle -> premultiplied colour, about one bin per device pixel along the
+  // outer edge. Filled by walking the range in steps finer than a bin, so any
+  // monotone value_to_angle_rad() works; bins outside the sweep stay clear.
+  struct Premul {
+    float a = 0.0f, r = 0.0f, g = 0.0f, b = 0.0f;
+  };
+  const int bins = std::max(360, static_cast<int>(std::ceil(two_pi * r_out)));
+  std::vector<Premul> lut(static_cast<std::size_t>(bins));
+  const int samples = bins * 4;
+  for (int i = 0; i <= samples; ++i) {
+    const double v = min_v_ + (max_v_ - min_v_) * i / samples;
+    const double a = std::remainder(value_to_angle_rad(v), two_pi);  // [-pi, pi], like atan2
+    const int bin = std::clamp(static_cast<int>((a + std::numbers::pi) / two_pi * bins), 0, bins - 1);
+    const Gdk::RGBA c = ramp.color_at(v, min_v_, max_v_);
+    const float alpha = static_cast<float>(std::clamp(c.get_alpha() * ramp.alpha, 0.0, 1.0) * 255.0);
+    lut[static_cast<std::size_t>(bin)] = {alpha, static_cast<float>(c.get_red()) * alpha,
+                                          static_cast<float>(c.get_green()) * alpha,
+                                          static_cast<float>(c.get_blue()) * alpha};
+  }
+
+  t.surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, l.width * scale, l.height * scale);
+  t.surface->set_device_scale(scale, scale);
+  t.surface->flush();
+  unsigned char* data = t.surface->get_data();
+  const int stride = t.surface->get_stride();
+  const int w = t.surface->get_width();
+  const int h = t.surface->get_height();
+
+  // Only pixels within half a pixel of the band are visited; the radial
+  // edges get coverage antialiasing.
+  const double reach_out = r_out + 0.5;
+  const double reach_in  = std::max(0.0, r_in - 0.5);
+  const int y0 = std::max(0, static_cast<int>(std::floor(cy - reach_out)));
+  const int y1 = std::min(h - 1, static_cast<int>(std::ceil(cy + reach_out)));
+  for (int y = y0; y <= y1; ++y) {
+    const double dy = y + 0.5 - cy;
+    if (std::abs(dy) > reach_out) continue;
+    const double half_out = std::sqrt(reach_out * reach_out - dy * dy);
+    const double half_in  = std::abs(dy) < reach_in ? std::sqrt(reach_in * reach_in - dy * dy) : 0.0;
+    auto* row = reinterpret_cast<std::uint32_t*>(data + static_cast<std::ptrdiff_t>(y) * stride);
+
+    const int x0 = std::max(0, static_cast<int>(std::floor(cx - half_out)));
+    const int x1 = std::min(w - 1, static_cast<int>(std::ceil(cx + half_out)));
+    for (int x = x0; x <= x1; ++x) {
+      const double dx = x + 0.5 - cx;
+      if (std::abs(dx) < half_in - 1.0) {
+        x = static_cast<int>(cx + half_in) - 1;  // jump over the hole
+        continue;
+      }
+      const double d = std::sqrt(dx * dx + dy * dy);
+      const double cover = std::clamp(d - r_in + 0.5, 0.0, 1.0) * std::clamp(r_out - d + 0.5, 0.0, 1.0);
+      if (cover <= 0.0) continue;
+
+      const int bin = std::min(bins - 1, static_cast<int>((std::atan2(dy, dx) + std::numbers::pi) / two_pi * bins));
+      const Premul& p = lut[static_cast<std::size_t>(bin)];
+      const auto k = static_cast<float>(cover);
+      row[x] = static_cast<std::uint32_t>(p.a * k + 0.5f) << 24 | static_cast<std::uint32_t>(p.r * k + 0.5f) << 16 |
+               static_cast<std::uint32_t>(p.g * k + 0.5f) << 8 | static_cast<std::uint32_t>(p.b * k + 0.5f);
+    }
+  }
+  t.surface->mark_dirty();
+
+  t.ramp = zone_ramp_;
+  t.min_v = min_v_;
+  t.max_v = max_v_;
+  t.start_deg = style_->start_deg;
+  t.end_deg = style_->end_deg;
+  t.radius = l.zone_radius;
+  t.band_width = band_width;
+  t.width = l.width;
+  t.height = l.height;
+  t.scale = scale;
+  return t.surface;
+}
+
+void GaugeFace::update_tick_dirs_() const {
+  const Style& st = *style_;
+  const int majors = std::max(2, st.major_ticks);
+  const int minors = std::max(0, st.minor_ticks);
+
+  const TickDirections fixed = fixed_ticks();
+  if (!fixed.empty() && fixed.major_ticks == majors && fixed.minor_ticks == minors &&
+      fixed.start_deg == st.start_deg && fixed.end_deg == st.end_deg) {
+    layout_.major_dirs.assign(fixed.majors.begin(), fixed.majors.end());
+    layout_.minor_dirs.assign(fixed.minors.begin(), fixed.minors.end());
+  } else {
+    const double a0 = deg_to_rad(st.start_deg);
+    const double a1 = deg_to_rad(st.end_deg);
+    auto dir = [&](double t) { return TickDir{std::cos(a0 + t * (a1 - a0)), std::sin(a0 + t * (a1 - a0))}; };
+
+    layout_.major_dirs.clear();
+    layout_.minor_dirs.clear();
+    for (int i = 0; i < majors; ++i) {
+      layout_.major_dirs.push_back(dir(static_cast<double>(i) / (majors - 1)));
+      if (i == majors - 1) break;
+      for (int m = 1; m <= minors; ++m) {
+        layout_.minor_dirs.push_back(dir((i + static_cast<double>(m) / (minors + 1.0)) / (majors - 1)));
+      }
+    }
+  }
+  tick_dirs_stale_ = false;
+  layout_.width = 0;  // endpoints must be rebuilt
+}
+
+const GaugeLayout& GaugeFace::layout(int width, int height) const {
+  if (tick_dirs_stale_) update_tick_dirs_();
+  if (layout_.width == width && layout_.height == height) return layout_;
+
+  const Style& st = *style_;
+  GaugeLayout& l = layout_;
+  l.width  = width;
+  l.height = height;
+  l.cx = width * 0.5;
+  l.cy = height * 0.5;
+  l.r  = radius_for(width, height);
+  l.ring_w = l.r * st.ring_width_frac;
+  l.ring_radius = l.r - l.ring_w * 0.5;
+
+  l.zone_radius = l.ring_radius * st.zone_radius_mul;
+  l.zone_width  = l.ring_w * st.zone_width_mul;
+
+  const double outer = l.r - l.ring_w * 0.65;
+  auto segments = [&](const std::vector<TickDir>& dirs, double len, std::vector<GaugeLayout::Segment>& out) {
+    out.resize(dirs.size());
+    for (std::size_t i = 0; i < dirs.size(); ++i) {
+      const TickDir d = dirs[i];
+      out[i].outer = {l.cx + d.cos * outer, l.cy + d.sin * outer};
+      out[i].inner = {l.cx + d.cos * (outer - len), l.cy + d.sin * (outer - len)};
+    }
+  };
+  segments(l.major_dirs, l.r * st.tick_len_major_frac, l.major_ticks);
+  segments(l.minor_dirs, l.r * st.tick_len_minor_frac, l.minor_ticks);
+  l.major_width = std::max(1.5, l.r * 0.012);
+  l.minor_width = std::max(1.0, l.r * 0.008);
+
+  const double lr = l.r * st.label_radius_frac;
+  l.label_anchors.resize(l.major_dirs.size());
+  for (std::size_t i = 0; i < l.major_dirs.size(); ++i) {
+    l.label_anchors[i] = {l.cx + l.major_dirs[i].cos * lr, l.cy + l.major_dirs[i].sin * lr};
+  }
+  l.label_size = std::max(10.0, l.r * 0.085);
+
+  l.text_size = std::max(10.0, l.r * 0.070);
+  l.title_baseline = l.cy - l.r * 0.18;
+  l.unit_baseline  = l.cy + l.r * 0.23;
+  return l;
+}
+
+Cairo::RefPtr<Cairo::ImageSurface> GaugeFace::render_dial_(int width, int height, int scale) const {
+  auto surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32,
+                                             width * scale, height * scale);
+  surface->set_device_scale(scale, scale);
+
+  auto dcr = Cairo::Context::create(surface);
+  draw_dial(dcr, width, height, scale);
+  surface->flush();
+  return surface;
+}
+
+DialKey GaugeFace::dial_key_(int width, int height, int scale) const {
+  // A private style may still be edited, so the key gets its own snapshot.
+  return DialKey{
+      std::type_index(typeid(*this)),
+      own_style_ ? std::make_shared<const Style>(*style_) : style_,
+      min_v_, max_v_,
+      zones_, zone_ramp_, major_labels_override_,
+      title_, unit_,
+      width, height, scale,
+  };
+}
+
+const Cairo::RefPtr<Cairo::ImageSurface>& GaugeFace::dial_surface(int width, int height, int scale) {
+  scale = std::max(1, scale);
+  if (dial_dirty_ || !dial_cache_ ||
+      width != dial_cache_width_ || height != dial_cache_height_ || scale != dial_cache_scale_) {
+    const std::int64_t t0 = startup_trace::enabled() ? startup_trace::now_us() : 0;
+    if (shared_dials_) {
+      dial_cache_ = shared_dials_->find_or_render(dial_key_(width, height, scale), [&] {
+        return render_dial_(width, height, scale);
+      });
+    } else {
+      dial_cache_ = render_dial_(width, height, scale);
+    }
+
+    dial_cache_width_  = width;
+    dial_cache_height_ = height;
+    dial_cache_scale_  = scale;
+    dial_dirty_ = false;
+    ++dial_generation_;
+    startup_trace::first("first dial", t0);
+  }
+  return dial_cache_;
+}
+
+void GaugeFace::draw(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height, int scale) {
+  if (width <= 0 || height <= 0) return;
+
+  const auto& dial = dial_surface(width, height, scale);
+  {
+    RenderProfiler::Scope timed(profiler_, RenderPhase::dial_blit);
+    cr->save();
+    cr->set_source(dial, 0.0, 0.0);
+    cr->paint();
+    cr->restore();
+  }
+
+  draw_dynamic(cr, width, height);
+}
+
+void GaugeFace::draw_dial(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height, int scale) const {
+  const GaugeLayout& l = layout(width, height);
+  const double two_pi = 2.0 * std::numbers::pi;
+
+  {
+    RenderProfiler::Scope timed(profiler_, RenderPhase::face);
+
+    // Background (transparent by default)
+    if (style_->bg.get_alpha() > 0.0) {
+      set_source_rgba(cr, style_->bg);
+      cr->rectangle(0, 0, width, height);
+      cr->fill();
+    }
+
+    set_source_rgba(cr, style_->face);
+    cr->arc(l.cx, l.cy, l.r, 0, two_pi);
+    cr->fill();
+  }
+
+  {
+    RenderProfiler::Scope timed(profiler_, RenderPhase::ring);
+    set_source_rgba(cr, style_->ring);
+    cr->set_line_width(l.ring_w);
+    cr->arc(l.cx, l.cy, l.ring_radius, 0, two_pi);
+    cr->stroke();
+  }
+
+  // Zones (over ring, under ticks/labels)
+  {
+    RenderProfiler::Scope timed(profiler_, RenderPhase::zones);
+    if (zone_ramp_) {
+      cr->save();
+      cr->set_source(zone_ramp_texture_(l, std::max(1, scale)), 0.0, 0.0);
+      cr->paint();
+      cr->restore();
+    }
+    for (const auto& z : zones_) {
+      draw_zone_arc(cr, l, z);
+    }
+  }
+
+  // Ticks: one path and one stroke per class.
+  {
+    RenderProfiler::Scope timed(profiler_, RenderPhase::ticks);
+    auto stroke_ticks = [&](const std::vector<GaugeLayout::Segment>& ticks, double lw, double alpha) {
+      if (ticks.empty()) return;
+      cr->begin_new_path();
+      for (const auto& t : ticks) {
+        cr->move_to(t.outer.x, t.outer.y);
+        cr->line_to(t.inner.x, t.inner.y);
+      }
+      set_source_rgba(cr, style_->tick, alpha);
+      cr->set_line_width(lw);
+      cr->set_line_cap(Cairo::Context::LineCap::ROUND);
+      cr->stroke();
+    };
+    stroke_ticks(l.minor_ticks, l.minor_width, 0.8);
+    stroke_ticks(l.major_ticks, l.major_width, 1.0);
+  }
+
+  // Major labels
+  {
+    RenderProfiler::Scope timed(profiler_, RenderPhase::labels);
+    cr->save();
+    set_source_rgba(cr, style_->text);
+    const int majors = static_cast<int>(l.label_anchors.size());
+    for (int i = 0; i < majors; ++i) {
+      const double t = static_cast<double>(i) / static_cast<double>(majors - 1);
+      Text label;
+      format_major_label(i, min_v_ + t * (max_v_ - min_v_), label);
+      if (label.empty()) continue;
+
+      const auto& shaped = text_.shape(label.view(), style_->font_family, GaugeTextCache::Weight::bold, l.label_size);
+      GaugeTextCache::show_centered(cr, shaped, l.label_anchors[i].x, l.label_anchors[i].y);
+    }
+    cr->restore();
+  }
+
+  // Title + unit
+  {
+    RenderProfiler::Scope timed(profiler_, RenderPhase::title_unit);
+    cr->save();
+    set_source_rgba(cr, style_->subtext);
+
+    if (!title_.empty()) {
+      const auto& shaped = text_.shape(title_, style_->font_family, GaugeTextCache::Weight::normal, l.text_size);
+      GaugeTextCache::show_on_baseline(cr, shaped, l.cx, l.title_baseline);
+    }
+
+    if (!unit_.empty()) {
+      const auto& shaped = text_.shape(unit_, style_->font_family, GaugeTextCache::Weight::normal, l.text_size);
+      GaugeTextCache::show_on_baseline(cr, shaped, l.cx, l.unit_baseline);
+    }
+    cr->restore();
+  }
+}
+
+void GaugeFace::draw_dynamic(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height) const {
+  draw_readout(cr, width, height);
+  draw_marks(cr, width, height, false);
+  if (!stale_) {
+    draw_needle(cr, width * 0.5, height * 0.5, radius_for(width, height), value_to_angle_rad(needle_value_));
+  } else {
+    // Dimmed as a whole, so the hub doesn't show through the needle.
+    cr->push_group();
+    draw_needle(cr, width * 0.5, height * 0.5, radius_for(width, height), value_to_angle_rad(needle_value_));
+    cr->pop_group_to_source();
+    cr->paint_with_alpha(kStaleAlpha);
+  }
+  draw_marks(cr, width, height, true);
+}
+
+void GaugeFace::draw_readout(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height) const {
+  const double cx = width * 0.5;
+  const double cy = height * 0.5;
+  const double r  = radius_for(width, height);
+  RenderProfiler::Scope timed(profiler_, RenderPhase::readout);
+
+  // Value readout (moved below center so the needle doesn't cover it)
+  cr->save();
+  set_source_rgba(cr, style_->text);
+
+  // Re-shaped only when the text (or size) differs from the last frame.
+  const auto& shaped = text_.shape_dynamic(0, readout_text().view(), style_->font_family,
+                                           GaugeTextCache::Weight::bold, std::max(14.0, r * 0.17));
+  GaugeTextCache::show_on_baseline(cr, shaped, cx, cy + r * style_->value_radius_frac);
+  cr->restore();
+}
+
+void GaugeFace::draw_marks(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height,
+                           bool over_needle) const {
+  // Sorted by z, so each side of the needle is one contiguous run.
+  const auto first = std::find_if(marks_.begin(), marks_.end(), [](const Mark& m) { return m.over_needle(); });
+  const auto begin = over_needle ? first : marks_.begin();
+  const auto end   = over_needle ? marks_.end() : first;
+  if (begin == end) return;
+  RenderProfiler::Scope timed(profiler_, RenderPhase::marks);
+
+  for (auto it = begin; it != end; ++it) draw_mark(cr, width, height, *it);
+}
+
+void GaugeFace::draw_mark(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height, const Mark& m) const {
+  const double cx = width * 0.5;
+  const double cy = height * 0.5;
+  const double r  = radius_for(width, height);
+  const double ring_w = r * style_->ring_width_frac;
+  const double two_pi = 2.0 * std::numbers::pi;
+
+  cr->save();
+  set_source_rgba(cr, m.color);
+
+  switch (m.kind) {
+    case Mark::Kind::range: {
+      double a0 = value_to_angle_rad(normalize_value(m.value));
+      double a1 = value_to_angle_rad(normalize_value(m.to_value));
+      // On wrap-around dials the range runs clockwise from value to to_value.
+      if (wrap_period() > 0.0 && a1 < a0) a1 += two_pi;
+
+      cr->set_line_width(std::max(2.0, r * 0.035) * m.size);
+      cr->set_line_cap(Cairo::Context::LineCap::ROUND);
+      cr->begin_new_path();
+      cairo_arc_visual(cr, cx, cy, r * 0.62, a0, a1);
+      cr->stroke();
+      break;
+    }
+    case Mark::Kind::needle: {
+      // Arrow-tipped line so it reads apart from the main needle it may cross.
+      const double a = value_to_angle_rad(normalize_value(m.value));
+      const double ux = std::cos(a), uy = std::sin(a);
+      const double len  = r * kNeedleLengthFrac * 0.92;
+      const double head = r * 0.08 * m.size;
+      const double half = r * 0.035 * m.size;
+
+      cr->set_line_width(std::max(1.5, r * 0.012) * m.size);
+      cr->set_line_cap(Cairo::Context::LineCap::ROUND);
+      cr->move_to(cx + ux * r * 0.12, cy + uy * r * 0.12);
+      cr->line_to(cx + ux * (len - head), cy + uy * (len - head));
+      cr->stroke();
+
+      cr->move_to(cx + ux * len, cy + uy * len);
+      cr->line_to(cx + ux * (len - head) - uy * half, cy + uy * (len - head) + ux * half);
+      cr->line_to(cx + ux * (len - head) + uy * half, cy + uy * (len - head) - ux * half);
+      cr->close_path();
+      cr->fill();
+      break;
+    }
+    case Mark::Kind::tick: {
+      // From the outer edge of the ring to past the major ticks, so it reads
+      // over both the ring and the scale.
+      const double a = value_to_angle_rad(normalize_value(m.value));
+      const double ux = std::cos(a), uy = std::sin(a);
+      const double outer = r;
+      const double inner = r - ring_w - r * style_->tick_len_major_frac;
+
+      cr->set_line_width(std::max(2.0, r * 0.025) * m.size);
+      cr->set_line_cap(Cairo::Context::LineCap::BUTT);
+      cr->move_to(cx + ux * inner, cy + uy * inner);
+      cr->line_to(cx + ux * outer, cy + uy * outer);
+      cr->stroke();
+      break;
+    }
+    case Mark::Kind::bug: {
+      // Triangle pointing at the center, base on the inner edge of the ring.
+      const double a = value_to_angle_rad(normalize_value(m.value));
+      const double base_r = r - ring_w;
+      const double tip_r  = base_r - r * 0.07 * m.size;
+      const double half   = r * 0.035 * m.size;
+      const double ux = std::cos(a), uy = std::sin(a);
+
+      cr->move_to(cx + ux * tip_r, cy + uy * tip_r);
+      cr->line_to(cx + ux * base_r - uy * half, cy + uy * base_r + ux * half);
+      cr->line_to(cx + ux * base_r + uy * half, cy + uy * base_r - ux * half);
+      cr->close_path();
+      cr->fill();
+      break;
+    }
+  }
+  cr->restore();
+}
+
+void GaugeFace::draw_needle(const Cairo::RefPtr<Cairo::Context>& cr,
+                            double cx, double cy, double r, double angle_rad) const {
+  RenderProfiler::Scope timed(profiler_, RenderPhase::needle);
+  const double two_pi = 2.0 * std::numbers::pi;
+  const double needle_r = r * kNeedleLengthFrac;
+  const double hub_r    = r * 0.10;
+
+  const double nx = cx + std::cos(angle_rad) * needle_r;
+  const double ny = cy + std::sin(angle_rad) * needle_r;
+
+  set_source_rgba(cr, style_->needle);
+  cr->set_line_width(std::max(2.0, r * 0.02));
+  cr->set_line_cap(Cairo::Context::LineCap::ROUND);
+  cr->move_to(cx, cy);
+  cr->line_to(nx, ny);
+  cr->stroke();
+
+  set_source_rgba(cr, style_->hub);
+  cr->arc(cx, cy, hub_r, 0, two_pi);
+  cr->fill();
+}
+
+// ---------------- Damage bounds ----------------
+// Must cover what draw_readout(), draw_marks() and draw_needle() paint.
+
+static GaugeFace::Box box_around(std::initializer_list<std::pair<double, double>> points, double pad) {
+  GaugeFace::Box b{1e300, 1e300, -1e300, -1e300};
+  for (const auto& [x, y] : points) {
+    b.x0 = std::min(b.x0, x);
+    b.y0 = std::min(b.y0, y);
+    b.x1 = std::max(b.x1, x);
+    b.y1 = std::max(b.y1, y);
+  }
+  pad += 1.0;  // antialiasing
+  return {b.x0 - pad, b.y0 - pad, b.x1 + pad, b.y1 + pad};
+}
+
+GaugeFace::Box GaugeFace::needle_bounds(int width, int height, double angle_rad) const {
+  const double cx = width * 0.5;
+  const double cy = height * 0.5;
+  const double r  = radius_for(width, height);
+  const double needle_r = r * kNeedleLengthFrac;
+  const double hub_r    = r * 0.10;
+  const double half_lw  = std::max(2.0, r * 0.02) * 0.5;
+
+  return box_around({{cx - hub_r, cy - hub_r},
+                     {cx + hub_r, cy + hub_r},
+                     {cx + std::cos(angle_rad) * needle_r, cy + std::sin(angle_rad) * needle_r}},
+                    half_lw);
+}
+
+GaugeFace::Box GaugeFace::readout_bounds(int width, int height) const {
+  const double cx = width * 0.5;
+  const double cy = height * 0.5;
+  const double r  = radius_for(width, height);
+
+  // Same slot and arguments as draw_readout(), so the shaping is shared with the next draw.
+  const auto& s = text_.shape_dynamic(0, readout_text().view(), style_->font_family,
+                                      GaugeTextCache::Weight::bold, std::max(14.0, r * 0.17));
+  if (s.ink_w <= 0.0 || s.ink_h <= 0.0) return {};
+  const double x = cx - s.ink_w * 0.5;
+  const double y = cy + r * style_->value_radius_frac - s.baseline + s.ink_y;
+  return box_around({{x, y}, {x + s.ink_w, y + s.ink_h}}, 0.0);
+}
+
+GaugeFace::Box GaugeFace::mark_bounds(int width, int height, const Mark& m) const {
+  const double cx = width * 0.5;
+  const double cy = height * 0.5;
+  const double r  = radius_for(width, height);
+  const double a  = value_to_angle_rad(normalize_value(m.value));
+  const double ux = std::cos(a), uy = std::sin(a);
+
+  switch (m.kind) {
+    case Mark::Kind::range: {
+      double a0 = a;
+      double a1 = value_to_angle_rad(normalize_value(m.to_value));
+      if (wrap_period() > 0.0 && a1 < a0) a1 += 2.0 * std::numbers::pi;
+      if (a1 < a0) std::swap(a0, a1);
+
+      // Arc end points plus every axis extreme the arc passes.
+      const double rad = r * 0.62;
+      const double pad = std::max(2.0, r * 0.035) * m.size * 0.5;
+      Box b = box_around({{cx + std::cos(a0) * rad, cy + std::sin(a0) * rad},
+                          {cx + std::cos(a1) * rad, cy + std::sin(a1) * rad}},
+                         pad);
+      const double quarter = std::numbers::pi * 0.5;
+      for (double q = std::ceil(a0 / quarter) * quarter; q <= a1; q += quarter) {
+        const Box e = box_around({{cx + std::cos(q) * rad, cy + std::sin(q) * rad}}, pad);
+        b = {std::min(b.x0, e.x0), std::min(b.y0, e.y0), std::max(b.x1, e.x1), std::max(b.y1, e.y1)};
+      }
+      return b;
+    }
+    case Mark::Kind::needle: {
+      const double len = r * kNeedleLengthFrac * 0.92;
+      return box_around({{cx + ux * r * 0.12, cy + uy * r * 0.12}, {cx + ux * len, cy + uy * len}},
+                        std::max(r * 0.035, std::max(1.5, r * 0.012) * 0.5) * m.size);
+    }
+    case Mark::Kind::tick: {
+      const double inner = r - r * style_->ring_width_frac - r * style_->tick_len_major_frac;
+      return box_around({{cx + ux * inner, cy + uy * inner}, {cx + ux * r, cy + uy * r}},
+                        std::max(2.0, r * 0.025) * m.size * 0.5);
+    }
+    case Mark::Kind::bug: {
+      const double base_r = r - r * style_->ring_width_frac;
+      const double tip_r  = base_r - r * 0.07 * m.size;
+      const double half   = r * 0.035 * m.size;
+      return box_around({{cx + ux * tip_r, cy + uy * tip_r},
+                         {cx + ux * base_r - uy * half, cy + uy * base_r + ux * half},
+                         {cx + ux * base_r + uy * half, cy + uy * base_r - ux * half}},
+                        0.0);
+    }
+  }
+  return {};
+}
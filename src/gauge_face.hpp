@@ -0,0 +1,384 @@
+#pragma once
+
+#include "fixed_text.hpp"
+#include "gauge_layout.hpp"
+#include "gauge_text.hpp"
+#include "render_profiler.hpp"
+
+#include <gdkmm/rgba.h>
+#include <cairomm/context.h>
+#include <cairomm/surface.h>
+#include <string>
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <numbers>
+#include <span>
+
+class DialSurfaceCache;
+struct DialKey;
+
+// Model + Cairo rendering of a circular gauge, independent of any widget.
+// CircularGauge wraps one of these in a Gtk::DrawingArea; headless tools
+// (e.g. gauge_bench) render it straight into image surfaces.
+class GaugeFace {
+public:
+  struct Zone {
+    double from_value = 0.0;  // in gauge units
+    double to_value   = 0.0;  // in gauge units
+    Gdk::RGBA color   = Gdk::RGBA("#00ff00");
+    double alpha      = 1.0;
+
+    bool operator==(const Zone&) const = default;
+  };
+
+  // Continuous colouring of the zone band, for what would take hundreds of
+  // zones: one colour per equal slice of [min, max] (e.g. VMG% per degree
+  // of wind angle), or a gradient through colour stops (e.g. an engine
+  // temperature ramp). Drawn under the discrete zones.
+  //
+  // The band is built per pixel from an angle lookup table into an annular
+  // texture that is baked into the dial, so frames cost the same as with a
+  // plain ring. The texture is rebuilt only when the ramp, range, size or
+  // band geometry changes.
+  struct ZoneRamp {
+    struct Stop {
+      double value = 0.0;
+      Gdk::RGBA color = Gdk::RGBA("#ffffff");
+
+      bool operator==(const Stop&) const = default;
+    };
+    // buckets[i] colours the i-th of buckets.size() equal slices of the range.
+    std::vector<Gdk::RGBA> buckets;
+    // Used when buckets is empty: sorted by value, interpolated in between
+    // and held beyond the ends.
+    std::vector<Stop> stops;
+    double alpha = 1.0;
+
+    bool empty() const { return buckets.empty() && stops.empty(); }
+    Gdk::RGBA color_at(double v, double min_v, double max_v) const;
+    bool operator==(const ZoneRamp&) const = default;
+  };
+  using SharedZoneRamp = std::shared_ptr<const ZoneRamp>;
+
+  struct Style {
+    // Scale sweep (degrees). Generic arc gauges map [min..max] onto [start..end].
+    double start_deg = -225.0;
+    double end_deg   =   45.0;
+
+    int major_ticks = 9;
+    int minor_ticks = 4;
+    double value_precision = 0.0;
+
+    // Geometry
+    double ring_width_frac = 0.10;
+    double tick_len_major_frac = 0.12;
+    double tick_len_minor_frac = 0.07;
+
+    double label_radius_frac = 0.74;
+
+    // Value readout vertical offset from center (in units of radius).
+    // Positive moves down.
+    double value_radius_frac = 0.22;
+
+    // Zone arc placement (relative to ring)
+    double zone_width_mul = 0.55;   // zone arc width relative to ring width
+    double zone_radius_mul = 0.88;  // zone arc radius relative to (r - ring_w*0.5)
+
+    // Colors
+    Gdk::RGBA bg      = Gdk::RGBA("transparent");
+    Gdk::RGBA ring    = Gdk::RGBA("#2a2f36");
+    Gdk::RGBA face    = Gdk::RGBA("#111419");
+    Gdk::RGBA tick    = Gdk::RGBA("#cfd6df");
+    Gdk::RGBA text    = Gdk::RGBA("#e6edf6");
+    Gdk::RGBA subtext = Gdk::RGBA("#a9b4c1");
+    Gdk::RGBA needle  = Gdk::RGBA("#ff4d4d");
+    Gdk::RGBA hub     = Gdk::RGBA("#e6edf6");
+
+    // Typography
+    std::string font_family = "Sans";
+
+    bool operator==(const Style&) const = default;
+  };
+
+  // Indicators drawn in the dynamic layer on top of the dial (e.g. rolling
+  // averages, min/max sectors, a true-wind needle, a target angle). Each
+  // has its own value, look and z-order; none of them is part of the dial
+  // raster, so changing one never re-renders it.
+  struct Mark {
+    enum class Kind {
+      bug,     // triangle at `value`, just inside the ring
+      range,   // arc from `value` to `to_value` inside the ticks (min/max sweep)
+      needle,  // secondary needle at `value`, thinner than the main one
+      tick,    // radial bar across the ring at `value`, longer than a major tick
+    };
+    Kind kind = Kind::bug;
+    double value = 0.0;
+    double to_value = 0.0;
+    Gdk::RGBA color = Gdk::RGBA("#ffffff");
+    double size = 1.0;  // line width / triangle size relative to the kind's default
+    // Drawing order, low to high; equal z keeps the order given. Marks with
+    // z > 0 are drawn over the main needle, the rest under it.
+    int z = 0;
+
+    bool over_needle() const { return z > 0; }
+    bool operator==(const Mark&) const = default;
+  };
+
+  // Immutable style shared between faces (see StyleInterner).
+  using SharedStyle = std::shared_ptr<const Style>;
+
+  struct Theme {
+    Style style;
+    double corner_radius = 0.0; // reserved
+  };
+
+  GaugeFace();
+  virtual ~GaugeFace() = default;
+
+  GaugeFace(const GaugeFace&) = delete;
+  GaugeFace& operator=(const GaugeFace&) = delete;
+
+  // Model
+  void set_range(double min_v, double max_v);
+  void set_value(double v);  // also snaps the needle to v
+  double value() const { return value_; }
+  double min_value() const { return min_v_; }
+  double max_value() const { return max_v_; }
+
+  // Displayed needle position; differs from value() while a needle animation runs.
+  void set_needle_value(double v) { needle_value_ = normalize_value(v); }
+  double needle_value() const { return needle_value_; }
+
+  // The value shown is out of date (e.g. its data channel went quiet): the
+  // readout shows "--" and the needle is dimmed to kStaleAlpha.
+  void set_stale(bool stale) { stale_ = stale; }
+  bool stale() const { return stale_; }
+  static constexpr double kStaleAlpha = 0.35;
+
+  // Non-zero for dials that wrap around (e.g. 360 for a full-circle angle dial);
+  // animations then take the shortest way round.
+  virtual double wrap_period() const { return 0.0; }
+  // Clamps v into range, or wraps it for wrap-around dials.
+  double normalize_value(double v) const;
+  double angle_for(double v) const { return value_to_angle_rad(v); }
+
+  void set_title(std::string t);
+  void set_unit(std::string u);
+
+  // Labels
+  void set_major_labels(std::vector<std::string> labels);
+
+  // Zones
+  void set_zones(std::vector<Zone> z);
+  const std::vector<Zone>& zones() const { return zones_; }
+
+  // An empty ramp removes it. An equal ramp changes nothing.
+  void set_zone_ramp(ZoneRamp ramp);
+  // Shares an immutable ramp (e.g. between mirrored faces); null removes it.
+  void set_zone_ramp(SharedZoneRamp ramp);
+  // Null when there is none.
+  const SharedZoneRamp& zone_ramp() const { return zone_ramp_; }
+
+  // Marks (replaces the whole set; storage is reused). marks() holds them
+  // in drawing order: sorted by z, stable.
+  void set_marks(std::span<const Mark> marks);
+  const std::vector<Mark>& marks() const { return marks_; }
+
+  // Which cached state a style change invalidates.
+  struct StyleDiff {
+    bool ticks    = false;  // sweep or tick counts: tick directions
+    bool geometry = false;  // ring, zone, tick or label proportions: layout
+    bool dial     = false;  // anything the dial raster shows
+    bool dynamic  = false;  // readout, marks or needle
+
+    bool any() const { return ticks || geometry || dial || dynamic; }
+  };
+  static StyleDiff diff_styles(const Style& a, const Style& b);
+
+  // Theming
+  virtual void apply_theme(const Theme& theme);
+  // Replaces the style, invalidating only what the difference touches: a
+  // needle colour re-renders no dial, a ring colour recomputes no layout.
+  // An equal style changes nothing.
+  void set_style(const Style& s);
+  // Mutable access may change dial geometry/colors, so it invalidates the
+  // cached dial. A shared style is copied first (copy-on-write).
+  Style& style();
+  const Style& style() const { return *style_; }
+  // Increments whenever the style may have changed in a way the dynamic
+  // layer shows, so hosts caching that layer know to rebuild it.
+  std::uint64_t style_generation() const { return style_generation_; }
+
+  // Faces start out sharing one default style; set_shared_style() points
+  // this face at another immutable instance, typically from StyleInterner.
+  void set_shared_style(SharedStyle style);
+  // The shared instance, or null while this face holds a private copy.
+  SharedStyle shared_style() const { return own_style_ ? nullptr : style_; }
+
+  // Dials with equal content are rendered once and shared through `cache`
+  // instead of each face keeping its own raster. Null restores a private
+  // dial. Subclasses whose dial depends on state beyond style, range,
+  // zones, labels, title and unit must not use a shared cache.
+  void set_dial_cache(std::shared_ptr<DialSurfaceCache> cache);
+  const std::shared_ptr<DialSurfaceCache>& dial_cache() const { return shared_dials_; }
+
+  // Mirrors draw this face's state somewhere else: at another size (frame
+  // output) or on another thread (raster pool). create_mirror() returns a
+  // fresh face of the same type; mirror_to() copies range, value, needle,
+  // stale flag, style, zones, ramp, marks, title, unit and labels into it,
+  // setting only what differs so the mirror keeps its dial when it can.
+  // Subclasses with hooks or state of their own override both.
+  virtual std::unique_ptr<GaugeFace> create_mirror() const;
+  virtual void mirror_to(GaugeFace& mirror) const;
+
+  // Per-phase timing of every draw into `p` (not owned); null disables it.
+  void set_profiler(RenderProfiler* p) { profiler_ = p; }
+  RenderProfiler* profiler() const { return profiler_; }
+
+  // Drops the cached dial layer; it is re-rendered on the next draw.
+  void invalidate_dial() {
+    dial_dirty_ = true;
+    dial_cache_.reset();  // lets a shared cache evict the stale raster
+  }
+  bool dial_dirty() const { return dial_dirty_; }
+
+  // Readout and tick label text. Formatted into a fixed buffer, so updates
+  // and draws don't allocate; longer text is cut off.
+  using Text = FixedText<31>;
+
+  // Dynamic-layer state, for callers deciding whether a redraw is visible.
+  double needle_angle_rad() const { return value_to_angle_rad(needle_value_); }
+  Text readout_text() const {
+    Text t;
+    if (stale_) t.assign("--");
+    else format_value_readout(value_, t);
+    return t;
+  }
+
+  // Boxes around parts of the dynamic layer in user units, padded for line
+  // caps and antialiasing: what a damage-tracking output must repaint when
+  // that part moves or changes.
+  struct Box {
+    double x0 = 0.0;
+    double y0 = 0.0;
+    double x1 = 0.0;
+    double y1 = 0.0;
+
+    bool empty() const { return x1 <= x0 || y1 <= y0; }
+  };
+  Box needle_bounds(int width, int height, double angle_rad) const;  // needle + hub
+  Box readout_bounds(int width, int height) const;                   // current readout text
+  Box mark_bounds(int width, int height, const Mark& m) const;
+
+  // Geometry shared by all layers.
+  static double radius_for(int width, int height) { return std::min(width, height) * 0.5 * 0.95; }
+  // Dial geometry for this style at this size; recomputed only when either changes.
+  const GaugeLayout& layout(int width, int height) const;
+  static constexpr double kNeedleLengthFrac = 0.72;  // needle length relative to radius
+
+  // Blits the cached dial (re-rendering it if stale for this size/scale) and
+  // draws the dynamic layer on top. `scale` is the device scale factor.
+  void draw(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height, int scale = 1);
+
+  // Static layer: background, face, ring, zones, ticks, labels, title, unit.
+  // `scale` sets the resolution of the zone ramp texture.
+  void draw_dial(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height, int scale = 1) const;
+  // Dynamic layer: value readout, marks under the needle, needle and hub,
+  // marks over the needle.
+  void draw_dynamic(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height) const;
+  void draw_readout(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height) const;
+  // The marks on one side of the main needle (see Mark::z).
+  void draw_marks(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height, bool over_needle = false) const;
+  void draw_mark(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height, const Mark& m) const;
+  // Needle + hub centered on (cx, cy) for a dial of radius r.
+  void draw_needle(const Cairo::RefPtr<Cairo::Context>& cr, double cx, double cy, double r,
+                   double angle_rad) const;
+
+  // Cached dial raster at device resolution, re-rendered if stale for this
+  // size/scale. dial_generation() increments on every re-render.
+  const Cairo::RefPtr<Cairo::ImageSurface>& dial_surface(int width, int height, int scale);
+  std::uint64_t dial_generation() const { return dial_generation_; }
+
+protected:
+  // Mapping + formatting hooks. The formatters write into `out`, which
+  // starts empty; an empty label is not drawn.
+  virtual double value_to_angle_rad(double v) const; // monotone mapping by default
+  virtual void format_major_label(int major_index, double major_value, Text& out) const;
+  virtual void format_value_readout(double v, Text& out) const;
+  // Compile-time tick directions for faces with a fixed sweep. Ignored
+  // unless they match the style's sweep and tick counts.
+  virtual TickDirections fixed_ticks() const { return {}; }
+
+  // Helpers
+  static double deg_to_rad(double d) { return d * std::numbers::pi / 180.0; }
+  static void set_source_rgba(const Cairo::RefPtr<Cairo::Context>& cr, const Gdk::RGBA& c, double alpha_mul = 1.0);
+
+  // drawing helpers for zones
+  void draw_zone_arc(const Cairo::RefPtr<Cairo::Context>& cr, const GaugeLayout& layout,
+                     const Zone& zone) const;
+
+  double min_v_ = 0.0;
+  double max_v_ = 100.0;
+  double value_ = 0.0;
+  double needle_value_ = 0.0;
+  bool stale_ = false;
+
+  std::string title_ = "Gauge";
+  std::string unit_  = "";
+
+  std::vector<std::string> major_labels_override_;
+  std::vector<Zone> zones_;
+  SharedZoneRamp zone_ramp_;
+  std::vector<Mark> marks_;
+
+  // Read through style(); never null. own_style_ is set while style_ is a
+  // private copy this face may mutate.
+  SharedStyle style_;
+  Style* own_style_ = nullptr;
+
+  // Shaped labels/readout; mutable because drawing is logically const.
+  mutable GaugeTextCache text_;
+
+  RenderProfiler* profiler_ = nullptr;
+
+private:
+  static const SharedStyle& default_style_();
+  Cairo::RefPtr<Cairo::ImageSurface> render_dial_(int width, int height, int scale) const;
+  void update_tick_dirs_() const;
+  DialKey dial_key_(int width, int height, int scale) const;
+  const Cairo::RefPtr<Cairo::ImageSurface>& zone_ramp_texture_(const GaugeLayout& l, int scale) const;
+
+  // Offscreen dial, rendered at device resolution and blitted every frame.
+  // Owned by this face, or shared with equal faces through shared_dials_.
+  std::shared_ptr<DialSurfaceCache> shared_dials_;
+  Cairo::RefPtr<Cairo::ImageSurface> dial_cache_;
+  int dial_cache_width_  = 0;
+  int dial_cache_height_ = 0;
+  int dial_cache_scale_  = 0;
+  bool dial_dirty_ = true;
+  std::uint64_t dial_generation_ = 0;
+  std::uint64_t style_generation_ = 0;
+
+  // Layout cache; tick directions go stale with the style, endpoints with the size.
+  mutable GaugeLayout layout_;
+  mutable bool tick_dirs_stale_ = true;
+
+  // Zone ramp texture and what it was built for.
+  struct RampTexture {
+    SharedZoneRamp ramp;
+    double min_v = 0.0;
+    double max_v = 0.0;
+    double start_deg = 0.0;
+    double end_deg = 0.0;
+    double radius = 0.0;
+    double band_width = 0.0;
+    int width = 0;
+    int height = 0;
+    int scale = 0;
+    Cairo::RefPtr<Cairo::ImageSurface> surface;
+  };
+  mutable RampTexture ramp_texture_;
+};
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <numbers>
+#include <span>
+#include <vector>
+
+// Unit vector of a tick/label direction in screen coordinates (y down).
+struct TickDir {
+  double cos = 1.0;
+  double sin = 0.0;
+};
+
+namespace gauge_layout_detail {
+
+// std::sin/std::cos are not constexpr in C++20; these are accurate to ~1e-14.
+constexpr double sin_rad(double x) {
+  constexpr double pi = std::numbers::pi;
+  const double turns = x / (2.0 * pi);
+  const auto k = static_cast<long long>(turns + (turns >= 0.0 ? 0.5 : -0.5));
+  x -= static_cast<double>(k) * 2.0 * pi;  // [-pi, pi]
+  if (x >  pi / 2) x =  pi - x;            // [-pi/2, pi/2]
+  if (x < -pi / 2) x = -pi - x;
+
+  double term = x;
+  double sum = x;
+  for (int n = 1; n <= 11; ++n) {
+    term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+    sum += term;
+  }
+  return sum;
+}
+
+constexpr double cos_rad(double x) { return sin_rad(x + std::numbers::pi / 2); }
+
+constexpr TickDir dir_deg(double deg) {
+  const double rad = deg * std::numbers::pi / 180.0;
+  return {cos_rad(rad), sin_rad(rad)};
+}
+
+} // namespace gauge_layout_detail
+
+// Tick directions for a dial whose sweep and tick counts never change,
+// built at compile time (see make_tick_table()).
+template <int Majors, int Minors>
+struct TickTable {
+  static_assert(Majors >= 2 && Minors >= 0);
+
+  double start_deg = 0.0;
+  double end_deg = 0.0;
+  std::array<TickDir, Majors> majors{};
+  std::array<TickDir, static_cast<std::size_t>((Majors - 1) * Minors)> minors{};
+};
+
+template <int Majors, int Minors>
+constexpr TickTable<Majors, Minors> make_tick_table(double start_deg, double end_deg) {
+  TickTable<Majors, Minors> t;
+  t.start_deg = start_deg;
+  t.end_deg = end_deg;
+
+  const double sweep = end_deg - start_deg;
+  std::size_t m = 0;
+  for (int i = 0; i < Majors; ++i) {
+    t.majors[i] = gauge_layout_detail::dir_deg(start_deg + sweep * i / (Majors - 1));
+    if (i == Majors - 1) break;
+    for (int j = 1; j <= Minors; ++j) {
+      const double frac = (i + static_cast<double>(j) / (Minors + 1)) / (Majors - 1);
+      t.minors[m++] = gauge_layout_detail::dir_deg(start_deg + sweep * frac);
+    }
+  }
+  return t;
+}
+
+// Non-owning view of a TickTable, as handed out by GaugeFace::fixed_ticks().
+struct TickDirections {
+  double start_deg = 0.0;
+  double end_deg = 0.0;
+  int major_ticks = 0;
+  int minor_ticks = 0;
+  std::span<const TickDir> majors;
+  std::span<const TickDir> minors;
+
+  TickDirections() = default;
+
+  template <int Majors, int Minors>
+  constexpr TickDirections(const TickTable<Majors, Minors>& t)  // NOLINT: implicit by design
+  : start_deg(t.start_deg), end_deg(t.end_deg), major_ticks(Majors), minor_ticks(Minors),
+    majors(t.majors), minors(t.minors) {}
+
+  bool empty() const { return majors.empty(); }
+};
+
+// Dial geometry for one style at one size, computed once and reused by
+// every dial render until the style or size changes. Tick directions are
+// kept separately from the scaled endpoints so a resize only rescales.
+struct GaugeLayout {
+  struct Point {
+    double x = 0.0;
+    double y = 0.0;
+  };
+  struct Segment {
+    Point outer;
+    Point inner;
+  };
+
+  int width = 0;
+  int height = 0;
+
+  double cx = 0.0;
+  double cy = 0.0;
+  double r = 0.0;
+  double ring_w = 0.0;
+  double ring_radius = 0.0;  // center line of the ring stroke
+
+  double zone_radius = 0.0;
+  double zone_width = 0.0;
+
+  // One path per tick class.
+  std::vector<Segment> major_ticks;
+  std::vector<Segment> minor_ticks;
+  double major_width = 0.0;
+  double minor_width = 0.0;
+
+  std::vector<Point> label_anchors;  // one per major tick
+  double label_size = 0.0;
+
+  double text_size = 0.0;      // title and unit
+  double title_baseline = 0.0;
+  double unit_baseline = 0.0;
+
+  // Unit directions, valid across sizes (runtime-computed or from a TickTable).
+  std::vector<TickDir> major_dirs;
+  std::vector<TickDir> minor_dirs;
+};
@@ -0,0 +1,306 @@
+// Headless batch export of wind gauge frames to PNG or raw RGBA.
+//
+// Frames come from a recorded instrument log (sampled at --fps) or, without
+// --log, from a synthetic sweep. The log is scanned once up front into a
+// list of frame states; rendering then runs on --jobs worker threads, each
+// with its own faces and its own GaugeRenderer surface.
+//
+// Usage:
+//   gauge_render [--log FILE [--fps N] [--from S] [--to S]] [--frames N]
+//                [--kind both|wind_angle|wind_speed] [--size PX] [--scale N]
+//                [--format png|rgba] [--out DIR|FILE|-] [--jobs N] [--bg COLOR]
+//
+// png writes DIR/frame_000000.png, ...; rgba writes every frame in order to
+// one file (or stdout with "-"), e.g. for
+//   gauge_render --log race.glog --fps 30 --format rgba --out - |
+//     ffmpeg -f rawvideo -pix_fmt rgba -s 512x256 -r 30 -i - race.mp4
+
+#include "gauge_renderer.hpp"
+#include "instrument_log.hpp"
+#include "log_replay.hpp"
+#include "true_wind.hpp"
+#include "wind_face.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+struct Options {
+  std::string log;
+  double fps = 10.0;
+  double from_s = 0.0;
+  double to_s = -1.0;   // negative: end of log
+  int frames = 0;       // limit (0: all); synthetic default 360
+  std::string kind = "both";
+  int size = 256;
+  int scale = 1;
+  std::string format = "png";
+  std::string out = "frames";
+  int jobs = 0;         // 0: hardware concurrency
+  std::string bg = "#0b0e12";
+};
+
+struct FrameState {
+  double awa_deg = 0.0;
+  double aws_kn = 0.0;
+  bool has_true_wind = false;
+  double twa_deg = 0.0;
+};
+
+void usage(const char* argv0) {
+  std::fprintf(stderr,
+               "usage: %s [--log FILE [--fps N] [--from S] [--to S]] [--frames N]\n"
+               "          [--kind both|wind_angle|wind_speed] [--size PX] [--scale N]\n"
+               "          [--format png|rgba] [--out DIR|FILE|-] [--jobs N] [--bg COLOR]\n",
+               argv0);
+}
+
+bool parse_args(int argc, char** argv, Options& o) {
+  for (int i = 1; i < argc; ++i) {
+    const std::string a = argv[i];
+    auto next = [&]() -> std::string {
+      if (i + 1 >= argc) return {};
+      return argv[++i];
+    };
+
+    if (a == "--log")         o.log    = next();
+    else if (a == "--fps")    o.fps    = std::clamp(std::atof(next().c_str()), 0.01, 1000.0);
+    else if (a == "--from")   o.from_s = std::max(0.0, std::atof(next().c_str()));
+    else if (a == "--to")     o.to_s   = std::atof(next().c_str());
+    else if (a == "--frames") o.frames = std::max(0, std::atoi(next().c_str()));
+    else if (a == "--kind")   o.kind   = next();
+    else if (a == "--size")   o.size   = std::clamp(std::atoi(next().c_str()), 16, 8192);
+    else if (a == "--scale")  o.scale  = std::clamp(std::atoi(next().c_str()), 1, 4);
+    else if (a == "--format") o.format = next();
+    else if (a == "--out")    o.out    = next();
+    else if (a == "--jobs")   o.jobs   = std::max(0, std::atoi(next().c_str()));
+    else if (a == "--bg")     o.bg     = next();
+    else return false;
+  }
+  return (o.kind == "both" || o.kind == "wind_angle" || o.kind == "wind_speed") &&
+         (o.format == "png" || o.format == "rgba") && !o.out.empty();
+}
+
+// Samples the log at the frame rate; channels are sample-and-hold.
+bool frames_from_log(const Options& o, std::vector<FrameState>& frames) {
+  LogReader log;
+  std::string err;
+  if (!log.open(o.log, &err)) {
+    std::fprintf(stderr, "%s\n", err.c_str());
+    return false;
+  }
+
+  const std::int64_t t0 = log.start_time_us() + static_cast<std::int64_t>(o.from_s * 1e6);
+  const std::int64_t t1 = o.to_s >= 0.0 ? log.start_time_us() + static_cast<std::int64_t>(o.to_s * 1e6)
+                                        : log.end_time_us();
+  const double step_us = 1e6 / o.fps;
+
+  WindSample s;
+  std::size_t next = 0;
+  for (std::int64_t k = 0;; ++k) {
+    const auto t = t0 + static_cast<std::int64_t>(std::llround(k * step_us));
+    if (t > t1 || (o.frames > 0 && frames.size() >= static_cast<std::size_t>(o.frames))) break;
+    for (; next < log.size() && log[next].time_us <= t; ++next) instlog::apply(log[next], s);
+    if (!s.has_wind()) continue;  // nothing to show yet
+
+    FrameState f{s.awa_deg, s.aws_kn};
+    if (s.has_boat()) {
+      f.has_true_wind = true;
+      f.twa_deg = true_wind_one(s.awa_deg, s.aws_kn, s.stw_kn, s.heading_deg, 0.0,
+                                s.has_ground, s.cog_deg, s.sog_kn).twa_deg;
+    }
+    frames.push_back(f);
+  }
+  return true;
+}
+
+void synthetic_frames(const Options& o, std::vector<FrameState>& frames) {
+  const int n = o.frames > 0 ? o.frames : 360;
+  for (int i = 0; i < n; ++i) {
+    const double t = i / o.fps;
+    frames.push_back({75.0 * std::sin(t * 0.35) + 25.0 * std::sin(t * 1.2),
+                      std::max(0.0, 14.0 + 6.0 * std::sin(t * 0.22) + 2.0 * std::sin(t * 1.8))});
+  }
+}
+
+// Same palette as the demo's dark theme.
+GaugeFace::Theme dark_theme() {
+  GaugeFace::Theme t;
+  t.style.face = Gdk::RGBA("#10151c");
+  t.style.ring = Gdk::RGBA("#27313b");
+  t.style.tick = Gdk::RGBA("#d7dee8");
+  t.style.text = Gdk::RGBA("#eef4ff");
+  t.style.subtext = Gdk::RGBA("#9fb0c3");
+  t.style.needle = Gdk::RGBA("#ff453a");
+  t.style.hub = Gdk::RGBA("#eef4ff");
+  return t;
+}
+
+// One per thread: faces (and their text caches) plus the target surface.
+class Worker {
+public:
+  explicit Worker(const Options& o)
+  : show_angle_(o.kind != "wind_speed"),
+    show_speed_(o.kind != "wind_angle"),
+    renderer_(o.size * ((show_angle_ && show_speed_) ? 2 : 1), o.size, o.scale),
+    bg_(o.bg),
+    size_(o.size) {
+    const auto theme = dark_theme();
+    angle_.apply_theme(theme);
+    speed_.apply_theme(theme);
+    angle_.set_zones({
+        {-60.0, -20.0, Gdk::RGBA("#ff3b30"), 1.0},
+        { 20.0,  60.0, Gdk::RGBA("#34c759"), 1.0},
+        {160.0, 180.0, Gdk::RGBA("#ff9f0a"), 1.0},
+        {-180.0, -160.0, Gdk::RGBA("#ff9f0a"), 1.0},
+    });
+  }
+
+  GaugeRenderer& render(const FrameState& f) {
+    angle_.set_angle_deg(f.awa_deg);
+    angle_.set_speed_kn(f.aws_kn);
+    speed_.set_speed_kn(f.aws_kn);
+
+    const GaugeFace::Mark twa{GaugeFace::Mark::Kind::needle, f.twa_deg, 0.0, Gdk::RGBA("#64d2ff")};
+    angle_.set_marks(f.has_true_wind ? std::span<const GaugeFace::Mark>(&twa, 1)
+                                     : std::span<const GaugeFace::Mark>());
+
+    renderer_.clear(bg_);
+    double x = 0.0;
+    if (show_angle_) { renderer_.draw(angle_, x, 0.0, size_, size_); x += size_; }
+    if (show_speed_) renderer_.draw(speed_, x, 0.0, size_, size_);
+    return renderer_;
+  }
+
+private:
+  bool show_angle_;
+  bool show_speed_;
+  WindAngleFace angle_;
+  WindSpeedFace speed_;
+  GaugeRenderer renderer_;
+  Gdk::RGBA bg_;
+  int size_;
+};
+
+// Hands raw frames to the output strictly in frame order; a worker that
+// finishes early waits (bounded by the number of workers).
+class OrderedWriter {
+public:
+  explicit OrderedWriter(std::FILE* f) : f_(f) {}
+
+  bool write(std::size_t index, const std::vector<std::uint8_t>& data) {
+    std::unique_lock lock(m_);
+    cv_.wait(lock, [&] { return next_ == index || failed_; });
+    if (!failed_ && std::fwrite(data.data(), 1, data.size(), f_) != data.size()) failed_ = true;
+    ++next_;
+    cv_.notify_all();
+    return !failed_;
+  }
+
+private:
+  std::FILE* f_;
+  std::mutex m_;
+  std::condition_variable cv_;
+  std::size_t next_ = 0;
+  bool failed_ = false;
+};
+
+} // namespace
+
+int main(int argc, char** argv) {
+  Options o;
+  if (!parse_args(argc, argv, o)) {
+    usage(argv[0]);
+    return 2;
+  }
+
+  std::vector<FrameState> frames;
+  if (!o.log.empty()) {
+    if (!frames_from_log(o, frames)) return 1;
+  } else {
+    synthetic_frames(o, frames);
+  }
+  if (frames.empty()) {
+    std::fprintf(stderr, "no frames to render\n");
+    return 1;
+  }
+
+  std::FILE* raw = nullptr;
+  if (o.format == "png") {
+    std::error_code ec;
+    std::filesystem::create_directories(o.out, ec);
+    if (ec) {
+      std::fprintf(stderr, "%s: %s\n", o.out.c_str(), ec.message().c_str());
+      return 1;
+    }
+  } else {
+    raw = (o.out == "-") ? stdout : std::fopen(o.out.c_str(), "wb");
+    if (!raw) {
+      std::perror(o.out.c_str());
+      return 1;
+    }
+  }
+
+  const unsigned hw = std::max(1u, std::thread::hardware_concurrency());
+  const unsigned jobs = std::min<unsigned>(o.jobs > 0 ? static_cast<unsigned>(o.jobs) : hw,
+                                           static_cast<unsigned>(frames.size()));
+
+  std::atomic<std::size_t> next{0};
+  std::atomic<bool> failed{false};
+  OrderedWriter writer(raw);
+
+  // Fontconfig/Pango load their configuration on first use; do that once
+  // here rather than racing in every worker.
+  {
+    Worker warm_up(o);
+    warm_up.render(frames.front());
+  }
+
+  const auto t0 = std::chrono::steady_clock::now();
+  auto work = [&] {
+    Worker worker(o);
+    std::vector<std::uint8_t> rgba;
+    char path[64];
+    for (std::size_t i = next++; i < frames.size() && !failed; i = next++) {
+      GaugeRenderer& r = worker.render(frames[i]);
+      if (raw) {
+        rgba.resize(r.rgba_size());
+        r.copy_rgba(rgba);
+        if (!writer.write(i, rgba)) failed = true;
+      } else {
+        std::snprintf(path, sizeof(path), "/frame_%06zu.png", i);
+        std::string err;
+        if (!r.write_png(o.out + path, &err)) {
+          std::fprintf(stderr, "%s\n", err.c_str());
+          failed = true;
+        }
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  for (unsigned j = 1; j < jobs; ++j) threads.emplace_back(work);
+  work();
+  for (auto& t : threads) t.join();
+
+  const double s = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+  if (raw && raw != stdout) std::fclose(raw);
+
+  const int w = o.size * (o.kind == "both" ? 2 : 1) * o.scale;
+  std::fprintf(stderr, "%zu frames (%dx%d) in %.2f s on %u threads: %.1f frames/s\n",
+               frames.size(), w, o.size * o.scale, s, jobs, frames.size() / std::max(s, 1e-9));
+  return failed ? 1 : 0;
+}
@@ -0,0 +1,74 @@
+#include "gauge_renderer.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <exception>
+
+GaugeRenderer::GaugeRenderer(int width, int height, int scale)
+: width_(std::max(1, width)), height_(std::max(1, height)), scale_(std::max(1, scale)) {
+  surface_ = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, width_ * scale_, height_ * scale_);
+  surface_->set_device_scale(scale_, scale_);
+  cr_ = Cairo::Context::create(surface_);
+}
+
+void GaugeRenderer::clear(const Gdk::RGBA& color) {
+  cr_->save();
+  cr_->set_operator(Cairo::Context::Operator::SOURCE);
+  cr_->set_source_rgba(color.get_red(), color.get_green(), color.get_blue(), color.get_alpha());
+  cr_->paint();
+  cr_->restore();
+}
+
+void GaugeRenderer::draw(GaugeFace& face, double x, double y, int w, int h) {
+  cr_->save();
+  cr_->translate(x, y);
+  face.draw(cr_, w, h, scale_);
+  cr_->restore();
+}
+
+bool GaugeRenderer::write_png(const std::string& path, std::string* error) const {
+  surface_->flush();
+  try {
+    surface_->write_to_png(path);
+  } catch (const std::exception& e) {
+    if (error) *error = path + ": " + e.what();
+    return false;
+  }
+  return true;
+}
+
+std::size_t GaugeRenderer::rgba_size() const {
+  return static_cast<std::size_t>(surface_->get_width()) * static_cast<std::size_t>(surface_->get_height()) * 4;
+}
+
+void GaugeRenderer::copy_rgba(std::span<std::uint8_t> out) const {
+  surface_->flush();
+  const int w = surface_->get_width();
+  const int h = surface_->get_height();
+  const int stride = surface_->get_stride();
+  const unsigned char* data = surface_->get_data();
+  if (out.size() < rgba_size()) return;
+
+  std::uint8_t* dst = out.data();
+  for (int y = 0; y < h; ++y) {
+    const unsigned char* row = data + static_cast<std::size_t>(y) * stride;
+    for (int x = 0; x < w; ++x) {
+      // ARGB32 is a native-endian uint32 with premultiplied color.
+      std::uint32_t p;
+      std::memcpy(&p, row + x * 4, sizeof(p));
+      const std::uint32_t a = p >> 24;
+      std::uint32_t r = (p >> 16) & 0xff;
+      std::uint32_t g = (p >> 8) & 0xff;
+      std::uint32_t b = p & 0xff;
+      if (a != 0 && a != 255) {
+        r = (r * 255 + a / 2) / a;
+        g = (g * 255 + a / 2) / a;
+        b = (b * 255 + a / 2) / a;
+      }
+      *dst++ = static_cast<std::uint8_t>(r);
+      *dst++ = static_cast<std::uint8_t>(g);
+      *dst++ = static_cast<std::uint8_t>(b);
+      *dst++ = static_cast<std::uint8_t>(a);
+    }
+  }
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "gauge_face.hpp"
+
+#include <cairomm/context.h>
+#include <cairomm/surface.h>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+
+// Headless rendering target for GaugeFace: one ARGB32 image surface and its
+// context, reused for every frame. Needs no display and no GTK widget.
+//
+// Not thread-safe. For parallel export give each thread its own renderer
+// and its own faces (a face's text cache belongs to the thread that draws
+// with it, as does Pango's default font map).
+class GaugeRenderer {
+public:
+  // Logical size; the surface is width*scale x height*scale device pixels.
+  GaugeRenderer(int width, int height, int scale = 1);
+
+  int width() const { return width_; }
+  int height() const { return height_; }
+  int scale() const { return scale_; }
+
+  // Fills the whole surface; a transparent color clears it.
+  void clear(const Gdk::RGBA& color = Gdk::RGBA("transparent"));
+
+  // Draws `face` into the logical rectangle (x, y, w, h).
+  void draw(GaugeFace& face, double x, double y, int w, int h);
+  void draw(GaugeFace& face) { draw(face, 0.0, 0.0, width_, height_); }
+
+  const Cairo::RefPtr<Cairo::ImageSurface>& surface() const { return surface_; }
+  const Cairo::RefPtr<Cairo::Context>& context() const { return cr_; }
+
+  bool write_png(const std::string& path, std::string* error = nullptr) const;
+
+  // Straight (non-premultiplied) RGBA8, tightly packed rows.
+  std::size_t rgba_size() const;
+  void copy_rgba(std::span<std::uint8_t> out) const;
+
+private:
+  int width_;
+  int height_;
+  int scale_;
+  Cairo::RefPtr<Cairo::ImageSurface> surface_;
+  Cairo::RefPtr<Cairo::Context> cr_;
+};
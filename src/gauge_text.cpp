@@ -0,0 +1,124 @@
+#include "gauge_text.hpp"
+
+#include <algorithm>
+
+GaugeTextCache::~GaugeTextCache() {
+  clear();
+  if (context_obj_) g_object_unref(context_obj_);
+}
+
+void GaugeTextCache::clear() {
+  for (auto& [key, s] : shaped_) {
+    if (s.layout) g_object_unref(s.layout);
+  }
+  shaped_.clear();
+
+  for (auto& d : dynamic_) {
+    if (d.shaped.layout) g_object_unref(d.shaped.layout);
+    d = DynamicSlot{};
+  }
+}
+
+PangoContext* GaugeTextCache::context_() {
+  if (!context_obj_) {
+    context_obj_ = pango_font_map_create_context(pango_cairo_font_map_get_default());
+
+    cairo_font_options_t* fo = cairo_font_options_create();
+    cairo_font_options_set_hint_metrics(fo, CAIRO_HINT_METRICS_OFF);
+    pango_cairo_context_set_font_options(context_obj_, fo);
+    cairo_font_options_destroy(fo);
+  }
+  return context_obj_;
+}
+
+void GaugeTextCache::warm_up(const std::string& family) {
+  PangoFontMap* map = pango_cairo_font_map_get_default();
+  PangoContext* ctx = pango_font_map_create_context(map);
+  PangoFontDescription* desc = pango_font_description_from_string(family.c_str());
+  if (PangoFont* font = pango_font_map_load_font(map, ctx, desc)) g_object_unref(font);
+  pango_font_description_free(desc);
+  g_object_unref(ctx);
+}
+
+void GaugeTextCache::layout_(Shaped& s, std::string_view text, const std::string& family,
+                             Weight weight, double size) {
+  if (!s.layout) s.layout = pango_layout_new(context_());
+
+  PangoFontDescription* desc = pango_font_description_new();
+  pango_font_description_set_family(desc, family.c_str());
+  pango_font_description_set_weight(desc, weight == Weight::bold ? PANGO_WEIGHT_BOLD : PANGO_WEIGHT_NORMAL);
+  pango_font_description_set_absolute_size(desc, size * PANGO_SCALE);
+  pango_layout_set_font_description(s.layout, desc);
+  pango_font_description_free(desc);
+
+  pango_layout_set_text(s.layout, text.data(), static_cast<int>(text.size()));
+
+  PangoRectangle ink;
+  pango_layout_get_extents(s.layout, &ink, nullptr);
+  s.ink_x = static_cast<double>(ink.x) / PANGO_SCALE;
+  s.ink_y = static_cast<double>(ink.y) / PANGO_SCALE;
+  s.ink_w = static_cast<double>(ink.width) / PANGO_SCALE;
+  s.ink_h = static_cast<double>(ink.height) / PANGO_SCALE;
+  s.baseline = static_cast<double>(pango_layout_get_baseline(s.layout)) / PANGO_SCALE;
+}
+
+void GaugeTextCache::bind_thread_() {
+  if (!context_obj_ || pango_context_get_font_map(context_obj_) == pango_cairo_font_map_get_default()) return;
+  clear();
+  g_object_unref(context_obj_);
+  context_obj_ = nullptr;
+}
+
+const GaugeTextCache::Shaped& GaugeTextCache::shape(std::string_view text, const std::string& family,
+                                                    Weight weight, double size) {
+  bind_thread_();
+  key_.clear();
+  key_.append(family);
+  key_.push_back('\x1f');
+  key_.push_back(weight == Weight::bold ? 'b' : 'n');
+  key_.append(reinterpret_cast<const char*>(&size), sizeof(size));
+  key_.push_back('\x1f');
+  key_.append(text);
+
+  if (auto it = shaped_.find(key_); it != shaped_.end()) return it->second;
+
+  if (shaped_.size() >= kMaxEntries) {
+    for (auto& [k, s] : shaped_) {
+      if (s.layout) g_object_unref(s.layout);
+    }
+    shaped_.clear();
+  }
+
+  Shaped& s = shaped_[key_];
+  layout_(s, text, family, weight, size);
+  return s;
+}
+
+const GaugeTextCache::Shaped& GaugeTextCache::shape_dynamic(int slot, std::string_view text,
+                                                            const std::string& family,
+                                                            Weight weight, double size) {
+  bind_thread_();
+  DynamicSlot& d = dynamic_[std::clamp(slot, 0, kDynamicSlots - 1)];
+  if (d.shaped.layout && d.text == text && d.family == family && d.weight == weight && d.size == size) {
+    return d.shaped;
+  }
+
+  d.text.assign(text);
+  d.family = family;
+  d.weight = weight;
+  d.size = size;
+  layout_(d.shaped, text, family, weight, size);
+  return d.shaped;
+}
+
+void GaugeTextCache::show_centered(const Cairo::RefPtr<Cairo::Context>& cr, const Shaped& s,
+                                   double x, double y) {
+  cr->move_to(x - (s.ink_x + s.ink_w * 0.5), y - (s.ink_y + s.ink_h * 0.5));
+  pango_cairo_show_layout(cr->cobj(), s.layout);
+}
+
+void GaugeTextCache::show_on_baseline(const Cairo::RefPtr<Cairo::Context>& cr, const Shaped& s,
+                                      double x, double y) {
+  cr->move_to(x - (s.ink_x + s.ink_w * 0.5), y - s.baseline);
+  pango_cairo_show_layout(cr->cobj(), s.layout);
+}
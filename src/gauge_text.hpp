@@ -0,0 +1,85 @@
+#pragma once
+
+#include <cairomm/context.h>
+#include <pango/pangocairo.h>
+
+#include <array>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+// Shaped-text cache for gauge labels and readouts (Pango).
+//
+// Static strings (labels, title, unit) are shaped once per
+// (text, family, weight, size) and kept with their extents. Frequently
+// changing strings (readouts) use a small set of reusable layouts that are
+// only re-shaped when their text or font actually changes.
+//
+// Layouts come from a private PangoContext with metric hinting off, so
+// extents don't depend on the target surface and can be reused across the
+// dial cache and the widget.
+//
+// PangoCairo's default font map is per thread and not thread-safe. The
+// context is bound to the font map of the thread shaping, and a cache that
+// moves to another thread (a face drawn by another raster worker) drops
+// its layouts and re-shapes there. Use one cache from one thread at a time.
+class GaugeTextCache {
+public:
+  enum class Weight { normal, bold };
+
+  struct Shaped {
+    PangoLayout* layout = nullptr;
+    // Ink box relative to the layout origin, in user units.
+    double ink_x = 0.0;
+    double ink_y = 0.0;
+    double ink_w = 0.0;
+    double ink_h = 0.0;
+    double baseline = 0.0;  // from the layout top
+  };
+
+  GaugeTextCache() = default;
+  ~GaugeTextCache();
+
+  GaugeTextCache(const GaugeTextCache&) = delete;
+  GaugeTextCache& operator=(const GaugeTextCache&) = delete;
+
+  const Shaped& shape(std::string_view text, const std::string& family, Weight weight, double size);
+
+  // `slot` picks one of kDynamicSlots reusable layouts.
+  const Shaped& shape_dynamic(int slot, std::string_view text, const std::string& family,
+                              Weight weight, double size);
+
+  // Ink box centered on (x, y): used for dial labels.
+  static void show_centered(const Cairo::RefPtr<Cairo::Context>& cr, const Shaped& s, double x, double y);
+  // Ink box centered horizontally on x, baseline at y: title, unit, readout.
+  static void show_on_baseline(const Cairo::RefPtr<Cairo::Context>& cr, const Shaped& s, double x, double y);
+
+  void clear();
+
+  // Loads `family` through the shared font map (fontconfig scan, font file
+  // open) so the first dial render doesn't pay for it. Idempotent.
+  static void warm_up(const std::string& family);
+
+  static constexpr int kDynamicSlots = 4;
+
+private:
+  struct DynamicSlot {
+    std::string text;
+    std::string family;
+    Weight weight = Weight::normal;
+    double size = 0.0;
+    Shaped shaped;
+  };
+
+  PangoContext* context_();
+  void bind_thread_();  // see the class comment
+  void layout_(Shaped& s, std::string_view text, const std::string& family, Weight weight, double size);
+
+  // Resizes create new keys; cap the map instead of growing without bound.
+  static constexpr std::size_t kMaxEntries = 256;
+
+  PangoContext* context_obj_ = nullptr;
+  std::unordered_map<std::string, Shaped> shaped_;
+  std::string key_;  // shape()'s lookup key, reused so a hit doesn't allocate
+  std::array<DynamicSlot, kDynamicSlots> dynamic_{};
+};
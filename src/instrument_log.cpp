@@ -0,0 +1,180 @@
+#include "instrument_log.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+std::int64_t steady_now_us() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+std::int64_t unix_now_us() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(system_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+namespace instlog {
+
+bool apply(const Record& r, WindSample& s) {
+  switch (static_cast<Channel>(r.channel)) {
+    case Channel::awa_deg:
+      s.awa_deg = r.value;
+      s.has_angle = true;
+      break;
+    case Channel::aws_kn:
+      s.aws_kn = r.value;
+      s.has_speed = true;
+      break;
+    case Channel::stw_kn:
+      s.stw_kn = r.value;
+      s.has_stw = true;
+      break;
+    case Channel::heading_deg:
+      s.heading_deg = r.value;
+      s.has_heading = true;
+      break;
+    // COG and SOG are logged as a pair (see record()); SOG completes it.
+    case Channel::cog_deg:
+      s.cog_deg = r.value;
+      break;
+    case Channel::sog_kn:
+      s.sog_kn = r.value;
+      s.has_ground = true;
+      break;
+    default:
+      return false;
+  }
+  s.time_us = r.time_us;
+  return true;
+}
+
+} // namespace instlog
+
+LogRecorder::LogRecorder(std::size_t ring_capacity)
+: ring_(std::bit_ceil(std::max<std::size_t>(ring_capacity, 2))),
+  mask_(ring_.size() - 1) {}
+
+LogRecorder::~LogRecorder() {
+  close();
+}
+
+bool LogRecorder::open(const std::string& path, std::string* error) {
+  close();
+
+  file_ = std::fopen(path.c_str(), "wb");
+  if (!file_) {
+    if (error) *error = path + ": " + std::strerror(errno);
+    return false;
+  }
+
+  instlog::FileHeader h{};
+  std::memcpy(h.magic, instlog::kMagic, sizeof(h.magic));
+  h.version       = instlog::kVersion;
+  h.record_size   = sizeof(instlog::Record);
+  h.start_unix_us = unix_now_us();
+  h.start_time_us = steady_now_us();
+  if (std::fwrite(&h, sizeof(h), 1, file_) != 1) {
+    if (error) *error = path + ": " + std::strerror(errno);
+    std::fclose(file_);
+    file_ = nullptr;
+    return false;
+  }
+
+  head_.store(0, std::memory_order_relaxed);
+  tail_.store(0, std::memory_order_relaxed);
+  written_.store(0, std::memory_order_relaxed);
+  dropped_.store(0, std::memory_order_relaxed);
+  last_time_us_ = 0;
+  stop_.store(false, std::memory_order_relaxed);
+  thread_ = std::thread([this] { run_(); });
+  return true;
+}
+
+void LogRecorder::close() {
+  if (!file_) return;
+  stop_.store(true, std::memory_order_relaxed);
+  if (thread_.joinable()) thread_.join();
+  std::fclose(file_);
+  file_ = nullptr;
+}
+
+bool LogRecorder::record(instlog::Channel channel, std::int64_t time_us, double value) {
+  if (!file_) return false;
+
+  const std::uint64_t head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) >= ring_.size()) {
+    dropped_.fetch_add(1, std::memory_order_relaxed);
+    return false;
+  }
+
+  ring_[head & mask_] = {time_us, static_cast<std::uint32_t>(channel), 0, value};
+  head_.store(head + 1, std::memory_order_release);
+  return true;
+}
+
+void LogRecorder::record(const WindSample& s) {
+  if (s.has_angle) record(instlog::Channel::awa_deg, s.time_us, s.awa_deg);
+  if (s.has_speed) record(instlog::Channel::aws_kn, s.time_us, s.aws_kn);
+  if (s.has_stw) record(instlog::Channel::stw_kn, s.time_us, s.stw_kn);
+  if (s.has_heading) record(instlog::Channel::heading_deg, s.time_us, s.heading_deg);
+  if (s.has_ground) {
+    record(instlog::Channel::cog_deg, s.time_us, s.cog_deg);
+    record(instlog::Channel::sog_kn, s.time_us, s.sog_kn);
+  }
+}
+
+LogRecorder::Stats LogRecorder::stats() const {
+  Stats s;
+  s.written = written_.load(std::memory_order_relaxed);
+  s.dropped = dropped_.load(std::memory_order_relaxed);
+  return s;
+}
+
+std::size_t LogRecorder::drain_(std::vector<instlog::Record>& batch) {
+  batch.clear();
+  const std::uint64_t tail = tail_.load(std::memory_order_relaxed);
+  const std::uint64_t head = head_.load(std::memory_order_acquire);
+
+  for (std::uint64_t i = tail; i != head; ++i) {
+    instlog::Record r = ring_[i & mask_];
+    // Sources may interleave slightly out of order; the file must not.
+    r.time_us = std::max(r.time_us, last_time_us_);
+    last_time_us_ = r.time_us;
+    batch.push_back(r);
+  }
+  tail_.store(head, std::memory_order_release);
+
+  if (!batch.empty()) {
+    const std::size_t n = std::fwrite(batch.data(), sizeof(instlog::Record), batch.size(), file_);
+    written_.fetch_add(n, std::memory_order_relaxed);
+  }
+  return batch.size();
+}
+
+void LogRecorder::run_() {
+  using namespace std::chrono_literals;
+
+  std::vector<instlog::Record> batch;
+  batch.reserve(ring_.size());
+
+  auto last_flush = std::chrono::steady_clock::now();
+  while (!stop_.load(std::memory_order_relaxed)) {
+    // Polling keeps record() free of any locking or wakeup syscalls.
+    if (drain_(batch) == 0) std::this_thread::sleep_for(20ms);
+
+    const auto now = std::chrono::steady_clock::now();
+    if (now - last_flush >= 1s) {
+      std::fflush(file_);
+      last_flush = now;
+    }
+  }
+  drain_(batch);
+  std::fflush(file_);
+}
@@ -0,0 +1,106 @@
+#pragma once
+
+#include "wind_sample.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Compact append-only binary log of timestamped instrument samples.
+//
+// Layout (native little-endian):
+//   FileHeader  64 bytes
+//   Record      24 bytes each, in non-decreasing time order
+//
+// Fixed-size records make the file directly indexable once mapped, and a
+// log cut short by a crash is still valid up to its last whole record.
+namespace instlog {
+
+inline constexpr char kMagic[8] = {'G', 'A', 'U', 'G', 'E', 'L', 'O', 'G'};
+inline constexpr std::uint32_t kVersion = 1;
+
+// Channel ids are stable on disk; add new ones at the end.
+enum class Channel : std::uint32_t {
+  awa_deg     = 1,  // apparent wind angle, -180..+180
+  aws_kn      = 2,  // apparent wind speed
+  stw_kn      = 3,  // speed through water
+  heading_deg = 4,  // true heading, 0..360
+  cog_deg     = 5,  // course over ground, true
+  sog_kn      = 6,  // speed over ground
+};
+
+struct FileHeader {
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t record_size;
+  std::int64_t start_unix_us;  // wall clock when recording started
+  std::int64_t start_time_us;  // sample clock (time_us) at the same moment
+  std::uint8_t reserved[32];
+};
+static_assert(sizeof(FileHeader) == 64);
+
+struct Record {
+  std::int64_t time_us;  // sample clock, as in WindSample::time_us
+  std::uint32_t channel;
+  std::uint32_t flags;   // reserved, 0
+  double value;
+};
+static_assert(sizeof(Record) == 24);
+
+// Folds a record into a WindSample; returns false for channels it doesn't carry.
+bool apply(const Record& r, WindSample& s);
+
+} // namespace instlog
+
+// Records samples to an instrument log without blocking the caller.
+//
+// record() copies into a fixed single-producer ring and returns; a writer
+// thread drains the ring to disk in batches. If the disk falls behind and
+// the ring fills, records are dropped and counted rather than stalling the
+// UI thread. record() must only be called from one thread.
+class LogRecorder {
+public:
+  struct Stats {
+    std::uint64_t written = 0;
+    std::uint64_t dropped = 0;
+  };
+
+  explicit LogRecorder(std::size_t ring_capacity = 1u << 16);
+  ~LogRecorder();
+
+  LogRecorder(const LogRecorder&) = delete;
+  LogRecorder& operator=(const LogRecorder&) = delete;
+
+  // Creates/truncates `path` and starts the writer thread.
+  bool open(const std::string& path, std::string* error = nullptr);
+  // Flushes everything queued and closes the file.
+  void close();
+  bool is_open() const { return file_ != nullptr; }
+
+  bool record(instlog::Channel channel, std::int64_t time_us, double value);
+  // Records the fields the sample carries.
+  void record(const WindSample& s);
+
+  Stats stats() const;
+
+private:
+  void run_();
+  std::size_t drain_(std::vector<instlog::Record>& batch);
+
+  std::vector<instlog::Record> ring_;
+  std::size_t mask_;
+  std::atomic<std::uint64_t> head_{0};  // producer
+  std::atomic<std::uint64_t> tail_{0};  // writer thread
+
+  std::FILE* file_ = nullptr;
+  std::thread thread_;
+  std::atomic<bool> stop_{false};
+  std::int64_t last_time_us_ = 0;  // writer thread; keeps the file time-ordered
+
+  std::atomic<std::uint64_t> written_{0};
+  std::atomic<std::uint64_t> dropped_{0};
+};
@@ -0,0 +1,118 @@
+#include "log_replay.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#if defined(_WIN32)
+#define GAUGES_LOG_MMAP 0
+#else
+#define GAUGES_LOG_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+LogReader::~LogReader() {
+  close();
+}
+
+void LogReader::close() {
+#if GAUGES_LOG_MMAP
+  if (map_base_) ::munmap(map_base_, map_size_);
+#endif
+  map_base_ = nullptr;
+  map_size_ = 0;
+  fallback_.clear();
+  records_ = nullptr;
+  count_ = 0;
+  index_.clear();
+}
+
+bool LogReader::open(const std::string& path, std::string* error) {
+  close();
+
+  auto fail = [&](const std::string& what) {
+    if (error) *error = path + ": " + what;
+    close();
+    return false;
+  };
+
+  const unsigned char* data = nullptr;
+  std::size_t size = 0;
+
+#if GAUGES_LOG_MMAP
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return fail(std::strerror(errno));
+
+  struct stat st{};
+  if (::fstat(fd, &st) != 0) {
+    const int e = errno;
+    ::close(fd);
+    return fail(std::strerror(e));
+  }
+  size = static_cast<std::size_t>(st.st_size);
+  if (size >= sizeof(instlog::FileHeader)) {
+    void* p = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+      const int e = errno;
+      ::close(fd);
+      return fail(std::strerror(e));
+    }
+    map_base_ = p;
+    map_size_ = size;
+    data = static_cast<const unsigned char*>(p);
+  }
+  ::close(fd);
+#else
+  std::FILE* f = std::fopen(path.c_str(), "rb");
+  if (!f) return fail(std::strerror(errno));
+
+  instlog::FileHeader h{};
+  if (std::fread(&h, sizeof(h), 1, f) == 1) {
+    instlog::Record r{};
+    while (std::fread(&r, sizeof(r), 1, f) == 1) fallback_.push_back(r);
+    size = sizeof(h) + fallback_.size() * sizeof(instlog::Record);
+    std::memcpy(&header_, &h, sizeof(h));
+  }
+  std::fclose(f);
+#endif
+
+  if (size < sizeof(instlog::FileHeader)) return fail("not an instrument log (too short)");
+
+#if GAUGES_LOG_MMAP
+  std::memcpy(&header_, data, sizeof(header_));
+#endif
+  if (std::memcmp(header_.magic, instlog::kMagic, sizeof(header_.magic)) != 0) {
+    return fail("not an instrument log (bad magic)");
+  }
+  if (header_.version != instlog::kVersion || header_.record_size != sizeof(instlog::Record)) {
+    return fail("unsupported log version " + std::to_string(header_.version));
+  }
+
+  // A trailing partial record (recorder killed mid-write) is ignored.
+  count_ = (size - sizeof(instlog::FileHeader)) / sizeof(instlog::Record);
+#if GAUGES_LOG_MMAP
+  records_ = reinterpret_cast<const instlog::Record*>(data + sizeof(instlog::FileHeader));
+#else
+  records_ = fallback_.data();
+#endif
+
+  index_.reserve(count_ / kIndexStride + 1);
+  for (std::size_t i = 0; i < count_; i += kIndexStride) index_.push_back(records_[i].time_us);
+  return true;
+}
+
+std::size_t LogReader::seek(std::int64_t time_us) const {
+  // Last indexed record before time_us; the answer lies within the next stride.
+  const auto it = std::lower_bound(index_.begin(), index_.end(), time_us);
+  if (it == index_.begin()) return 0;
+
+  const std::size_t block = static_cast<std::size_t>(it - index_.begin()) - 1;
+  const std::size_t lo = block * kIndexStride;
+  const std::size_t hi = std::min(count_, lo + kIndexStride + 1);
+  const auto* r = std::lower_bound(records_ + lo, records_ + hi, time_us,
+                                   [](const instlog::Record& rec, std::int64_t t) { return rec.time_us < t; });
+  return static_cast<std::size_t>(r - records_);
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "instrument_log.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Read-only view of an instrument log. The file is memory-mapped (read
+// into memory where mmap is unavailable), so opening a multi-day log costs
+// little more than building the seek index.
+//
+// The sparse index holds the timestamp of every kIndexStride-th record.
+// seek() binary-searches it, then the one stride of records it lands in,
+// so finding hour 37 is O(log n) and touches a handful of pages.
+class LogReader {
+public:
+  static constexpr std::size_t kIndexStride = 1024;
+
+  LogReader() = default;
+  ~LogReader();
+
+  LogReader(const LogReader&) = delete;
+  LogReader& operator=(const LogReader&) = delete;
+
+  bool open(const std::string& path, std::string* error = nullptr);
+  void close();
+
+  const instlog::FileHeader& header() const { return header_; }
+  std::size_t size() const { return count_; }
+  const instlog::Record& operator[](std::size_t i) const { return records_[i]; }
+
+  std::int64_t start_time_us() const { return count_ ? records_[0].time_us : 0; }
+  std::int64_t end_time_us() const { return count_ ? records_[count_ - 1].time_us : 0; }
+
+  // Index of the first record at or after time_us (size() if none).
+  std::size_t seek(std::int64_t time_us) const;
+
+private:
+  instlog::FileHeader header_{};
+  const instlog::Record* records_ = nullptr;
+  std::size_t count_ = 0;
+  std::vector<std::int64_t> index_;
+
+  // Mapping
+  void* map_base_ = nullptr;
+  std::size_t map_size_ = 0;
+  std::vector<instlog::Record> fallback_;
+};
+
+// Plays a log back at a multiple of real time, driven by the caller's
+// clock (e.g. the frame clock): each advance() emits the records that fall
+// into the elapsed interval. Speed 0 plays as fast as possible, bounded
+// only by max_records per call.
+class LogPlayer {
+public:
+  explicit LogPlayer(const LogReader& log) : log_(log), position_us_(log.start_time_us()) {}
+
+  void set_speed(double factor) { speed_ = std::max(0.0, factor); }
+  double speed() const { return speed_; }
+
+  // Positions playback at log time `time_us` (sample clock).
+  void seek(std::int64_t time_us) {
+    next_ = log_.seek(time_us);
+    position_us_ = time_us;
+  }
+  std::int64_t position_us() const { return position_us_; }
+  bool at_end() const { return next_ >= log_.size(); }
+
+  // Advances by dt_s seconds of caller time and calls fn(record) for each
+  // record passed. Returns false once the end of the log is reached.
+  template <class Fn>
+  bool advance(double dt_s, Fn&& fn, std::size_t max_records = 1u << 16) {
+    const bool asap = (speed_ == 0.0);
+    const std::int64_t until = position_us_ + static_cast<std::int64_t>(dt_s * speed_ * 1e6);
+
+    std::size_t n = 0;
+    while (next_ < log_.size() && n < max_records) {
+      const auto& r = log_[next_];
+      if (!asap && r.time_us > until) break;
+      fn(r);
+      position_us_ = r.time_us;
+      ++next_;
+      ++n;
+    }
+    if (!asap) position_us_ = std::max(position_us_, until);
+    return !at_end();
+  }
+
+private:
+  const LogReader& log_;
+  double speed_ = 1.0;
+  std::size_t next_ = 0;
+  std::int64_t position_us_ = 0;
+};
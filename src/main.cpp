@@ -1,36 +1,257 @@
+#include "channel_binder.hpp"
+#include "gauge_dashboard.hpp"
+#include "gauge_text.hpp"
+#include "instrument_log.hpp"
+#include "log_replay.hpp"
+#include "startup_trace.hpp"
+#include "theme_file.hpp"
 #include "wind_instrument.hpp"
 #include <gtkmm.h>
+#include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <optional>
 #include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if GAUGES_HAVE_NMEA_READER
+#include "nmea_reader.hpp"
+#endif
+#if GAUGES_HAVE_N2K_READER
+#include "n2k_reader.hpp"
+#endif
+#if GAUGES_HAVE_DIAL_DISK_CACHE
+#include "dial_disk_cache.hpp"
+#endif
+
+#if defined(__linux__)
+#include <unistd.h>
+#endif
+
+// Demo-specific command line options (stripped before GTK sees argv).
+struct DemoOptions {
+  std::vector<std::string> nmea_sources;  // --nmea SPEC (repeatable)
+  std::vector<std::string> n2k_interfaces;  // --n2k IFACE (repeatable), e.g. can0
+  WindInstrumentPanel::Backend backend = WindInstrumentPanel::Backend::cairo;  // --render-nodes
+  bool hud = false;             // --hud: render timing overlay
+  std::string shm_output;       // --shm NAME: mirror the gauges into a shared-memory frame ring
+  int shm_gauge_px = 240;       // --shm-size PX (per gauge)
+  int stress_gauges = 0;        // --stress N
+  bool stress_private = false;  // --stress-private: no shared styles/dials
+  bool stress_bus = false;      // --stress-bus: gauges pull from shared channels
+  int raster_threads = -1;      // --raster-threads N: stress gauges drawn by N workers (0: one per core)
+  int mirror_windows = 0;       // --mirror N: extra panels bound to the same channels
+  double bus_rate_hz = 0.0;     // --bus-rate HZ: per-gauge update limit (mirrors, stress bus)
+
+  std::string record_path;       // --record FILE
+  std::string replay_path;       // --replay FILE
+  std::string theme_path;        // --theme FILE: key-file theme, reloaded on change
+  std::optional<double> target_twa;  // --target-twa DEG: target angle markers
+  std::string polar_path;        // --polar FILE: boat speed gauge and targets from a polar table
+  double replay_speed = 1.0;     // --replay-speed X (0 or "max": as fast as possible)
+  double replay_from_s = 0.0;    // --replay-from SECONDS (from log start)
+
+  bool dial_disk_cache = true;   // --no-dial-cache: render every dial at startup
+  bool startup_trace = false;    // --startup-trace: print the cold-start timeline
+  std::int64_t app_start_us = 0; // when Gtk::Application was created (for the trace)
+};
+
+// Dials rendered by earlier runs, shared by every panel. Null when disabled
+// or unavailable.
+static std::shared_ptr<DialDiskCache> open_dial_disk_cache(const DemoOptions& opts) {
+#if GAUGES_HAVE_DIAL_DISK_CACHE
+  if (!opts.dial_disk_cache) return nullptr;
+  const std::int64_t t0 = startup_trace::now_us();
+  auto disk = std::make_shared<DialDiskCache>();
+  std::string err;
+  if (!disk->open(DialDiskCache::default_directory(), 32u << 20, &err)) {
+    std::cerr << "dial cache: " << err << "\n";
+    return nullptr;
+  }
+  startup_trace::phase("dial cache open", t0);
+  return disk;
+#else
+  (void)opts;
+  return nullptr;
+#endif
+}
+
+// Slightly more "LVGL default dark" than the library defaults.
+static GaugeFace::Theme dark_gauge_theme() {
+  GaugeFace::Theme t;
+  t.style.face = Gdk::RGBA("#10151c");
+  t.style.ring = Gdk::RGBA("#27313b");
+  t.style.tick = Gdk::RGBA("#d7dee8");
+  t.style.text = Gdk::RGBA("#eef4ff");
+  t.style.subtext = Gdk::RGBA("#9fb0c3");
+  t.style.needle = Gdk::RGBA("#ff453a");
+  t.style.hub = Gdk::RGBA("#eef4ff");
+  t.style.font_family = "Sans";
+  return t;
+}
+
+// Another view of the demo's wind channels, e.g. on a second display.
+class MirrorWindow final : public Gtk::Window {
+public:
+  MirrorWindow(ChannelBus& bus, const DemoOptions& opts, int index,
+               const std::shared_ptr<DialDiskCache>& dial_disk,
+               const std::shared_ptr<const PolarTable>& polar)
+  : panel_(opts.backend) {
+    set_title("Wind Instrument Mirror " + std::to_string(index));
+    set_default_size(480, 360);
+    set_child(panel_);
+    panel_.set_dial_disk_cache(dial_disk);
+    panel_.set_polar(polar);
+
+    SailTheme t;
+    t.gauge = dark_gauge_theme();
+    panel_.apply_theme(t);
+    panel_.bind_channels(bus, opts.bus_rate_hz);
+  }
+
+  void apply_theme(const SailTheme& t) { panel_.apply_theme(t); }
+
+private:
+  WindInstrumentPanel panel_;
+};
 
 class DemoWindow final : public Gtk::Window {
 public:
-  DemoWindow() {
+  explicit DemoWindow(const DemoOptions& opts)
+  : panel_(opts.backend) {
+    startup_trace::phase("gtk init", opts.app_start_us);
     set_title("Wind Instrument Demo (gtkmm)");
-    set_default_size(720, 380);
+    set_default_size(720, 540);
     set_child(panel_);
 
-    // Apply a slightly more "LVGL default dark" feel
     SailTheme t;
     t.panel_bg = Gdk::RGBA("#0b0e12");
-    t.gauge.style.face = Gdk::RGBA("#10151c");
-    t.gauge.style.ring = Gdk::RGBA("#27313b");
-    t.gauge.style.tick = Gdk::RGBA("#d7dee8");
-    t.gauge.style.text = Gdk::RGBA("#eef4ff");
-    t.gauge.style.subtext = Gdk::RGBA("#9fb0c3");
-    t.gauge.style.needle = Gdk::RGBA("#ff453a");
-    t.gauge.style.hub = Gdk::RGBA("#eef4ff");
-    t.gauge.style.font_family = "Sans";
+    t.gauge = dark_gauge_theme();
     panel_.apply_theme(t);
+    panel_.set_hud_visible(opts.hud);
+    panel_.set_target_twa(opts.target_twa);
+    if (!opts.polar_path.empty()) {
+      auto polar = std::make_shared<PolarTable>();
+      std::string err;
+      if (polar->load(opts.polar_path, &err)) {
+        polar_ = std::move(polar);
+        panel_.set_polar(polar_);
+      } else {
+        std::cerr << "polar: " << err << "\n";
+      }
+    }
+
+    // Font lookup otherwise lands inside the first dial render.
+    const std::int64_t fonts_t0 = startup_trace::now_us();
+    GaugeTextCache::warm_up(t.gauge.style.font_family);
+    startup_trace::phase("font setup", fonts_t0);
+
+    dial_disk_ = open_dial_disk_cache(opts);
+    panel_.set_dial_disk_cache(dial_disk_);
+    if (startup_trace::enabled()) {
+      signal_realize().connect([this] {
+        first_paint_ = get_frame_clock()->signal_after_paint().connect([this] {
+          first_paint_.disconnect();
+          startup_trace::report("first present");
+        });
+      });
+    }
+
+    // Sources publish to the channels; every panel pulls from them.
+    panel_.bind_channels(bus_);
+    for (int i = 0; i < opts.mirror_windows; ++i) {
+      mirrors_.push_back(std::make_unique<MirrorWindow>(bus_, opts, i + 1, dial_disk_, polar_));
+      mirrors_.back()->present();
+    }
+
+    if (!opts.theme_path.empty()) {
+      // Edits to the file (e.g. a night palette swapped in at dusk) apply live.
+      std::string err;
+      theme_watch_.set_error_handler([](const std::string& e) { std::cerr << "theme: " << e << "\n"; });
+      if (!theme_watch_.watch(opts.theme_path, t, [this](const SailTheme& th) {
+            panel_.apply_theme(th);
+            for (auto& m : mirrors_) m->apply_theme(th);
+          }, &err)) {
+        std::cerr << "theme: " << err << "\n";
+      }
+    }
+
+    if (!opts.shm_output.empty()) {
+#if GAUGES_HAVE_FRAME_RING
+      std::string err;
+      if (!panel_.set_frame_output(opts.shm_output, opts.shm_gauge_px, &err)) std::cerr << "shm: " << err << "\n";
+#else
+      std::cerr << "shm: shared-memory output is not supported on this platform\n";
+#endif
+    }
+
+    if (!opts.record_path.empty()) {
+      std::string err;
+      if (!recorder_.open(opts.record_path, &err)) std::cerr << "record: " << err << "\n";
+    }
+
+    if (!opts.replay_path.empty()) {
+      std::string err;
+      if (replay_log_.open(opts.replay_path, &err)) {
+        player_.emplace(replay_log_);
+        player_->set_speed(opts.replay_speed);
+        player_->seek(replay_log_.start_time_us() + static_cast<std::int64_t>(opts.replay_from_s * 1e6));
+        add_tick_callback(sigc::mem_fun(*this, &DemoWindow::on_replay_tick));
+        return;
+      }
+      std::cerr << "replay: " << err << "\n";
+    }
 
-    start_time_ = Glib::DateTime::create_now_local().to_unix();
-    Glib::signal_timeout().connect(sigc::mem_fun(*this, &DemoWindow::on_tick), 50);
+#if GAUGES_HAVE_NMEA_READER
+    for (const auto& spec : opts.nmea_sources) {
+      std::string err;
+      if (!nmea_.add_source(spec, &err)) std::cerr << "nmea: " << err << "\n";
+    }
+    // Woken by the reader only when data arrives; with steady or no data
+    // nothing runs. Gauge redraws are then batched onto the frame clock.
+    nmea_ready_.connect(sigc::mem_fun(*this, &DemoWindow::on_nmea_ready));
+    nmea_.set_notify([this] { nmea_ready_.emit(); });
+    bool live = !nmea_.empty() && nmea_.start();
+#else
+    if (!opts.nmea_sources.empty()) std::cerr << "nmea: live sources are not supported on this platform\n";
+    bool live = false;
+#endif
+
+#if GAUGES_HAVE_N2K_READER
+    for (const auto& iface : opts.n2k_interfaces) {
+      std::string err;
+      if (!n2k_.add_interface(iface, &err)) std::cerr << "n2k: " << err << "\n";
+    }
+    n2k_ready_.connect(sigc::mem_fun(*this, &DemoWindow::on_n2k_ready));
+    n2k_.set_notify([this] { n2k_ready_.emit(); });
+    if (!n2k_.empty() && n2k_.start()) live = true;
+#else
+    if (!opts.n2k_interfaces.empty()) std::cerr << "n2k: SocketCAN is only available on Linux\n";
+#endif
+    if (live) return;
+
+    // Synthetic signal, sampled once per frame.
+    add_tick_callback(sigc::mem_fun(*this, &DemoWindow::on_tick));
   }
 
 private:
-  bool on_tick() {
-    const auto now = Glib::DateTime::create_now_local();
-    const double t = (now.to_unix() - start_time_) + (now.get_microsecond() / 1e6);
+  // Declared before panel_: bound panels must be destroyed before the bus.
+  ChannelBus bus_;
+  WindChannels wind_channels_{bus_};
+  std::vector<std::unique_ptr<MirrorWindow>> mirrors_;
+
+  bool on_tick(const Glib::RefPtr<Gdk::FrameClock>& clock) {
+    const gint64 now_us = clock->get_frame_time();
+    if (start_time_us_ == 0) start_time_us_ = now_us;
+    const double t = (now_us - start_time_us_) / 1e6;
 
     // AWA in [-180,180]
     const double awa =  75.0 * std::sin(t * 0.35) + 25.0 * std::sin(t * 1.2);
@@ -40,19 +261,309 @@ private:
     speed_noise_ = 0.92 * speed_noise_ + 0.08 * dist_(rng_);
     const double aws = std::max(0.0, base + speed_noise_);
 
-    panel_.set_wind(awa, aws);
+    // Boat: slow course changes, speed following the breeze, a little current.
+    WindSample s{now_us, awa, aws, true, true};
+    s.stw_kn      = 4.0 + 0.2 * base;
+    s.heading_deg = std::fmod(220.0 + 15.0 * std::sin(t * 0.05) + 360.0, 360.0);
+    s.cog_deg     = std::fmod(s.heading_deg + 4.0 + 360.0, 360.0);
+    s.sog_kn      = s.stw_kn + 0.4;
+    s.has_stw = s.has_heading = s.has_ground = true;
+    show_wind_(s);
     return true;
   }
 
+  // Every record the frame interval covers is folded in; the panel sees the latest.
+  // Replay bypasses the channels: its samples carry log time, which would read as stale.
+  bool on_replay_tick(const Glib::RefPtr<Gdk::FrameClock>& clock) {
+    const gint64 now_us = clock->get_frame_time();
+    const double dt = last_frame_us_ ? (now_us - last_frame_us_) / 1e6 : 0.0;
+    last_frame_us_ = now_us;
+
+    bool changed = false;
+    const bool more = player_->advance(dt, [&](const instlog::Record& r) {
+      changed |= instlog::apply(r, replay_sample_);
+    });
+    if (changed && replay_sample_.has_wind()) panel_.set_sample(replay_sample_);
+    if (!more) std::cerr << "replay: end of log\n";
+    return more;
+  }
+
+  void show_wind_(const WindSample& s) {
+    if (recorder_.is_open()) recorder_.record(s);
+    wind_channels_.publish(s);
+  }
+
+#if GAUGES_HAVE_NMEA_READER
+  void on_nmea_ready() {
+    WindSample s;
+    if (nmea_.poll(s) && s.has_wind()) show_wind_(s);
+  }
+
+  Glib::Dispatcher nmea_ready_;
+  NmeaReader nmea_;
+#endif
+
+#if GAUGES_HAVE_N2K_READER
+  void on_n2k_ready() {
+    WindSample s;
+    if (n2k_.poll(s) && s.has_wind()) show_wind_(s);
+  }
+
+  Glib::Dispatcher n2k_ready_;
+  N2kReader n2k_;
+#endif
+
   WindInstrumentPanel panel_;
-  double start_time_ = 0.0;
+  gint64 start_time_us_ = 0;
 
   std::mt19937 rng_{12345};
   std::normal_distribution<double> dist_{0.0, 0.6};
   double speed_noise_ = 0.0;
+
+  LogRecorder recorder_;
+
+  LogReader replay_log_;
+  std::optional<LogPlayer> player_;
+  WindSample replay_sample_;
+  gint64 last_frame_us_ = 0;
+
+  ThemeFileWatcher theme_watch_;  // after panel_: its callback uses the panels
+
+  std::shared_ptr<DialDiskCache> dial_disk_;
+  std::shared_ptr<const PolarTable> polar_;
+  sigc::connection first_paint_;
+};
+
+// Dashboard stress test: N gauges of a few kinds, all updated every frame.
+// Prints frame time, RSS and style/dial sharing stats every two seconds.
+// With --stress-bus one value per kind is published to a channel per frame
+// and the gauges pull it through a ChannelBinder instead. With
+// --raster-threads the gauges are drawn by a RasterPool off the UI thread.
+class StressWindow final : public Gtk::Window {
+public:
+  explicit StressWindow(const DemoOptions& opts)
+  : dashboard_(static_cast<int>(std::ceil(std::sqrt(opts.stress_gauges * 1.6))),
+               !opts.stress_private) {
+    set_title("Gauge Dashboard Stress (" + std::to_string(opts.stress_gauges) + " gauges)");
+    set_default_size(1280, 800);
+
+    dashboard_.set_cell_size(96);
+    dashboard_.set_margin(8);
+    if (opts.raster_threads >= 0) {
+      dashboard_.set_raster_pool(std::make_shared<RasterPool>(static_cast<unsigned>(opts.raster_threads)));
+    }
+    if (opts.stress_bus) {
+      binder_.emplace(*this, bus_);
+      for (const auto name : kKindChannels) kind_channels_.push_back(&bus_.channel(name));
+    }
+    const auto theme = dark_gauge_theme();
+    for (int i = 0; i < opts.stress_gauges; ++i) add_gauge_(i, theme, opts.bus_rate_hz);
+
+    scroller_.set_child(dashboard_);
+    set_child(scroller_);
+
+    add_tick_callback(sigc::mem_fun(*this, &StressWindow::on_tick));
+  }
+
+private:
+  static constexpr std::array<std::string_view, 6> kKindChannels = {
+      "propulsion.main.temperature",       "tanks.fuel.0.currentLevel",
+      "electrical.batteries.house.voltage", "propulsion.main.oilPressure",
+      channels::kWindAngleApparent,        channels::kWindSpeedApparent,
+  };
+
+  // A few dashboard staples; gauges of one kind differ only in value.
+  void add_gauge_(int i, const GaugeFace::Theme& theme, double max_rate_hz) {
+    const int kind = i % 6;
+    GaugeControl* g = nullptr;
+    if (kind == 4)      g = &dashboard_.add_gauge<WindAngleGauge>();
+    else if (kind == 5) g = &dashboard_.add_gauge<WindSpeedGauge>();
+    else                g = &dashboard_.add_gauge();
+
+    g->apply_theme(theme);
+    switch (kind) {
+      case 0:
+        g->set_title("ENG TEMP");
+        g->set_unit("°C");
+        g->set_range(40.0, 120.0);
+        g->set_zones({{100.0, 120.0, Gdk::RGBA("#ff3b30"), 1.0}});
+        break;
+      case 1:
+        g->set_title("FUEL");
+        g->set_unit("%");
+        g->set_zones({{0.0, 15.0, Gdk::RGBA("#ff9f0a"), 1.0}});
+        break;
+      case 2:
+        g->set_title("BATT");
+        g->set_unit("V");
+        g->set_range(10.0, 15.0);
+        g->style().value_precision = 1;
+        g->set_zones({{10.0, 11.8, Gdk::RGBA("#ff3b30"), 1.0}, {11.8, 14.6, Gdk::RGBA("#34c759"), 1.0}});
+        break;
+      case 3:
+        g->set_title("OIL");
+        g->set_unit("bar");
+        g->set_range(0.0, 8.0);
+        {
+          // Pressure shaded continuously instead of in discrete zones.
+          GaugeFace::ZoneRamp ramp;
+          ramp.stops = {{0.0, Gdk::RGBA("#ff3b30")}, {1.5, Gdk::RGBA("#ff9f0a")}, {2.5, Gdk::RGBA("#34c759")},
+                        {6.0, Gdk::RGBA("#34c759")}, {8.0, Gdk::RGBA("#ff9f0a")}};
+          ramp.alpha = 0.9;
+          g->set_zone_ramp(std::move(ramp));
+        }
+        break;
+      default:
+        break;
+    }
+    // Theming and style edits gave the gauge a private style copy; pool it again.
+    dashboard_.share_style(*g);
+    if (binder_) binder_->bind(*g, kKindChannels[kind], max_rate_hz);
+  }
+
+  bool on_tick(const Glib::RefPtr<Gdk::FrameClock>& clock) {
+    const gint64 now_us = clock->get_frame_time();
+    if (start_us_ == 0) start_us_ = report_us_ = now_us;
+    const double t = (now_us - start_us_) / 1e6;
+
+    if (binder_) {
+      // One producer; the binder fans each value out to every gauge of its kind.
+      for (std::size_t k = 0; k < kind_channels_.size() && k < dashboard_.size(); ++k) {
+        const auto& f = dashboard_.gauge(k).face();
+        const double s = 0.5 + 0.5 * std::sin(t * (0.3 + 0.01 * k) + k * 0.7);
+        kind_channels_[k]->publish(f.min_value() + (f.max_value() - f.min_value()) * s, now_us);
+      }
+    } else {
+      for (std::size_t i = 0; i < dashboard_.size(); ++i) {
+        auto& g = dashboard_.gauge(i);
+        const double s = 0.5 + 0.5 * std::sin(t * (0.3 + 0.01 * (i % 37)) + i * 0.7);
+        const auto& f = g.face();
+        g.set_value(f.min_value() + (f.max_value() - f.min_value()) * s);
+      }
+    }
+
+    if (last_us_ != 0) {
+      const double ms = (now_us - last_us_) / 1e3;
+      frame_ms_sum_ += ms;
+      frame_ms_max_ = std::max(frame_ms_max_, ms);
+      ++frames_;
+    }
+    last_us_ = now_us;
+
+    if (now_us - report_us_ >= 2'000'000 && frames_ > 0) {
+      report_();
+      report_us_ = now_us;
+      frames_ = 0;
+      frame_ms_sum_ = frame_ms_max_ = 0.0;
+    }
+    return true;
+  }
+
+  void report_() const {
+    const auto st = dashboard_.stats();
+    const double mean = frame_ms_sum_ / frames_;
+    std::fprintf(stderr,
+                 "stress: gauges=%zu fps=%.1f frame_ms mean=%.2f max=%.2f rss=%.1fMiB "
+                 "styles=%zu dials=%zu (%.1fMiB) hits=%llu misses=%llu\n",
+                 st.gauges, 1000.0 / mean, mean, frame_ms_max_, resident_mib_(),
+                 st.styles, st.dials.entries, st.dials.bytes / 1048576.0,
+                 static_cast<unsigned long long>(st.dials.hits),
+                 static_cast<unsigned long long>(st.dials.misses));
+    if (st.raster.jobs > 0) {
+      std::fprintf(stderr, "stress: raster jobs=%llu steals=%llu (%.1f%%)\n",
+                   static_cast<unsigned long long>(st.raster.jobs),
+                   static_cast<unsigned long long>(st.raster.steals),
+                   100.0 * st.raster.steals / st.raster.jobs);
+    }
+  }
+
+  static double resident_mib_() {
+#if defined(__linux__)
+    std::ifstream statm("/proc/self/statm");
+    long size = 0, resident = 0;
+    if (statm >> size >> resident) return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / 1048576.0;
+#endif
+    return 0.0;
+  }
+
+  ChannelBus bus_;
+  std::vector<ChannelBus::Channel*> kind_channels_;
+
+  Gtk::ScrolledWindow scroller_;
+  GaugeDashboard dashboard_;
+  std::optional<ChannelBinder> binder_;  // --stress-bus; destroyed before the gauges it drives
+
+  gint64 start_us_ = 0;
+  gint64 last_us_ = 0;
+  gint64 report_us_ = 0;
+  int frames_ = 0;
+  double frame_ms_sum_ = 0.0;
+  double frame_ms_max_ = 0.0;
 };
 
 int main(int argc, char** argv) {
+  const std::int64_t t0_us = startup_trace::now_us();
+
+  // Pull out our own options; the rest goes to GTK.
+  DemoOptions opts;
+  std::vector<char*> gtk_argv;
+  for (int i = 0; i < argc; ++i) {
+    if (std::strcmp(argv[i], "--nmea") == 0 && i + 1 < argc) {
+      opts.nmea_sources.emplace_back(argv[++i]);
+    } else if (std::strcmp(argv[i], "--n2k") == 0 && i + 1 < argc) {
+      opts.n2k_interfaces.emplace_back(argv[++i]);
+    } else if (std::strcmp(argv[i], "--render-nodes") == 0) {
+      opts.backend = WindInstrumentPanel::Backend::render_nodes;
+    } else if (std::strcmp(argv[i], "--hud") == 0) {
+      opts.hud = true;
+    } else if (std::strcmp(argv[i], "--shm") == 0 && i + 1 < argc) {
+      opts.shm_output = argv[++i];
+    } else if (std::strcmp(argv[i], "--shm-size") == 0 && i + 1 < argc) {
+      opts.shm_gauge_px = std::max(16, std::atoi(argv[++i]));
+    } else if (std::strcmp(argv[i], "--stress") == 0 && i + 1 < argc) {
+      opts.stress_gauges = std::max(0, std::atoi(argv[++i]));
+    } else if (std::strcmp(argv[i], "--stress-private") == 0) {
+      opts.stress_private = true;
+    } else if (std::strcmp(argv[i], "--stress-bus") == 0) {
+      opts.stress_bus = true;
+    } else if (std::strcmp(argv[i], "--raster-threads") == 0 && i + 1 < argc) {
+      opts.raster_threads = std::clamp(std::atoi(argv[++i]), 0, 64);
+    } else if (std::strcmp(argv[i], "--mirror") == 0 && i + 1 < argc) {
+      opts.mirror_windows = std::clamp(std::atoi(argv[++i]), 0, 16);
+    } else if (std::strcmp(argv[i], "--bus-rate") == 0 && i + 1 < argc) {
+      opts.bus_rate_hz = std::max(0.0, std::atof(argv[++i]));
+    } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+      opts.record_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+      opts.replay_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--theme") == 0 && i + 1 < argc) {
+      opts.theme_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--target-twa") == 0 && i + 1 < argc) {
+      opts.target_twa = std::clamp(std::atof(argv[++i]), 0.0, 180.0);
+    } else if (std::strcmp(argv[i], "--polar") == 0 && i + 1 < argc) {
+      opts.polar_path = argv[++i];
+    } else if (std::strcmp(argv[i], "--no-dial-cache") == 0) {
+      opts.dial_disk_cache = false;
+    } else if (std::strcmp(argv[i], "--startup-trace") == 0) {
+      opts.startup_trace = true;
+    } else if (std::strcmp(argv[i], "--replay-speed") == 0 && i + 1 < argc) {
+      const char* v = argv[++i];
+      opts.replay_speed = (std::strcmp(v, "max") == 0) ? 0.0 : std::clamp(std::atof(v), 0.0, 1000.0);
+    } else if (std::strcmp(argv[i], "--replay-from") == 0 && i + 1 < argc) {
+      opts.replay_from_s = std::max(0.0, std::atof(argv[++i]));
+    } else {
+      gtk_argv.push_back(argv[i]);
+    }
+  }
+  gtk_argv.push_back(nullptr);
+
+  if (opts.startup_trace) startup_trace::start(t0_us);
+  opts.app_start_us = startup_trace::now_us();
   auto app = Gtk::Application::create("com.example.gtk.gauges.winddemo");
-  return app->make_window_and_run<DemoWindow>(argc, argv);
+  if (opts.stress_gauges > 0) {
+    return app->make_window_and_run<StressWindow>(static_cast<int>(gtk_argv.size()) - 1,
+                                                  gtk_argv.data(), opts);
+  }
+  return app->make_window_and_run<DemoWindow>(static_cast<int>(gtk_argv.size()) - 1,
+                                              gtk_argv.data(), opts);
 }
@@ -0,0 +1,88 @@
+#include "minmax_pyramid.hpp"
+
+#include <algorithm>
+
+MinMaxPyramid::MinMaxPyramid(std::int64_t base_period_us, std::int64_t span_us)
+: span_us_(std::max<std::int64_t>(span_us, 1)) {
+  // Coarser levels until a level has only a few hundred buckets left.
+  std::int64_t period = std::max<std::int64_t>(base_period_us, 1);
+  for (;;) {
+    Level l;
+    l.period_us = period;
+    l.ring.resize(static_cast<std::size_t>(span_us_ / period + 2));
+    const bool last = l.ring.size() <= 256;
+    levels_.push_back(std::move(l));
+    if (last) break;
+    period *= kFanout;
+  }
+}
+
+void MinMaxPyramid::clear() {
+  for (auto& l : levels_) {
+    std::fill(l.ring.begin(), l.ring.end(), Bucket{});
+    l.head = -1;
+  }
+  latest_us_ = -1;
+}
+
+void MinMaxPyramid::push_level_(Level& l, std::int64_t time_us, float v) {
+  const std::int64_t b = time_us / l.period_us;
+  const auto cap = static_cast<std::int64_t>(l.ring.size());
+
+  if (b > l.head) {
+    // Buckets skipped since the newest one get cleared (at most one lap).
+    const std::int64_t from = std::max(l.head + 1, b - cap + 1);
+    for (std::int64_t i = from; i <= b; ++i) l.ring[static_cast<std::size_t>(i % cap)] = Bucket{};
+    l.head = b;
+  } else if (b <= l.head - cap) {
+    return;  // already fell out of the ring
+  }
+  l.ring[static_cast<std::size_t>(b % cap)].add(v);
+}
+
+void MinMaxPyramid::push(std::int64_t time_us, double value) {
+  if (time_us < 0) return;
+  if (latest_us_ >= 0 && time_us < latest_us_ - span_us_) return;
+
+  const float v = static_cast<float>(value);
+  for (auto& l : levels_) push_level_(l, time_us, v);
+  latest_us_ = std::max(latest_us_, time_us);
+}
+
+void MinMaxPyramid::query(std::int64_t t0_us, std::int64_t t1_us, std::span<Bucket> columns) const {
+  std::fill(columns.begin(), columns.end(), Bucket{});
+  const auto n = static_cast<std::int64_t>(columns.size());
+  if (n == 0 || t1_us <= t0_us || empty()) return;
+
+  const std::int64_t window = t1_us - t0_us;
+  const std::int64_t column_us = std::max<std::int64_t>(1, window / n);
+
+  // Coarsest level that still resolves one column.
+  const Level* level = &levels_.front();
+  for (const auto& l : levels_) {
+    if (l.period_us <= column_us) level = &l;
+  }
+
+  const std::int64_t p = level->period_us;
+  const auto cap = static_cast<std::int64_t>(level->ring.size());
+  const std::int64_t oldest = level->head - cap + 1;
+
+  const std::int64_t b0 = std::max(std::max<std::int64_t>(t0_us, 0) / p, oldest);
+  const std::int64_t b1 = std::min((t1_us - 1) / p, level->head);
+
+  for (std::int64_t b = b0; b <= b1; ++b) {
+    const Bucket& bucket = level->ring[static_cast<std::size_t>(b % cap)];
+    if (bucket.empty()) continue;
+
+    // Column containing the bucket's midpoint.
+    const std::int64_t mid = b * p + p / 2;
+    const std::int64_t c = std::clamp<std::int64_t>((mid - t0_us) * n / window, 0, n - 1);
+    columns[static_cast<std::size_t>(c)].merge(bucket);
+  }
+}
+
+std::size_t MinMaxPyramid::memory_bytes() const {
+  std::size_t bytes = 0;
+  for (const auto& l : levels_) bytes += l.ring.size() * sizeof(Bucket);
+  return bytes;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+// Fixed-memory time series summary for trend plots.
+//
+// Level 0 is a ring of min/max buckets of base_period_us covering span_us;
+// each level above has buckets kFanout times longer over the same span.
+// push() folds a sample into one bucket per level, so every level is kept
+// up to date incrementally and nothing is ever rescanned. query() picks the
+// coarsest level whose buckets still fit in one output column, which bounds
+// the work by the column count (at most kFanout buckets per column) no
+// matter how long the window is.
+//
+// Memory is allocated once: about 4/3 * span/base buckets of 8 bytes.
+class MinMaxPyramid {
+public:
+  struct Bucket {
+    float min = std::numeric_limits<float>::infinity();
+    float max = -std::numeric_limits<float>::infinity();
+
+    bool empty() const { return !(min <= max); }
+    void add(float v) {
+      if (v < min) min = v;
+      if (v > max) max = v;
+    }
+    void merge(const Bucket& o) {
+      if (o.min < min) min = o.min;
+      if (o.max > max) max = o.max;
+    }
+  };
+
+  static constexpr int kFanout = 4;
+
+  MinMaxPyramid(std::int64_t base_period_us, std::int64_t span_us);
+
+  // Samples older than the span (relative to the newest) are ignored.
+  void push(std::int64_t time_us, double value);
+  void clear();
+
+  bool empty() const { return latest_us_ < 0; }
+  std::int64_t latest_time_us() const { return latest_us_; }
+  std::int64_t span_us() const { return span_us_; }
+
+  // Reduces [t0_us, t1_us) into columns.size() equal-width columns; columns
+  // without data are left empty.
+  void query(std::int64_t t0_us, std::int64_t t1_us, std::span<Bucket> columns) const;
+
+  std::size_t memory_bytes() const;
+
+private:
+  struct Level {
+    std::int64_t period_us = 0;
+    std::vector<Bucket> ring;
+    std::int64_t head = -1;  // newest bucket index (time_us / period_us)
+  };
+
+  static void push_level_(Level& l, std::int64_t time_us, float v);
+
+  std::int64_t span_us_;
+  std::int64_t latest_us_ = -1;
+  std::vector<Level> levels_;
+};
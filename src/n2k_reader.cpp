@@ -0,0 +1,168 @@
+#include "n2k_reader.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <ctime>
+#include <fcntl.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#include <net/if.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+namespace {
+
+std::int64_t clock_us(clockid_t clock) {
+  timespec ts{};
+  ::clock_gettime(clock, &ts);
+  return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000 + ts.tv_nsec / 1000;
+}
+
+} // namespace
+
+N2kReader::~N2kReader() {
+  stop();
+  for (const int fd : sockets_) ::close(fd);
+}
+
+bool N2kReader::add_interface(const std::string& name, std::string* error) {
+  auto fail = [&](const std::string& what) {
+    if (error) *error = name + ": " + what;
+    return false;
+  };
+
+  const unsigned index = ::if_nametoindex(name.c_str());
+  if (index == 0) return fail(std::strerror(errno));
+
+  const int fd = ::socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+  if (fd < 0) return fail(std::strerror(errno));
+
+  // Only extended data frames carrying one of the decoder's PGNs. PGN
+  // bits sit at 8..25 of the identifier; all of ours are PDU2 (global).
+  can_filter filters[nmea2000::kPgns.size()];
+  for (std::size_t i = 0; i < nmea2000::kPgns.size(); ++i) {
+    filters[i].can_id = (nmea2000::kPgns[i] << 8) | CAN_EFF_FLAG;
+    filters[i].can_mask = (0x3ffffu << 8) | CAN_EFF_FLAG | CAN_RTR_FLAG;
+  }
+  const int one = 1;
+  sockaddr_can addr{};
+  addr.can_family = AF_CAN;
+  addr.can_ifindex = static_cast<int>(index);
+  if (::setsockopt(fd, SOL_CAN_RAW, CAN_RAW_FILTER, filters, sizeof(filters)) != 0 ||
+      ::setsockopt(fd, SOL_SOCKET, SO_TIMESTAMP, &one, sizeof(one)) != 0 ||
+      ::bind(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) != 0) {
+    const int e = errno;
+    ::close(fd);
+    return fail(std::strerror(e));
+  }
+
+  sockets_.push_back(fd);
+  return true;
+}
+
+bool N2kReader::start() {
+  if (thread_.joinable() || sockets_.empty()) return false;
+  if (::pipe2(wake_pipe_, O_CLOEXEC | O_NONBLOCK) != 0) return false;
+
+  stop_.store(false);
+  thread_ = std::thread(&N2kReader::run_, this);
+  return true;
+}
+
+void N2kReader::stop() {
+  if (!thread_.joinable()) return;
+
+  stop_.store(true);
+  const char b = 1;
+  [[maybe_unused]] const auto n = ::write(wake_pipe_[1], &b, 1);
+  thread_.join();
+
+  ::close(wake_pipe_[0]);
+  ::close(wake_pipe_[1]);
+  wake_pipe_[0] = wake_pipe_[1] = -1;
+}
+
+bool N2kReader::poll(WindSample& out) {
+  // Re-arm first: a sample stored after this point must notify again.
+  notify_armed_.store(true, std::memory_order_release);
+
+  const std::uint64_t seq = latest_.sequence();
+  if (seq == last_seq_) return false;
+  last_seq_ = latest_.load(out);
+  return true;
+}
+
+N2kReader::Stats N2kReader::stats() const {
+  Stats s;
+  stats_.load(s);
+  return s;
+}
+
+void N2kReader::run_() {
+  // Fixed pollfd set: sockets first, wake pipe last.
+  std::vector<pollfd> pfds(sockets_.size() + 1);
+  for (std::size_t i = 0; i < sockets_.size(); ++i) pfds[i] = {sockets_[i], POLLIN, 0};
+  pfds.back() = {wake_pipe_[0], POLLIN, 0};
+
+  while (!stop_.load(std::memory_order_relaxed)) {
+    const int n = ::poll(pfds.data(), pfds.size(), -1);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+
+    for (std::size_t i = 0; i < sockets_.size(); ++i) {
+      if (pfds[i].revents & POLLIN) read_socket_(sockets_[i]);
+      // The interface went away (e.g. USB adapter unplugged).
+      if (pfds[i].revents & (POLLERR | POLLHUP | POLLNVAL)) pfds[i].fd = -1;
+    }
+  }
+}
+
+void N2kReader::read_socket_(int fd) {
+  // Kernel timestamps are CLOCK_REALTIME; samples use the steady clock.
+  const std::int64_t realtime_to_steady = clock_us(CLOCK_MONOTONIC) - clock_us(CLOCK_REALTIME);
+
+  can_frame frame{};
+  alignas(cmsghdr) char control[CMSG_SPACE(sizeof(timeval))];
+  iovec iov{&frame, sizeof(frame)};
+  bool published = false;
+
+  // Drain everything available so we never fall behind real time.
+  for (;;) {
+    msghdr msg{};
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    const ssize_t n = ::recvmsg(fd, &msg, 0);
+    if (n < static_cast<ssize_t>(sizeof(frame))) break;
+    if (!(frame.can_id & CAN_EFF_FLAG) || (frame.can_id & (CAN_RTR_FLAG | CAN_ERR_FLAG))) continue;
+
+    std::int64_t time_us = clock_us(CLOCK_MONOTONIC);
+    for (cmsghdr* c = CMSG_FIRSTHDR(&msg); c; c = CMSG_NXTHDR(&msg, c)) {
+      if (c->cmsg_level == SOL_SOCKET && c->cmsg_type == SCM_TIMESTAMP) {
+        timeval tv{};
+        std::memcpy(&tv, CMSG_DATA(c), sizeof(tv));
+        time_us = static_cast<std::int64_t>(tv.tv_sec) * 1'000'000 + tv.tv_usec + realtime_to_steady;
+      }
+    }
+
+    const auto len = std::min<std::size_t>(frame.can_dlc, sizeof(frame.data));
+    const auto r = decoder_.feed(frame.can_id & CAN_EFF_MASK, {frame.data, len}, time_us, current_);
+    if (r != nmea2000::Decoder::Result::applied) continue;
+
+    current_.time_us = time_us;
+    published = true;
+  }
+  // One store per burst: the UI only ever wants the newest merged sample.
+  if (published) latest_.store(current_);
+
+  const auto& d = decoder_.stats();
+  stats_.store({d.frames, d.applied, d.ignored, d.rejected_source, d.malformed, d.fast_packet_dropped});
+
+  if (published && notify_ && notify_armed_.exchange(false, std::memory_order_acq_rel)) notify_();
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "nmea2000.hpp"
+#include "seqlock.hpp"
+#include "wind_sample.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Background NMEA 2000 reader over Linux SocketCAN (can0, or vcan0 for
+// testing). Same shape as NmeaReader: one thread polls every interface,
+// decodes wind and boat-motion PGNs and publishes the merged latest sample
+// through a SeqLock. The UI thread calls poll().
+//
+// Each socket carries kernel CAN filters for the decoder's PGNs, so the
+// rest of a busy bus never wakes the thread. Frames are timestamped by the
+// kernel on receipt and mapped onto the steady clock. Decoding and
+// fast-packet reassembly use fixed buffers; nothing is allocated per frame.
+class N2kReader {
+public:
+  struct Stats {
+    std::uint64_t frames = 0;            // frames that passed the kernel filter
+    std::uint64_t applied = 0;
+    std::uint64_t ignored = 0;           // unused reference or field
+    std::uint64_t rejected_source = 0;   // lost arbitration (see SourcePolicy)
+    std::uint64_t malformed = 0;
+    std::uint64_t fast_packet_dropped = 0;
+  };
+
+  N2kReader() = default;
+  ~N2kReader();
+
+  N2kReader(const N2kReader&) = delete;
+  N2kReader& operator=(const N2kReader&) = delete;
+
+  // Opens a CAN interface by name; call before start().
+  bool add_interface(const std::string& name, std::string* error = nullptr);
+  bool empty() const { return sockets_.empty(); }
+
+  // Source selection per channel; call before start().
+  void set_policy(const nmea2000::SourcePolicy& policy) { decoder_.set_policy(policy); }
+  void set_policy(nmea2000::Channel channel, const nmea2000::SourcePolicy& policy) {
+    decoder_.set_policy(channel, policy);
+  }
+
+  // Called on the reader thread when a new sample follows a poll(). Set before start().
+  void set_notify(std::function<void()> fn) { notify_ = std::move(fn); }
+
+  bool start();
+  void stop();
+
+  // UI side: copies the latest sample if one was published since the last call.
+  bool poll(WindSample& out);
+
+  Stats stats() const;
+
+private:
+  void run_();
+  void read_socket_(int fd);
+
+  std::vector<int> sockets_;
+  std::thread thread_;
+  std::atomic<bool> stop_{false};
+  int wake_pipe_[2] = {-1, -1};
+
+  // Reader-thread state
+  nmea2000::Decoder decoder_;
+  WindSample current_;
+
+  SeqLock<WindSample> latest_;
+  std::uint64_t last_seq_ = 0;  // UI thread only
+
+  std::function<void()> notify_;
+  std::atomic<bool> notify_armed_{true};
+
+  // Copied from the decoder after each batch; the decoder itself is thread-local.
+  SeqLock<Stats> stats_;
+};
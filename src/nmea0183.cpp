@@ -0,0 +1,230 @@
+#include "nmea0183.hpp"
+
+#include <charconv>
+#include <cstdint>
+
+namespace nmea0183 {
+
+namespace {
+
+int hex_digit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
+// Comma-separated field cursor over the sentence body (no copies).
+class Fields {
+public:
+  explicit Fields(std::string_view body) : rest_(body) {}
+
+  bool next(std::string_view& f) {
+    if (done_) return false;
+    const auto comma = rest_.find(',');
+    if (comma == std::string_view::npos) {
+      f = rest_;
+      done_ = true;
+    } else {
+      f = rest_.substr(0, comma);
+      rest_.remove_prefix(comma + 1);
+    }
+    return true;
+  }
+
+private:
+  std::string_view rest_;
+  bool done_ = false;
+};
+
+bool parse_double(std::string_view f, double& out) {
+  if (f.empty()) return false;
+  const char* b = f.data();
+  const char* e = f.data() + f.size();
+  if (*b == '+') ++b;  // from_chars rejects a leading '+'
+  const auto r = std::from_chars(b, e, out);
+  return r.ec == std::errc{} && r.ptr == e;
+}
+
+constexpr double kMpsToKn  = 1.0 / 0.514444;
+constexpr double kKmhToKn  = 1.0 / 1.852;
+constexpr double kMphToKn  = 1.609344 / 1.852;
+
+// Strips '$'/'!' and "*hh"; returns false if the envelope is wrong.
+bool sentence_body(std::string_view s, std::string_view& body) {
+  if (s.size() < 4 || (s.front() != '$' && s.front() != '!')) return false;
+  const auto star = s.rfind('*');
+  if (star == std::string_view::npos) return false;
+  body = s.substr(1, star - 1);
+  return true;
+}
+
+ParseResult parse_mwv(Fields& f, WindSample& out) {
+  std::string_view angle, ref, speed, unit, status;
+  if (!f.next(angle) || !f.next(ref) || !f.next(speed) || !f.next(unit)) return ParseResult::malformed;
+  if (f.next(status) && status == "V") return ParseResult::ignored;
+  if (ref != "R") return ParseResult::ignored;  // true/theoretical wind handled elsewhere
+
+  double a = 0.0;
+  double v = 0.0;
+  const bool has_a = parse_double(angle, a);
+  const bool has_v = parse_double(speed, v);
+  if (!has_a && !has_v) return ParseResult::malformed;
+
+  if (has_a) {
+    if (a < 0.0 || a > 360.0) return ParseResult::malformed;
+    out.awa_deg = a > 180.0 ? a - 360.0 : a;
+    out.has_angle = true;
+  }
+  if (has_v) {
+    if (unit == "N")      out.aws_kn = v;
+    else if (unit == "M") out.aws_kn = v * kMpsToKn;
+    else if (unit == "K") out.aws_kn = v * kKmhToKn;
+    else if (unit == "S") out.aws_kn = v * kMphToKn;
+    else return ParseResult::malformed;
+    out.has_speed = true;
+  }
+  return ParseResult::ok;
+}
+
+ParseResult parse_vwr(Fields& f, WindSample& out) {
+  std::string_view angle, side, kn, kn_u, mps, mps_u, kmh, kmh_u;
+  if (!f.next(angle) || !f.next(side)) return ParseResult::malformed;
+  f.next(kn); f.next(kn_u);
+  f.next(mps); f.next(mps_u);
+  f.next(kmh); f.next(kmh_u);
+
+  double a = 0.0;
+  const bool has_a = parse_double(angle, a) && (side == "L" || side == "R");
+
+  double v = 0.0;
+  bool has_v = false;
+  if (parse_double(kn, v))       { has_v = true; }
+  else if (parse_double(mps, v)) { has_v = true; v *= kMpsToKn; }
+  else if (parse_double(kmh, v)) { has_v = true; v *= kKmhToKn; }
+
+  if (!has_a && !has_v) return ParseResult::malformed;
+
+  if (has_a) {
+    if (a < 0.0 || a > 180.0) return ParseResult::malformed;
+    out.awa_deg = (side == "L") ? -a : a;
+    out.has_angle = true;
+  }
+  if (has_v) {
+    out.aws_kn = v;
+    out.has_speed = true;
+  }
+  return ParseResult::ok;
+}
+
+bool parse_direction(std::string_view f, double& out) {
+  return parse_double(f, out) && out >= 0.0 && out <= 360.0;
+}
+
+// $--VHW,hdg,T,hdg,M,kn,N,kmh,K: heading and speed through water.
+ParseResult parse_vhw(Fields& f, WindSample& out) {
+  std::string_view hdg_t, t, hdg_m, m, kn, kn_u, kmh, kmh_u;
+  if (!f.next(hdg_t) || !f.next(t)) return ParseResult::malformed;
+  f.next(hdg_m); f.next(m);
+  f.next(kn); f.next(kn_u);
+  f.next(kmh); f.next(kmh_u);
+
+  double h = 0.0;
+  const bool has_h = (t == "T") && parse_direction(hdg_t, h);
+
+  double v = 0.0;
+  bool has_v = false;
+  if (parse_double(kn, v))       { has_v = true; }
+  else if (parse_double(kmh, v)) { has_v = true; v *= kKmhToKn; }
+
+  if (!has_h && !has_v) return ParseResult::ignored;  // often sent with every field empty
+  if (has_v && v < 0.0) return ParseResult::malformed;
+
+  if (has_h) { out.heading_deg = h; out.has_heading = true; }
+  if (has_v) { out.stw_kn = v;      out.has_stw = true; }
+  return ParseResult::ok;
+}
+
+// $--HDT,hdg,T
+ParseResult parse_hdt(Fields& f, WindSample& out) {
+  std::string_view hdg, t;
+  if (!f.next(hdg) || !f.next(t) || t != "T") return ParseResult::malformed;
+
+  double h = 0.0;
+  if (!parse_direction(hdg, h)) return ParseResult::malformed;
+  out.heading_deg = h;
+  out.has_heading = true;
+  return ParseResult::ok;
+}
+
+bool set_ground(std::string_view cog, std::string_view sog, WindSample& out) {
+  double c = 0.0;
+  double v = 0.0;
+  if (!parse_double(sog, v) || v < 0.0) return false;
+  // COG is meaningless (and often blank) when stopped.
+  if (!parse_direction(cog, c)) c = 0.0;
+  out.cog_deg = c;
+  out.sog_kn = v;
+  out.has_ground = true;
+  return true;
+}
+
+// $--RMC,time,status,lat,N,lon,E,sog,cog,date,...
+ParseResult parse_rmc(Fields& f, WindSample& out) {
+  std::string_view time, status, lat, ns, lon, ew, sog, cog;
+  if (!f.next(time) || !f.next(status) || !f.next(lat) || !f.next(ns) ||
+      !f.next(lon) || !f.next(ew) || !f.next(sog) || !f.next(cog)) {
+    return ParseResult::malformed;
+  }
+  if (status != "A") return ParseResult::ignored;
+  return set_ground(cog, sog, out) ? ParseResult::ok : ParseResult::malformed;
+}
+
+// $--VTG,cog,T,cog,M,sog,N,sog,K[,mode]
+ParseResult parse_vtg(Fields& f, WindSample& out) {
+  std::string_view cog, t, cog_m, m, kn, kn_u, kmh, kmh_u, mode;
+  if (!f.next(cog) || !f.next(t) || !f.next(cog_m) || !f.next(m) || !f.next(kn)) {
+    return ParseResult::malformed;
+  }
+  f.next(kn_u); f.next(kmh); f.next(kmh_u);
+  if (f.next(mode) && mode == "N") return ParseResult::ignored;  // fix not valid
+  return set_ground(cog, kn, out) ? ParseResult::ok : ParseResult::ignored;
+}
+
+} // namespace
+
+bool checksum_ok(std::string_view s) {
+  if (s.size() < 4 || (s.front() != '$' && s.front() != '!')) return false;
+  const auto star = s.rfind('*');
+  if (star == std::string_view::npos || star + 3 > s.size()) return false;
+
+  const int hi = hex_digit(s[star + 1]);
+  const int lo = hex_digit(s[star + 2]);
+  if (hi < 0 || lo < 0) return false;
+
+  std::uint8_t x = 0;
+  for (std::size_t i = 1; i < star; ++i) x ^= static_cast<std::uint8_t>(s[i]);
+  return x == static_cast<std::uint8_t>((hi << 4) | lo);
+}
+
+ParseResult parse_sentence(std::string_view s, WindSample& out) {
+  std::string_view body;
+  if (!sentence_body(s, body)) return ParseResult::malformed;
+  if (!checksum_ok(s)) return ParseResult::bad_checksum;
+
+  Fields f(body);
+  std::string_view addr;
+  if (!f.next(addr) || addr.size() < 5) return ParseResult::malformed;
+
+  // Address is talker (2 chars, e.g. "WI", "II") + sentence type.
+  const std::string_view type = addr.substr(addr.size() - 3);
+  if (type == "MWV") return parse_mwv(f, out);
+  if (type == "VWR") return parse_vwr(f, out);
+  if (type == "VHW") return parse_vhw(f, out);
+  if (type == "HDT") return parse_hdt(f, out);
+  if (type == "RMC") return parse_rmc(f, out);
+  if (type == "VTG") return parse_vtg(f, out);
+  return ParseResult::ignored;
+}
+
+} // namespace nmea0183
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "wind_sample.hpp"
+
+#include <cstddef>
+#include <string_view>
+
+// Allocation-free NMEA 0183 helpers for wind sentences (MWV, VWR) and the
+// boat motion true wind needs (VHW, HDT, RMC, VTG).
+namespace nmea0183 {
+
+enum class ParseResult {
+  ok,            // fields written to the sample
+  ignored,       // valid sentence we don't use (other talker/type, true wind, status V)
+  bad_checksum,
+  malformed,
+};
+
+// Validates "$...*hh" / "!...*hh". A missing checksum counts as invalid.
+bool checksum_ok(std::string_view sentence);
+
+// Parses MWV (relative reference), VWR, VHW, HDT, RMC and VTG. Only the
+// fields present in the sentence are written; the has_* flags tell which.
+// Magnetic-only headings (HDG, HDM) are ignored: without variation they
+// would skew true wind direction. time_us is untouched.
+ParseResult parse_sentence(std::string_view sentence, WindSample& out);
+
+// Splits a byte stream into sentences using a fixed buffer. Overlong lines
+// (longer than any legal sentence) are dropped rather than grown.
+class LineSplitter {
+public:
+  template <class OnLine>
+  void feed(const char* data, std::size_t n, OnLine&& on_line) {
+    for (std::size_t i = 0; i < n; ++i) {
+      const char c = data[i];
+      if (c == '\r' || c == '\n') {
+        flush(on_line);
+        continue;
+      }
+      if (c == '$' || c == '!') {
+        // Start of sentence resyncs, even mid-line (garbled input).
+        len_ = 0;
+        overflow_ = false;
+      }
+      if (len_ < sizeof(buf_)) buf_[len_++] = c;
+      else overflow_ = true;
+    }
+  }
+
+  // Treats the end of input as a line end (UDP datagrams often omit CRLF).
+  template <class OnLine>
+  void flush(OnLine&& on_line) {
+    if (overflow_) ++overflow_count_;
+    else if (len_ > 0) on_line(std::string_view(buf_, len_));
+    len_ = 0;
+    overflow_ = false;
+  }
+
+  std::size_t overflows() const { return overflow_count_; }
+
+private:
+  // NMEA 0183 caps sentences at 82 chars; leave room for proprietary senders.
+  char buf_[128];
+  std::size_t len_ = 0;
+  bool overflow_ = false;
+  std::size_t overflow_count_ = 0;
+};
+
+} // namespace nmea0183
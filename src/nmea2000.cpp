@@ -0,0 +1,293 @@
+#include "nmea2000.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace nmea2000 {
+
+namespace {
+
+constexpr double kMsToKn = 3600.0 / 1852.0;
+constexpr double kRadToDeg = 180.0 / std::numbers::pi;
+
+// Little-endian fields; the top three codes of each width mean "not available".
+bool u16_at(std::span<const std::uint8_t> p, std::size_t i, double scale, double& out) {
+  if (i + 2 > p.size()) return false;
+  const unsigned v = p[i] | (p[i + 1] << 8);
+  if (v >= 0xfffd) return false;
+  out = v * scale;
+  return true;
+}
+
+bool i16_at(std::span<const std::uint8_t> p, std::size_t i, double scale, double& out) {
+  if (i + 2 > p.size()) return false;
+  const auto v = static_cast<std::int16_t>(p[i] | (p[i + 1] << 8));
+  if (v >= 0x7ffd) return false;
+  out = v * scale;
+  return true;
+}
+
+double wrap_360(double deg) {
+  deg = std::fmod(deg, 360.0);
+  return deg < 0.0 ? deg + 360.0 : deg;
+}
+
+bool is_fast_packet(std::uint32_t pgn) {
+  return pgn == kPgnDirectionData;
+}
+
+} // namespace
+
+// ---------------- Fast packets ----------------
+
+std::span<const std::uint8_t> FastPacketAssembler::feed(std::uint8_t source, std::uint32_t pgn,
+                                                        std::span<const std::uint8_t> frame,
+                                                        std::int64_t time_us) {
+  if (frame.size() < 2) return {};
+  const std::uint8_t sequence = frame[0] >> 5;
+  const std::uint8_t index = frame[0] & 0x1f;
+
+  Slot* slot = nullptr;
+  for (auto& s : slots_) {
+    if (s.active && s.source == source && s.pgn == pgn) {
+      slot = &s;
+      break;
+    }
+  }
+
+  if (index == 0) {
+    if (slot) ++dropped_;  // restarted before finishing
+    if (!slot) {
+      // A free slot, else the oldest transfer is given up.
+      slot = &slots_[0];
+      for (auto& s : slots_) {
+        if (!s.active) { slot = &s; break; }
+        if (s.started_us < slot->started_us) slot = &s;
+      }
+      if (slot->active) ++dropped_;
+    }
+    const std::uint8_t size = frame[1];
+    if (size == 0 || size > kMaxPayload) {
+      slot->active = false;
+      return {};
+    }
+    const std::size_t n = std::min<std::size_t>(frame.size() - 2, size);
+    std::copy_n(frame.begin() + 2, n, slot->data.begin());
+    slot->active = true;
+    slot->source = source;
+    slot->pgn = pgn;
+    slot->sequence = sequence;
+    slot->next_frame = 1;
+    slot->size = size;
+    slot->have = static_cast<std::uint8_t>(n);
+    slot->started_us = time_us;
+  } else {
+    if (!slot) return {};  // joined mid-transfer
+    const std::size_t offset = 6 + static_cast<std::size_t>(index - 1) * 7;
+    if (sequence != slot->sequence || index != slot->next_frame || offset >= slot->size) {
+      slot->active = false;
+      ++dropped_;
+      return {};
+    }
+    const std::size_t n = std::min<std::size_t>(frame.size() - 1, slot->size - offset);
+    std::copy_n(frame.begin() + 1, n, slot->data.begin() + offset);
+    slot->have = static_cast<std::uint8_t>(slot->have + n);
+    ++slot->next_frame;
+  }
+
+  if (slot->have < slot->size) return {};
+  slot->active = false;
+  return {slot->data.data(), slot->size};
+}
+
+// ---------------- Decoder ----------------
+
+Decoder::Decoder() {
+  set_policy(SourcePolicy{});
+}
+
+void Decoder::set_policy(const SourcePolicy& policy) {
+  for (std::size_t c = 0; c < kChannelCount; ++c) set_policy(static_cast<Channel>(c), policy);
+}
+
+void Decoder::set_policy(Channel channel, const SourcePolicy& policy) {
+  Arbiter& a = arbiters_[static_cast<std::size_t>(channel)];
+  const auto others = static_cast<std::uint8_t>(std::min<std::size_t>(policy.preferred.size(), kRejected - 1));
+  a.rank.fill(policy.accept_others ? others : kRejected);
+  for (std::size_t i = policy.preferred.size(); i-- > 0;) {
+    a.rank[policy.preferred[i]] = static_cast<std::uint8_t>(std::min<std::size_t>(i, kRejected - 1));
+  }
+  a.fallback_after_us = std::max<std::int64_t>(0, policy.fallback_after_us);
+  a.active = -1;
+}
+
+int Decoder::active_source(Channel channel) const {
+  return arbiters_[static_cast<std::size_t>(channel)].active;
+}
+
+bool Decoder::admit_(Channel channel, std::uint8_t source, std::int64_t time_us) {
+  Arbiter& a = arbiters_[static_cast<std::size_t>(channel)];
+  const std::uint8_t rank = a.rank[source];
+  if (rank == kRejected) return false;
+
+  // Equal-ranked sources don't take turns: the active one keeps the channel
+  // until it falls silent, so two wind sensors never interleave.
+  const bool take = a.active < 0 || a.active == source || rank < a.active_rank ||
+                    time_us - a.last_us > a.fallback_after_us;
+  if (!take) return false;
+  a.active = source;
+  a.active_rank = rank;
+  a.last_us = time_us;
+  return true;
+}
+
+Decoder::Result Decoder::feed(std::uint32_t can_id, std::span<const std::uint8_t> data,
+                              std::int64_t time_us, WindSample& sample) {
+  ++stats_.frames;
+  const CanId id = decode_can_id(can_id);
+
+  Result r = Result::ignored;
+  switch (id.pgn) {
+    case kPgnVesselHeading:
+    case kPgnSpeedWater:
+    case kPgnCogSogRapid:
+    case kPgnWindData:
+    case kPgnDirectionData:
+      if (is_fast_packet(id.pgn)) {
+        const std::uint64_t dropped_before = fast_.dropped();
+        const auto payload = fast_.feed(id.source, id.pgn, data, time_us);
+        stats_.fast_packet_dropped += fast_.dropped() - dropped_before;
+        if (payload.empty()) return Result::pending;
+        r = decode_(id.pgn, id.source, payload, time_us, sample);
+      } else {
+        r = decode_(id.pgn, id.source, data, time_us, sample);
+      }
+      break;
+    default:
+      break;
+  }
+
+  switch (r) {
+    case Result::applied:         ++stats_.applied; break;
+    case Result::ignored:         ++stats_.ignored; break;
+    case Result::rejected_source: ++stats_.rejected_source; break;
+    case Result::malformed:       ++stats_.malformed; break;
+    case Result::pending:         break;
+  }
+  return r;
+}
+
+Decoder::Result Decoder::decode_(std::uint32_t pgn, std::uint8_t source, std::span<const std::uint8_t> p,
+                                 std::int64_t time_us, WindSample& sample) {
+  switch (pgn) {
+    case kPgnWindData: {
+      // SID, speed (0.01 m/s), angle (1e-4 rad), reference. True references
+      // are ignored: true wind is computed from apparent wind and boat motion.
+      if (p.size() < 6) return Result::malformed;
+      if ((p[5] & 0x7) != 2) return Result::ignored;
+      double speed = 0.0, angle = 0.0;
+      const bool has_speed = u16_at(p, 1, 0.01, speed);
+      const bool has_angle = u16_at(p, 3, 1e-4, angle);
+      if (!has_speed && !has_angle) return Result::ignored;
+      if (!admit_(Channel::wind, source, time_us)) return Result::rejected_source;
+
+      if (has_speed) {
+        sample.aws_kn = speed * kMsToKn;
+        sample.has_speed = true;
+      }
+      if (has_angle) {
+        const double deg = wrap_360(angle * kRadToDeg);
+        sample.awa_deg = deg > 180.0 ? deg - 360.0 : deg;
+        sample.has_angle = true;
+      }
+      return Result::applied;
+    }
+
+    case kPgnVesselHeading: {
+      // SID, heading, deviation, variation (1e-4 rad), reference (0 true, 1 magnetic).
+      if (p.size() < 8) return Result::malformed;
+      double heading = 0.0;
+      if (!u16_at(p, 1, 1e-4, heading)) return Result::ignored;
+      heading *= kRadToDeg;
+      if ((p[7] & 0x3) == 1) {
+        // Magnetic: usable only with variation.
+        double deviation = 0.0, variation = 0.0;
+        if (!i16_at(p, 5, 1e-4, variation)) return Result::ignored;
+        if (i16_at(p, 3, 1e-4, deviation)) heading += deviation * kRadToDeg;
+        heading += variation * kRadToDeg;
+      } else if ((p[7] & 0x3) != 0) {
+        return Result::ignored;
+      }
+      if (!admit_(Channel::heading, source, time_us)) return Result::rejected_source;
+      sample.heading_deg = wrap_360(heading);
+      sample.has_heading = true;
+      return Result::applied;
+    }
+
+    case kPgnSpeedWater: {
+      // SID, water-referenced speed (0.01 m/s), ground-referenced, type.
+      if (p.size() < 5) return Result::malformed;
+      double stw = 0.0;
+      if (!u16_at(p, 1, 0.01, stw)) return Result::ignored;
+      if (!admit_(Channel::stw, source, time_us)) return Result::rejected_source;
+      sample.stw_kn = stw * kMsToKn;
+      sample.has_stw = true;
+      return Result::applied;
+    }
+
+    case kPgnCogSogRapid: {
+      // SID, COG reference (0 true), COG (1e-4 rad), SOG (0.01 m/s).
+      if (p.size() < 6) return Result::malformed;
+      if ((p[1] & 0x3) != 0) return Result::ignored;
+      double cog = 0.0, sog = 0.0;
+      if (!u16_at(p, 2, 1e-4, cog) || !u16_at(p, 4, 0.01, sog)) return Result::ignored;
+      if (!admit_(Channel::ground, source, time_us)) return Result::rejected_source;
+      sample.cog_deg = wrap_360(cog * kRadToDeg);
+      sample.sog_kn = sog * kMsToKn;
+      sample.has_ground = true;
+      return Result::applied;
+    }
+
+    case kPgnDirectionData: {
+      // Data mode / COG reference, SID, COG, SOG, heading, STW, set, drift.
+      if (p.size() < 10) return Result::malformed;
+      if (((p[0] >> 4) & 0x3) != 0) return Result::ignored;  // magnetic
+
+      bool any = false, rejected = false;
+      double cog = 0.0, sog = 0.0, heading = 0.0, stw = 0.0;
+      if (u16_at(p, 2, 1e-4, cog) && u16_at(p, 4, 0.01, sog)) {
+        if (admit_(Channel::ground, source, time_us)) {
+          sample.cog_deg = wrap_360(cog * kRadToDeg);
+          sample.sog_kn = sog * kMsToKn;
+          sample.has_ground = any = true;
+        } else {
+          rejected = true;
+        }
+      }
+      if (u16_at(p, 6, 1e-4, heading)) {
+        if (admit_(Channel::heading, source, time_us)) {
+          sample.heading_deg = wrap_360(heading * kRadToDeg);
+          sample.has_heading = any = true;
+        } else {
+          rejected = true;
+        }
+      }
+      if (u16_at(p, 8, 0.01, stw)) {
+        if (admit_(Channel::stw, source, time_us)) {
+          sample.stw_kn = stw * kMsToKn;
+          sample.has_stw = any = true;
+        } else {
+          rejected = true;
+        }
+      }
+      if (any) return Result::applied;
+      return rejected ? Result::rejected_source : Result::ignored;
+    }
+
+    default:
+      return Result::ignored;
+  }
+}
+
+} // namespace nmea2000
@@ -0,0 +1,167 @@
+#pragma once
+
+#include "wind_sample.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Allocation-free NMEA 2000 decoding for wind (PGN 130306) and the boat
+// motion true wind needs: heading (127250), speed through water (128259),
+// COG/SOG (129026) and Direction Data (130577, a fast-packet PGN).
+//
+// The Decoder takes raw 29-bit CAN frames. Each PGN is reassembled and
+// decoded, then arbitrated between sources: per channel (wind, heading,
+// STW, ground), only one source address is used at a time.
+namespace nmea2000 {
+
+inline constexpr std::uint32_t kPgnVesselHeading = 127250;
+inline constexpr std::uint32_t kPgnSpeedWater    = 128259;
+inline constexpr std::uint32_t kPgnCogSogRapid   = 129026;
+inline constexpr std::uint32_t kPgnWindData      = 130306;
+inline constexpr std::uint32_t kPgnDirectionData = 130577;
+
+// Everything the decoder uses; readers install these as kernel CAN filters
+// so the rest of a busy bus never reaches user space.
+inline constexpr std::array<std::uint32_t, 5> kPgns = {
+    kPgnVesselHeading, kPgnSpeedWater, kPgnCogSogRapid, kPgnWindData, kPgnDirectionData,
+};
+
+struct CanId {
+  std::uint8_t priority = 0;
+  std::uint32_t pgn = 0;
+  std::uint8_t source = 0;
+  std::uint8_t destination = 0xff;  // 0xff: global (all PDU2 messages)
+};
+
+// Splits a 29-bit extended CAN identifier (ISO 11783 / J1939 layout).
+constexpr CanId decode_can_id(std::uint32_t id) {
+  CanId c;
+  c.priority = static_cast<std::uint8_t>((id >> 26) & 0x7);
+  c.source = static_cast<std::uint8_t>(id & 0xff);
+  const std::uint32_t pf = (id >> 16) & 0xff;
+  const std::uint32_t dp = (id >> 24) & 0x3;
+  if (pf < 240) {
+    // PDU1: PS is the destination address, not part of the PGN.
+    c.destination = static_cast<std::uint8_t>((id >> 8) & 0xff);
+    c.pgn = (dp << 16) | (pf << 8);
+  } else {
+    c.pgn = (dp << 16) | (pf << 8) | ((id >> 8) & 0xff);
+  }
+  return c;
+}
+
+constexpr std::uint32_t encode_can_id(std::uint8_t priority, std::uint32_t pgn, std::uint8_t source) {
+  return (static_cast<std::uint32_t>(priority & 0x7) << 26) | ((pgn & 0x3ffff) << 8) | source;
+}
+
+static_assert(decode_can_id(0x09FD0201).pgn == kPgnWindData);
+static_assert(decode_can_id(encode_can_id(2, kPgnDirectionData, 7)).source == 7);
+
+// Data sources the decoder tells apart. A PGN may feed several (130577).
+enum class Channel : std::uint8_t { wind, heading, stw, ground };
+inline constexpr std::size_t kChannelCount = 4;
+
+// Reassembles fast-packet PGNs (up to 223 bytes over 32 frames) into a
+// fixed set of buffers, one per concurrent (source, PGN) transfer.
+class FastPacketAssembler {
+public:
+  static constexpr std::size_t kMaxPayload = 223;
+  static constexpr std::size_t kSlots = 8;
+
+  // Feeds one frame. Returns the complete payload once its last frame
+  // arrives (valid until the next call), otherwise an empty span.
+  std::span<const std::uint8_t> feed(std::uint8_t source, std::uint32_t pgn,
+                                     std::span<const std::uint8_t> frame, std::int64_t time_us);
+
+  // Transfers abandoned: a frame missing or out of order, or evicted by
+  // newer transfers while incomplete.
+  std::uint64_t dropped() const { return dropped_; }
+
+private:
+  struct Slot {
+    bool active = false;
+    std::uint8_t source = 0;
+    std::uint32_t pgn = 0;
+    std::uint8_t sequence = 0;    // 3-bit sequence counter of this transfer
+    std::uint8_t next_frame = 0;
+    std::uint8_t size = 0;
+    std::uint8_t have = 0;
+    std::int64_t started_us = 0;
+    std::array<std::uint8_t, kMaxPayload> data{};
+  };
+
+  std::array<Slot, kSlots> slots_{};
+  std::uint64_t dropped_ = 0;
+};
+
+// Which source addresses may feed a channel, and in what order.
+struct SourcePolicy {
+  // Source addresses in order of preference. Empty: all sources rank equally.
+  std::vector<std::uint8_t> preferred;
+  // Whether sources not in `preferred` may be used (ranked after them).
+  bool accept_others = true;
+  // A source ranked lower than the active one takes over only after the
+  // active one has been silent this long. A higher-ranked source takes over
+  // at once.
+  std::int64_t fallback_after_us = 2'000'000;
+};
+
+class Decoder {
+public:
+  enum class Result {
+    applied,          // fields merged into the sample
+    pending,          // fast-packet frame buffered; transfer not complete
+    ignored,          // PGN, reference or field we don't use
+    rejected_source,  // the source policy said no
+    malformed,
+  };
+
+  struct Stats {
+    std::uint64_t frames = 0;
+    std::uint64_t applied = 0;
+    std::uint64_t ignored = 0;
+    std::uint64_t rejected_source = 0;
+    std::uint64_t malformed = 0;
+    std::uint64_t fast_packet_dropped = 0;
+  };
+
+  Decoder();
+
+  void set_policy(Channel channel, const SourcePolicy& policy);
+  // Same policy for every channel.
+  void set_policy(const SourcePolicy& policy);
+
+  // Feeds one frame. `can_id` is the 29-bit identifier and `time_us` is
+  // the receive time on the sample clock. Fields that decode are merged into
+  // `sample`, setting their has_* flags; other fields are left unchanged.
+  Result feed(std::uint32_t can_id, std::span<const std::uint8_t> data, std::int64_t time_us,
+              WindSample& sample);
+
+  const Stats& stats() const { return stats_; }
+
+  // Source address currently feeding `channel`, or -1 if none yet.
+  int active_source(Channel channel) const;
+
+private:
+  struct Arbiter {
+    std::array<std::uint8_t, 256> rank{};  // 0 = best; kRejected = never
+    std::int64_t fallback_after_us = 0;
+    int active = -1;
+    std::uint8_t active_rank = 0;
+    std::int64_t last_us = 0;
+  };
+  static constexpr std::uint8_t kRejected = 0xff;
+
+  bool admit_(Channel channel, std::uint8_t source, std::int64_t time_us);
+  Result decode_(std::uint32_t pgn, std::uint8_t source, std::span<const std::uint8_t> p,
+                 std::int64_t time_us, WindSample& sample);
+
+  std::array<Arbiter, kChannelCount> arbiters_{};
+  FastPacketAssembler fast_;
+  Stats stats_;
+};
+
+} // namespace nmea2000
@@ -0,0 +1,243 @@
+#include "nmea_reader.hpp"
+
+#include <arpa/inet.h>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+
+std::int64_t now_us() {
+  using namespace std::chrono;
+  return duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+}
+
+speed_t baud_constant(int baud) {
+  switch (baud) {
+    case 4800:   return B4800;
+    case 9600:   return B9600;
+    case 19200:  return B19200;
+    case 38400:  return B38400;
+    case 57600:  return B57600;
+    case 115200: return B115200;
+    default:     return 0;
+  }
+}
+
+int open_serial(const std::string& path, int baud, std::string* error) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+  if (fd < 0) {
+    if (error) *error = path + ": " + std::strerror(errno);
+    return -1;
+  }
+
+  // Raw 8N1. A pty or FIFO may not be a tty; that's fine, just skip termios.
+  termios tio{};
+  if (::tcgetattr(fd, &tio) == 0) {
+    ::cfmakeraw(&tio);
+    tio.c_cflag |= CLOCAL | CREAD;
+    if (const speed_t b = baud_constant(baud)) {
+      ::cfsetispeed(&tio, b);
+      ::cfsetospeed(&tio, b);
+    }
+    ::tcsetattr(fd, TCSANOW, &tio);
+  }
+  return fd;
+}
+
+int open_udp(const std::string& addr, int port, std::string* error) {
+  const int fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+  if (fd < 0) {
+    if (error) *error = std::string("socket: ") + std::strerror(errno);
+    return -1;
+  }
+
+  const int one = 1;
+  ::setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+  sockaddr_in sa{};
+  sa.sin_family = AF_INET;
+  sa.sin_port = htons(static_cast<uint16_t>(port));
+  if (::inet_pton(AF_INET, addr.c_str(), &sa.sin_addr) != 1 ||
+      ::bind(fd, reinterpret_cast<const sockaddr*>(&sa), sizeof(sa)) != 0) {
+    if (error) *error = "udp:" + addr + ":" + std::to_string(port) + ": " + std::strerror(errno);
+    ::close(fd);
+    return -1;
+  }
+  return fd;
+}
+
+} // namespace
+
+NmeaReader::~NmeaReader() {
+  stop();
+  for (auto& s : sources_) {
+    if (s.fd >= 0) ::close(s.fd);
+  }
+}
+
+bool NmeaReader::add_source(const std::string& spec, std::string* error) {
+  Source src;
+  src.spec = spec;
+
+  if (spec.rfind("udp:", 0) == 0) {
+    std::string addr = "127.0.0.1";
+    std::string port = spec.substr(4);
+    const auto colon = port.rfind(':');
+    if (colon != std::string::npos) {
+      addr = port.substr(0, colon);
+      port = port.substr(colon + 1);
+    }
+    src.fd = open_udp(addr, std::atoi(port.c_str()), error);
+    src.datagram = true;
+  } else {
+    std::string path = spec;
+    int baud = 4800;
+    const auto comma = path.rfind(',');
+    if (comma != std::string::npos) {
+      baud = std::atoi(path.c_str() + comma + 1);
+      path.resize(comma);
+    }
+    src.fd = open_serial(path, baud, error);
+  }
+
+  if (src.fd < 0) return false;
+  sources_.push_back(std::move(src));
+  return true;
+}
+
+bool NmeaReader::start() {
+  if (thread_.joinable() || sources_.empty()) return false;
+  if (::pipe2(wake_pipe_, O_CLOEXEC | O_NONBLOCK) != 0) return false;
+
+  stop_.store(false);
+  thread_ = std::thread(&NmeaReader::run_, this);
+  return true;
+}
+
+void NmeaReader::stop() {
+  if (!thread_.joinable()) return;
+
+  stop_.store(true);
+  const char b = 1;
+  [[maybe_unused]] const auto n = ::write(wake_pipe_[1], &b, 1);
+  thread_.join();
+
+  ::close(wake_pipe_[0]);
+  ::close(wake_pipe_[1]);
+  wake_pipe_[0] = wake_pipe_[1] = -1;
+}
+
+bool NmeaReader::poll(WindSample& out) {
+  // Re-arm first: a sample stored after this point must notify again.
+  notify_armed_.store(true, std::memory_order_release);
+
+  const std::uint64_t seq = latest_.sequence();
+  if (seq == last_seq_) return false;
+  last_seq_ = latest_.load(out);
+  return true;
+}
+
+NmeaReader::Stats NmeaReader::stats() const {
+  Stats s;
+  s.sentences    = n_sentences_.load(std::memory_order_relaxed);
+  s.ignored      = n_ignored_.load(std::memory_order_relaxed);
+  s.bad_checksum = n_bad_checksum_.load(std::memory_order_relaxed);
+  s.malformed    = n_malformed_.load(std::memory_order_relaxed);
+  s.overlong     = n_overlong_.load(std::memory_order_relaxed);
+  return s;
+}
+
+void NmeaReader::run_() {
+  // Fixed pollfd set: sources first, wake pipe last.
+  std::vector<pollfd> pfds(sources_.size() + 1);
+  for (size_t i = 0; i < sources_.size(); ++i) pfds[i] = {sources_[i].fd, POLLIN, 0};
+  pfds.back() = {wake_pipe_[0], POLLIN, 0};
+
+  while (!stop_.load(std::memory_order_relaxed)) {
+    const int n = ::poll(pfds.data(), pfds.size(), -1);
+    if (n < 0) {
+      if (errno == EINTR) continue;
+      break;
+    }
+
+    for (size_t i = 0; i < sources_.size(); ++i) {
+      if (pfds[i].revents & (POLLIN | POLLERR | POLLHUP)) read_source_(sources_[i]);
+      // A hung-up pty keeps reporting POLLHUP; stop polling it instead of spinning.
+      if (pfds[i].revents & POLLHUP) pfds[i].fd = -1;
+    }
+  }
+}
+
+void NmeaReader::read_source_(Source& src) {
+  char buf[2048];
+  auto on_line = [this](std::string_view line) { handle_line_(line); };
+  const std::size_t overflows_before = src.splitter.overflows();
+
+  // Drain everything available so we never fall behind real time.
+  for (;;) {
+    const ssize_t n = src.datagram ? ::recv(src.fd, buf, sizeof(buf), 0)
+                                   : ::read(src.fd, buf, sizeof(buf));
+    if (n <= 0) break;
+
+    src.splitter.feed(buf, static_cast<std::size_t>(n), on_line);
+    if (src.datagram) src.splitter.flush(on_line);
+  }
+
+  const std::size_t overflows = src.splitter.overflows() - overflows_before;
+  if (overflows) n_overlong_.fetch_add(overflows, std::memory_order_relaxed);
+}
+
+void NmeaReader::handle_line_(std::string_view line) {
+  WindSample s = current_;
+  s.has_angle = s.has_speed = false;
+  s.has_stw = s.has_heading = s.has_ground = false;
+
+  switch (nmea0183::parse_sentence(line, s)) {
+    case nmea0183::ParseResult::ok:
+      break;
+    case nmea0183::ParseResult::ignored:
+      n_ignored_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    case nmea0183::ParseResult::bad_checksum:
+      n_bad_checksum_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    case nmea0183::ParseResult::malformed:
+      n_malformed_.fetch_add(1, std::memory_order_relaxed);
+      return;
+  }
+
+  // Merge into the running sample: a speed-only sentence keeps the last angle.
+  const std::int64_t now = now_us();
+  if (s.has_angle)   { current_.awa_deg = s.awa_deg;         received_.angle = now; }
+  if (s.has_speed)   { current_.aws_kn  = s.aws_kn;          received_.speed = now; }
+  if (s.has_stw)     { current_.stw_kn  = s.stw_kn;          received_.stw = now; }
+  if (s.has_heading) { current_.heading_deg = s.heading_deg; received_.heading = now; }
+  if (s.has_ground) {
+    current_.cog_deg = s.cog_deg;
+    current_.sog_kn  = s.sog_kn;
+    received_.ground = now;
+  }
+  // A field whose sentence stopped arriving drops out instead of being
+  // merged into every later sample (e.g. STW after the log fails).
+  const std::int64_t max_age = max_age_us_.load(std::memory_order_relaxed);
+  auto fresh = [&](std::int64_t t) { return t != 0 && now - t <= max_age; };
+  current_.has_angle   = fresh(received_.angle);
+  current_.has_speed   = fresh(received_.speed);
+  current_.has_stw     = fresh(received_.stw);
+  current_.has_heading = fresh(received_.heading);
+  current_.has_ground  = fresh(received_.ground);
+  current_.time_us = now;
+
+  latest_.store(current_);
+  n_sentences_.fetch_add(1, std::memory_order_relaxed);
+
+  if (notify_ && notify_armed_.exchange(false, std::memory_order_acq_rel)) notify_();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "nmea0183.hpp"
+#include "seqlock.hpp"
+#include "wind_sample.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Background NMEA 0183 reader. One thread multiplexes every source with
+// poll(), parses wind and boat-motion sentences and publishes the merged latest sample
+// through a SeqLock. The UI thread calls poll() once per frame; bursts
+// between frames coalesce into the newest value and the reader never waits
+// on the UI.
+//
+// An optional notify callback (e.g. Glib::Dispatcher::emit) lets the UI stay
+// fully idle until data arrives. It fires from the reader thread at most
+// once per poll(), so a burst costs a single main-loop wakeup.
+//
+// Source specs:
+//   /dev/ttyUSB0          serial device or pty (4800 baud)
+//   /dev/ttyUSB0,38400    serial device with explicit baud rate
+//   udp:10110             UDP on 127.0.0.1:10110
+//   udp:0.0.0.0:10110     UDP on an explicit bind address
+class NmeaReader {
+public:
+  struct Stats {
+    std::uint64_t sentences    = 0;  // sentences applied
+    std::uint64_t ignored      = 0;
+    std::uint64_t bad_checksum = 0;
+    std::uint64_t malformed    = 0;
+    std::uint64_t overlong     = 0;
+  };
+
+  NmeaReader() = default;
+  ~NmeaReader();
+
+  NmeaReader(const NmeaReader&) = delete;
+  NmeaReader& operator=(const NmeaReader&) = delete;
+
+  // Opens a source; call before start(). Returns false and fills `error` on failure.
+  bool add_source(const std::string& spec, std::string* error = nullptr);
+  bool empty() const { return sources_.empty(); }
+
+  // Called on the reader thread when a new sample follows a poll(). Set before start().
+  void set_notify(std::function<void()> fn) { notify_ = std::move(fn); }
+
+  // Fields not received for longer than this are cleared from the merged
+  // sample (has_stw etc.), as ChannelBus channels go stale. Default 3 s.
+  void set_max_age_us(std::int64_t us) { max_age_us_.store(us, std::memory_order_relaxed); }
+  std::int64_t max_age_us() const { return max_age_us_.load(std::memory_order_relaxed); }
+
+  bool start();
+  void stop();
+
+  // UI side: copies the latest sample if one was published since the last call.
+  bool poll(WindSample& out);
+
+  Stats stats() const;
+
+private:
+  struct Source {
+    std::string spec;
+    int fd = -1;
+    bool datagram = false;
+    nmea0183::LineSplitter splitter;
+  };
+
+  void run_();
+  void read_source_(Source& src);
+  void handle_line_(std::string_view line);
+
+  std::vector<Source> sources_;
+  std::thread thread_;
+  std::atomic<bool> stop_{false};
+  int wake_pipe_[2] = {-1, -1};
+
+  // Reader-thread state
+  WindSample current_;
+  struct ReceiveTimes {  // monotonic µs per field of current_, 0 = never
+    std::int64_t angle = 0, speed = 0, stw = 0, heading = 0, ground = 0;
+  };
+  ReceiveTimes received_;
+  std::atomic<std::int64_t> max_age_us_{3'000'000};
+
+  SeqLock<WindSample> latest_;
+  std::uint64_t last_seq_ = 0;  // UI thread only
+
+  std::function<void()> notify_;
+  std::atomic<bool> notify_armed_{true};
+
+  std::atomic<std::uint64_t> n_sentences_{0};
+  std::atomic<std::uint64_t> n_ignored_{0};
+  std::atomic<std::uint64_t> n_bad_checksum_{0};
+  std::atomic<std::uint64_t> n_malformed_{0};
+  std::atomic<std::uint64_t> n_overlong_{0};
+};
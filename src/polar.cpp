@@ -0,0 +1,311 @@
+#include "polar.hpp"
+
+#include "true_wind.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <utility>
+
+namespace {
+
+constexpr double kDegToRad = 3.14159265358979323846 / 180.0;
+
+// 0..180, port and starboard alike.
+double fold_twa(double twa_deg) {
+  double a = std::fmod(std::fabs(twa_deg), 360.0);
+  return a > 180.0 ? 360.0 - a : a;
+}
+
+std::string_view trim(std::string_view s) {
+  while (!s.empty() && (s.front() == ' ' || s.front() == '\t' || s.front() == '\r')) s.remove_prefix(1);
+  while (!s.empty() && (s.back() == ' ' || s.back() == '\t' || s.back() == '\r')) s.remove_suffix(1);
+  return s;
+}
+
+// Cells of one line. With an explicit separator (tab, comma, semicolon)
+// empty cells are kept, so "52,,6.5" has a hole; otherwise runs of spaces
+// separate.
+std::vector<std::string_view> split_cells(std::string_view line) {
+  std::vector<std::string_view> cells;
+  const std::size_t sep_at = line.find_first_of("\t,;");
+  if (sep_at != std::string_view::npos) {
+    const char sep = line[sep_at];
+    for (;;) {
+      const std::size_t at = line.find(sep);
+      cells.push_back(trim(line.substr(0, at)));
+      if (at == std::string_view::npos) break;
+      line.remove_prefix(at + 1);
+    }
+    // Trailing separators are not cells.
+    while (!cells.empty() && cells.back().empty()) cells.pop_back();
+    return cells;
+  }
+  for (;;) {
+    line = trim(line);
+    if (line.empty()) break;
+    const std::size_t at = line.find(' ');
+    cells.push_back(line.substr(0, at));
+    if (at == std::string_view::npos) break;
+    line.remove_prefix(at);
+  }
+  return cells;
+}
+
+bool parse_number(std::string_view cell, double& out) {
+  if (cell.empty()) {
+    out = 0.0;
+    return true;
+  }
+  if (cell.front() == '+') cell.remove_prefix(1);
+  const auto [end, ec] = std::from_chars(cell.data(), cell.data() + cell.size(), out);
+  return ec == std::errc{} && end == cell.data() + cell.size() && std::isfinite(out);
+}
+
+// One TWS column of the source table: the TWAs that have data.
+struct Column {
+  std::vector<std::pair<double, double>> points;  // (twa, speed), ascending twa
+
+  // Linear between points, down to 0 at TWA 0, held past the last point.
+  double at(double twa) const {
+    if (points.empty()) return 0.0;
+    if (twa <= points.front().first) {
+      const auto [a, v] = points.front();
+      return a > 0.0 ? v * twa / a : v;
+    }
+    if (twa >= points.back().first) return points.back().second;
+    const auto hi = std::upper_bound(points.begin(), points.end(), twa,
+                                     [](double t, const auto& p) { return t < p.first; });
+    const auto lo = hi - 1;
+    const double f = (twa - lo->first) / (hi->first - lo->first);
+    return lo->second + f * (hi->second - lo->second);
+  }
+};
+
+// Source speed: per-column TWA interpolation, then linear across TWS, down
+// to 0 at TWS 0 and held past the last column.
+double source_speed(const std::vector<double>& tws_axis, const std::vector<Column>& cols, double tws,
+                    double twa) {
+  if (tws <= tws_axis.front()) return cols.front().at(twa) * tws / tws_axis.front();
+  if (tws >= tws_axis.back()) return cols.back().at(twa);
+  const std::size_t j = static_cast<std::size_t>(
+      std::upper_bound(tws_axis.begin(), tws_axis.end(), tws) - tws_axis.begin());
+  const double f = (tws - tws_axis[j - 1]) / (tws_axis[j] - tws_axis[j - 1]);
+  return cols[j - 1].at(twa) + f * (cols[j].at(twa) - cols[j - 1].at(twa));
+}
+
+} // namespace
+
+bool PolarTable::load(const std::string& path, std::string* error) {
+  std::ifstream in(path, std::ios::binary);
+  if (!in) {
+    if (error) *error = path + ": cannot open";
+    return false;
+  }
+  std::ostringstream text;
+  text << in.rdbuf();
+  std::string err;
+  if (!parse(text.str(), &err)) {
+    if (error) *error = path + ": " + err;
+    return false;
+  }
+  return true;
+}
+
+bool PolarTable::parse(std::string_view text, std::string* error) {
+  auto fail = [&](std::size_t line_no, const std::string& what) {
+    if (error) *error = "line " + std::to_string(line_no) + ": " + what;
+    return false;
+  };
+
+  std::vector<double> twa, tws, speeds;
+  bool have_header = false;
+  std::size_t line_no = 0;
+  while (!text.empty()) {
+    const std::size_t eol = text.find('\n');
+    const std::string_view line = trim(text.substr(0, eol));
+    text.remove_prefix(eol == std::string_view::npos ? text.size() : eol + 1);
+    ++line_no;
+    if (line.empty() || line.front() == '#') continue;
+
+    const auto cells = split_cells(line);
+    if (!have_header) {
+      // First cell is a label such as "twa/tws".
+      for (std::size_t j = 1; j < cells.size(); ++j) {
+        double v = 0.0;
+        if (!parse_number(cells[j], v) || cells[j].empty()) return fail(line_no, "bad TWS value");
+        tws.push_back(v);
+      }
+      if (tws.empty()) return fail(line_no, "header has no TWS columns");
+      have_header = true;
+      continue;
+    }
+
+    double a = 0.0;
+    if (cells.empty() || !parse_number(cells[0], a) || cells[0].empty()) return fail(line_no, "bad TWA value");
+    if (cells.size() > tws.size() + 1) return fail(line_no, "more cells than TWS columns");
+    twa.push_back(a);
+    for (std::size_t j = 0; j < tws.size(); ++j) {
+      double v = 0.0;
+      if (j + 1 < cells.size() && !parse_number(cells[j + 1], v)) return fail(line_no, "bad boat speed");
+      speeds.push_back(v);
+    }
+  }
+  if (!have_header) return fail(line_no, "empty polar");
+  return build(std::move(twa), std::move(tws), std::move(speeds), error);
+}
+
+bool PolarTable::build(std::vector<double> twa_deg, std::vector<double> tws_kn, std::vector<double> speeds,
+                       std::string* error) {
+  auto fail = [&](const char* what) {
+    if (error) *error = what;
+    return false;
+  };
+  if (twa_deg.empty() || tws_kn.empty()) return fail("no data");
+  if (speeds.size() != twa_deg.size() * tws_kn.size()) return fail("speed table does not match its axes");
+  if (!std::is_sorted(twa_deg.begin(), twa_deg.end(), std::less_equal<>{}) || twa_deg.front() < 0.0 ||
+      twa_deg.back() > 180.0) {
+    return fail("TWA must ascend within 0..180");
+  }
+  if (!std::is_sorted(tws_kn.begin(), tws_kn.end(), std::less_equal<>{}) || tws_kn.front() <= 0.0) {
+    return fail("TWS must ascend from above 0");
+  }
+
+  std::vector<Column> cols(tws_kn.size());
+  bool any = false;
+  for (std::size_t i = 0; i < twa_deg.size(); ++i) {
+    for (std::size_t j = 0; j < tws_kn.size(); ++j) {
+      const double v = speeds[i * tws_kn.size() + j];
+      if (v < 0.0) return fail("negative boat speed");
+      if (v == 0.0) continue;  // no data
+      cols[j].points.emplace_back(twa_deg[i], v);
+      any = true;
+    }
+  }
+  if (!any) return fail("no boat speeds");
+
+  // VMG targets come only from angles the polar covers: the fall to 0
+  // below the first row and the hold past the last would otherwise win.
+  double lo_twa = 180.0, hi_twa = 0.0;
+  for (const auto& col : cols) {
+    if (col.points.empty()) continue;
+    lo_twa = std::min(lo_twa, col.points.front().first);
+    hi_twa = std::max(hi_twa, col.points.back().first);
+  }
+  const int lo_c = static_cast<int>(std::ceil(lo_twa / kTwaStep));
+  const int hi_c = static_cast<int>(std::floor(hi_twa / kTwaStep));
+
+  // Dense grid from TWS 0 to the last column, plus one row so the last
+  // column is a grid row and interpolation never reads past the end.
+  max_tws_ = tws_kn.back();
+  row_count_ = static_cast<int>(std::ceil(max_tws_ / kTwsStep)) + 2;
+  grid_.assign(static_cast<std::size_t>(row_count_) * kTwaCols, 0.0f);
+  rows_.assign(static_cast<std::size_t>(row_count_), Row{});
+  max_speed_ = 0.0;
+
+  for (int r = 0; r < row_count_; ++r) {
+    const double tws = std::min(r * kTwsStep, max_tws_);
+    float* row = &grid_[static_cast<std::size_t>(r) * kTwaCols];
+    for (int c = 0; c < kTwaCols; ++c) {
+      row[c] = static_cast<float>(source_speed(tws_kn, cols, tws, c * kTwaStep));
+      max_speed_ = std::max(max_speed_, static_cast<double>(row[c]));
+    }
+
+    // Best VMG by column, then a parabola through the neighbours for the
+    // sub-degree angle.
+    auto best = [&](int from, int to, double sign) {
+      int best_c = -1;
+      double best_vmg = 0.0;
+      auto vmg_at = [&](int c) { return sign * row[c] * std::cos(c * kTwaStep * kDegToRad); };
+      for (int c = from; c <= to; ++c) {
+        const double v = vmg_at(c);
+        if (v > best_vmg) {
+          best_vmg = v;
+          best_c = c;
+        }
+      }
+      Targets t;
+      if (best_c < 0) return t;
+      double offset = 0.0;
+      if (best_c > from && best_c < to) {
+        const double y0 = vmg_at(best_c - 1), y1 = best_vmg, y2 = vmg_at(best_c + 1);
+        const double denom = y0 - 2.0 * y1 + y2;
+        if (denom < 0.0) offset = std::clamp(0.5 * (y0 - y2) / denom, -0.5, 0.5);
+      }
+      t.twa_deg = (best_c + offset) * kTwaStep;
+      t.bsp_kn = row[best_c];
+      if (offset != 0.0) {
+        const int n = offset < 0.0 ? best_c - 1 : best_c + 1;
+        t.bsp_kn += std::fabs(offset) * (row[n] - row[best_c]);
+      }
+      t.vmg_kn = sign * t.bsp_kn * std::cos(t.twa_deg * kDegToRad);
+      return t;
+    };
+    rows_[static_cast<std::size_t>(r)].up = best(lo_c, std::min(hi_c, 89), 1.0);
+    rows_[static_cast<std::size_t>(r)].down = best(std::max(lo_c, 91), hi_c, -1.0);
+  }
+  return true;
+}
+
+double PolarTable::boat_speed(double tws_kn, double twa_deg) const {
+  if (grid_.empty() || !std::isfinite(tws_kn) || !std::isfinite(twa_deg)) return 0.0;
+  const double r = std::clamp(tws_kn, 0.0, max_tws_) / kTwsStep;
+  const double c = fold_twa(twa_deg) / kTwaStep;
+  const int r0 = std::min(static_cast<int>(r), row_count_ - 2);
+  const int c0 = std::min(static_cast<int>(c), kTwaCols - 2);
+  const double fr = r - r0, fc = c - c0;
+
+  const float* p = &grid_[static_cast<std::size_t>(r0) * kTwaCols + c0];
+  const double lo = p[0] + fc * (p[1] - p[0]);
+  const double hi = p[kTwaCols] + fc * (p[kTwaCols + 1] - p[kTwaCols]);
+  return lo + fr * (hi - lo);
+}
+
+PolarTable::Targets PolarTable::blend_(double tws_kn, Targets Row::*which) const {
+  if (rows_.empty() || !std::isfinite(tws_kn)) return {};
+  const double r = std::clamp(tws_kn, 0.0, max_tws_) / kTwsStep;
+  const int r0 = std::min(static_cast<int>(r), row_count_ - 2);
+  const double f = r - r0;
+  const Targets& a = rows_[static_cast<std::size_t>(r0)].*which;
+  const Targets& b = rows_[static_cast<std::size_t>(r0) + 1].*which;
+  // A row without a target (TWS 0) takes its neighbour's angle rather
+  // than dragging the blend toward 0 degrees.
+  const double a_twa = a.bsp_kn > 0.0 ? a.twa_deg : b.twa_deg;
+  return {a_twa + f * (b.twa_deg - a_twa), a.bsp_kn + f * (b.bsp_kn - a.bsp_kn),
+          a.vmg_kn + f * (b.vmg_kn - a.vmg_kn)};
+}
+
+PolarTable::Targets PolarTable::upwind(double tws_kn) const { return blend_(tws_kn, &Row::up); }
+
+PolarTable::Targets PolarTable::downwind(double tws_kn) const { return blend_(tws_kn, &Row::down); }
+
+PolarTable::Targets PolarTable::targets(double tws_kn, double twa_deg) const {
+  return fold_twa(twa_deg) < 90.0 ? upwind(tws_kn) : downwind(tws_kn);
+}
+
+PolarScore score_against_polar(const PolarTable& polar, const TrueWindBatch& batch) {
+  const std::size_t n = std::min({batch.size(), batch.twa_deg.size(), batch.tws_kn.size()});
+  constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+
+  PolarScore s;
+  for (auto* v : {&s.target_bsp_kn, &s.bsp_pct, &s.vmg_kn, &s.target_vmg_kn, &s.vmg_pct}) v->resize(n);
+
+  for (std::size_t i = 0; i < n; ++i) {
+    const double twa = batch.twa_deg[i], tws = batch.tws_kn[i], stw = batch.stw_kn[i];
+    const double target = polar.boat_speed(tws, twa);
+    const double vmg = stw * std::cos(twa * kDegToRad);
+    const bool upwind = fold_twa(twa) < 90.0;
+    const PolarTable::Targets t = upwind ? polar.upwind(tws) : polar.downwind(tws);
+    const double target_vmg = upwind ? t.vmg_kn : -t.vmg_kn;
+
+    s.vmg_kn[i] = static_cast<float>(vmg);
+    s.target_bsp_kn[i] = target > 0.0 ? static_cast<float>(target) : kNaN;
+    s.bsp_pct[i] = target > 0.0 ? static_cast<float>(100.0 * stw / target) : kNaN;
+    s.target_vmg_kn[i] = t.vmg_kn > 0.0 ? static_cast<float>(target_vmg) : kNaN;
+    s.vmg_pct[i] = t.vmg_kn > 0.0 ? static_cast<float>(100.0 * vmg / target_vmg) : kNaN;
+  }
+  return s;
+}
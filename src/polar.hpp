@@ -0,0 +1,94 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct TrueWindBatch;
+
+// Boat polar: target boat speed by true wind speed and angle.
+//
+// The source table is resampled once into a dense regular grid (every
+// kTwsStep knots of TWS, every degree of TWA), so a lookup is an index
+// computation plus one bilinear blend: no search through the source
+// table's irregular rows and columns. Each grid row also holds the optimal
+// upwind and downwind VMG angles for its TWS.
+//
+// Between source points speeds are bilinear. Below the lowest TWA or TWS
+// in the file they fall linearly to zero at 0; above the highest they are
+// held. Angles are symmetric: -40 is 40 on port.
+//
+// Immutable after load; lookups are const and may run on any thread.
+class PolarTable {
+public:
+  static constexpr double kTwsStep = 0.25;  // knots per grid row
+  static constexpr double kTwaStep = 1.0;   // degrees per grid column
+  static constexpr int kTwaCols = 181;      // 0..180
+
+  struct Targets {
+    double twa_deg = 0.0;  // best VMG angle (0..180)
+    double bsp_kn  = 0.0;  // boat speed at that angle
+    double vmg_kn  = 0.0;  // its velocity made good, toward (upwind) or away from the wind
+  };
+
+  // Grid file with TWS across the first row and TWA down the first column,
+  // as written by most polar tools (.pol, .csv, .txt):
+  //
+  //   twa/tws   6    8    10   12
+  //   52        5.6  6.5  7.0  7.3
+  //   60        5.9  6.8  7.3  7.5
+  //   ...
+  //
+  // Cells are separated by tabs, spaces, commas or semicolons; the first
+  // cell is ignored, and an empty or zero cell means "no data" (it is
+  // interpolated from its column). Lines starting with '#' are comments.
+  bool load(const std::string& path, std::string* error = nullptr);
+  bool parse(std::string_view text, std::string* error = nullptr);
+
+  // From already parsed points: speeds[i * tws.size() + j] is the boat
+  // speed at twa[i], tws[j]. Both axes ascending.
+  bool build(std::vector<double> twa_deg, std::vector<double> tws_kn, std::vector<double> speeds,
+             std::string* error = nullptr);
+
+  bool empty() const { return grid_.empty(); }
+  double max_tws_kn() const { return max_tws_; }
+  double max_speed_kn() const { return max_speed_; }
+
+  // Target boat speed; O(1).
+  double boat_speed(double tws_kn, double twa_deg) const;
+  // Best VMG angle and speed at this TWS, interpolated between grid rows; O(1).
+  Targets upwind(double tws_kn) const;
+  Targets downwind(double tws_kn) const;
+  // upwind() for |twa| < 90, downwind() otherwise.
+  Targets targets(double tws_kn, double twa_deg) const;
+
+private:
+  struct Row {
+    Targets up;
+    Targets down;
+  };
+
+  Targets blend_(double tws_kn, Targets Row::*which) const;
+
+  std::vector<float> grid_;  // row_count_ x kTwaCols, row-major
+  std::vector<Row> rows_;
+  int row_count_ = 0;
+  double max_tws_ = 0.0;
+  double max_speed_ = 0.0;
+};
+
+// Per-sample performance of a log against a polar, as columns parallel to
+// the batch (NaN where the polar has no target, e.g. TWS 0).
+struct PolarScore {
+  std::vector<float> target_bsp_kn;  // polar speed at the sample's TWS and TWA
+  std::vector<float> bsp_pct;        // STW / target, in percent
+  std::vector<float> vmg_kn;         // STW * cos(TWA): + upwind, - downwind
+  std::vector<float> target_vmg_kn;  // best VMG on the current leg (signed like vmg_kn)
+  std::vector<float> vmg_pct;        // vmg / target vmg, in percent
+
+  std::size_t size() const { return target_bsp_kn.size(); }
+};
+
+// One pass over a computed batch (TrueWindBatch::compute() must have run).
+PolarScore score_against_polar(const PolarTable& polar, const TrueWindBatch& batch);
@@ -0,0 +1,99 @@
+#include "raster_pool.hpp"
+
+#include <utility>
+
+RasterPool::RasterPool(unsigned threads) {
+  if (threads == 0) {
+    // hardware_concurrency() is 0 when unknown.
+    const unsigned hc = std::thread::hardware_concurrency();
+    threads = hc > 1 ? hc - 1 : 1;
+  }
+  queues_.reserve(threads);
+  for (unsigned i = 0; i < threads; ++i) queues_.push_back(std::make_unique<Queue>());
+  workers_.reserve(threads);
+  for (unsigned i = 0; i < threads; ++i) workers_.emplace_back([this, i] { run_(i); });
+}
+
+RasterPool::~RasterPool() {
+  {
+    std::lock_guard lock(mutex_);
+    stopping_ = true;
+  }
+  wake_.notify_all();
+  for (auto& t : workers_) t.join();
+}
+
+void RasterPool::submit(std::size_t affinity, Job job) {
+  Queue& q = *queues_[affinity % queues_.size()];
+  {
+    std::lock_guard lock(q.mutex);
+    q.jobs.push_back(std::move(job));
+  }
+  {
+    std::lock_guard lock(mutex_);
+    ++queued_;
+  }
+  wake_.notify_one();
+}
+
+void RasterPool::wait_idle() {
+  std::unique_lock lock(mutex_);
+  idle_.wait(lock, [this] { return queued_ == 0 && running_ == 0; });
+}
+
+RasterPool::Stats RasterPool::stats() const {
+  return {jobs_.load(std::memory_order_relaxed), steals_.load(std::memory_order_relaxed)};
+}
+
+// The caller has claimed one of the queued jobs, so some queue holds one.
+RasterPool::Job RasterPool::take_(std::size_t index) {
+  const std::size_t n = queues_.size();
+  for (;;) {
+    // Own queue oldest first, keeping a gauge's frames in order.
+    {
+      Queue& q = *queues_[index];
+      std::lock_guard lock(q.mutex);
+      if (!q.jobs.empty()) {
+        Job job = std::move(q.jobs.front());
+        q.jobs.pop_front();
+        return job;
+      }
+    }
+    // Steal from the far end, away from where the owner is taking.
+    for (std::size_t k = 1; k < n; ++k) {
+      Queue& q = *queues_[(index + k) % n];
+      std::lock_guard lock(q.mutex);
+      if (!q.jobs.empty()) {
+        Job job = std::move(q.jobs.back());
+        q.jobs.pop_back();
+        steals_.fetch_add(1, std::memory_order_relaxed);
+        return job;
+      }
+    }
+    // Another worker took the job this scan was heading for; theirs is still queued.
+    std::this_thread::yield();
+  }
+}
+
+void RasterPool::run_(std::size_t index) {
+  for (;;) {
+    {
+      std::unique_lock lock(mutex_);
+      wake_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+      if (queued_ == 0) return;  // stopping, and nothing left to run
+      --queued_;
+      ++running_;
+    }
+
+    take_(index)();
+    jobs_.fetch_add(1, std::memory_order_relaxed);
+
+    bool idle = false;
+    {
+      std::lock_guard lock(mutex_);
+      --running_;
+      idle = queued_ == 0 && running_ == 0;
+    }
+    if (idle) idle_.notify_all();
+  }
+}
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Worker threads that rasterize gauges off the UI thread (see
+// CircularGauge::set_raster_pool()).
+//
+// Every worker has its own queue. submit() puts a job on the queue its
+// affinity picks, so one gauge's frames keep landing on the same worker
+// (and on that thread's Pango font map, see GaugeTextCache). A worker
+// whose queue runs dry steals from the back of the others', so a slow
+// gauge never leaves the rest of the pool idle while frames are pending.
+//
+// Thread-safe. Jobs must not throw.
+class RasterPool {
+public:
+  using Job = std::function<void()>;
+
+  struct Stats {
+    std::uint64_t jobs   = 0;  // finished
+    std::uint64_t steals = 0;  // of those, run by a worker other than their own
+  };
+
+  // 0: one worker per hardware thread, less one for the UI thread.
+  explicit RasterPool(unsigned threads = 0);
+  // Finishes the queued jobs, then joins the workers.
+  ~RasterPool();
+
+  RasterPool(const RasterPool&) = delete;
+  RasterPool& operator=(const RasterPool&) = delete;
+
+  unsigned threads() const { return static_cast<unsigned>(workers_.size()); }
+
+  // Affinity for a new gauge: round-robin over the workers.
+  std::size_t next_affinity() { return next_affinity_.fetch_add(1, std::memory_order_relaxed); }
+
+  void submit(std::size_t affinity, Job job);
+
+  // Blocks until every job submitted so far has finished. For benchmarks
+  // and tests; the UI thread never needs to wait.
+  void wait_idle();
+
+  Stats stats() const;
+
+private:
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Job> jobs;
+  };
+
+  void run_(std::size_t index);
+  Job take_(std::size_t index);
+
+  std::vector<std::unique_ptr<Queue>> queues_;
+  std::vector<std::thread> workers_;
+
+  std::mutex mutex_;
+  std::condition_variable wake_;
+  std::condition_variable idle_;
+  std::size_t queued_  = 0;  // submitted and not yet claimed by a worker
+  std::size_t running_ = 0;
+  bool stopping_ = false;
+
+  std::atomic<std::size_t> next_affinity_{0};
+  std::atomic<std::uint64_t> jobs_{0};
+  std::atomic<std::uint64_t> steals_{0};
+};
@@ -0,0 +1,83 @@
+#include "render_profiler.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+const char* to_string(RenderPhase phase) {
+  switch (phase) {
+    case RenderPhase::face:       return "face";
+    case RenderPhase::ring:       return "ring";
+    case RenderPhase::zones:      return "zones";
+    case RenderPhase::ticks:      return "ticks";
+    case RenderPhase::labels:     return "labels";
+    case RenderPhase::title_unit: return "title/unit";
+    case RenderPhase::dial_blit:  return "dial blit";
+    case RenderPhase::readout:    return "readout";
+    case RenderPhase::marks:      return "marks";
+    case RenderPhase::needle:     return "needle";
+  }
+  return "?";
+}
+
+// Values 0..3 get their own buckets; above that each octave [2^e, 2^(e+1))
+// splits into four by the two bits below the leading one.
+int LatencyHistogram::bucket_(std::uint64_t ns) {
+  if (ns < 4) return static_cast<int>(ns);
+  const int e = std::bit_width(ns) - 1;  // >= 2
+  const int sub = static_cast<int>((ns >> (e - 2)) & 3);
+  return std::min(kBuckets - 1, (e - 1) * 4 + sub);
+}
+
+std::uint64_t LatencyHistogram::bucket_mid_(int b) {
+  if (b < 4) return static_cast<std::uint64_t>(b);
+  const int e = b / 4 + 1;
+  const std::uint64_t sub = static_cast<std::uint64_t>(b % 4);
+  const std::uint64_t lo = (4 + sub) << (e - 2);
+  return lo + ((std::uint64_t{1} << (e - 2)) >> 1);
+}
+
+void LatencyHistogram::add(std::int64_t ns) {
+  ns = std::max<std::int64_t>(0, ns);
+  ++counts_[bucket_(static_cast<std::uint64_t>(ns))];
+  ++count_;
+  sum_ns_ += static_cast<std::uint64_t>(ns);
+  max_ns_ = std::max(max_ns_, ns);
+}
+
+std::int64_t LatencyHistogram::percentile_ns(double p) const {
+  if (count_ == 0) return 0;
+  const auto rank = static_cast<std::uint64_t>(std::ceil(std::clamp(p, 0.0, 1.0) * static_cast<double>(count_)));
+  std::uint64_t seen = 0;
+  for (int b = 0; b < kBuckets; ++b) {
+    seen += counts_[b];
+    if (seen >= std::max<std::uint64_t>(rank, 1)) {
+      return std::min(static_cast<std::int64_t>(bucket_mid_(b)), max_ns_);
+    }
+  }
+  return max_ns_;
+}
+
+void RenderProfiler::reset() {
+  for (auto& h : phases_) h.reset();
+  frames_.reset();
+}
+
+RenderProfiler::Summary RenderProfiler::summarize(const LatencyHistogram& h) {
+  Summary s;
+  s.count    = h.count();
+  s.mean_ms  = h.mean_ns() / 1e6;
+  s.p50_ms   = static_cast<double>(h.percentile_ns(0.50)) / 1e6;
+  s.p99_ms   = static_cast<double>(h.percentile_ns(0.99)) / 1e6;
+  s.max_ms   = static_cast<double>(h.max_ns()) / 1e6;
+  s.total_ms = static_cast<double>(h.total_ns()) / 1e6;
+  return s;
+}
+
+RenderPhase RenderProfiler::most_expensive() const {
+  std::size_t best = 0;
+  for (std::size_t i = 1; i < kRenderPhaseCount; ++i) {
+    if (phases_[i].total_ns() > phases_[best].total_ns()) best = i;
+  }
+  return static_cast<RenderPhase>(best);
+}
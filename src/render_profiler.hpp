@@ -0,0 +1,123 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+// Stages of one gauge render. Dial phases run only when the dial raster is
+// re-rendered (style, size, zones... changed); the rest run every frame.
+enum class RenderPhase : std::uint8_t {
+  face,        // background + face disc
+  ring,
+  zones,
+  ticks,
+  labels,
+  title_unit,
+  dial_blit,   // painting the cached dial
+  readout,
+  marks,
+  needle,
+};
+
+inline constexpr std::size_t kRenderPhaseCount = 10;
+
+const char* to_string(RenderPhase phase);
+
+// Log-linear latency histogram: 4 buckets per power of two (values within
+// ~12% of the truth), fixed size, no allocation.
+class LatencyHistogram {
+public:
+  static constexpr int kBuckets = 160;  // up to ~2^40 ns
+
+  void add(std::int64_t ns);
+  void reset() { *this = LatencyHistogram{}; }
+
+  std::uint64_t count() const { return count_; }
+  std::int64_t total_ns() const { return static_cast<std::int64_t>(sum_ns_); }
+  double mean_ns() const { return count_ ? static_cast<double>(sum_ns_) / static_cast<double>(count_) : 0.0; }
+  std::int64_t max_ns() const { return max_ns_; }
+  // p in [0, 1]; bucket midpoint, clamped to the observed maximum.
+  std::int64_t percentile_ns(double p) const;
+
+private:
+  static int bucket_(std::uint64_t ns);
+  static std::uint64_t bucket_mid_(int bucket);
+
+  std::array<std::uint32_t, kBuckets> counts_{};
+  std::uint64_t count_ = 0;
+  std::uint64_t sum_ns_ = 0;
+  std::int64_t max_ns_ = 0;
+};
+
+// Per-gauge render timings: one histogram per phase plus the whole draw.
+// Owned by the widget; faces only hold a pointer while profiling is on, so
+// the disabled cost is a null check per phase.
+class RenderProfiler {
+public:
+  // Times the enclosing scope into `phase`; does nothing when p is null.
+  class Scope {
+  public:
+    Scope(RenderProfiler* p, RenderPhase phase) : p_(p), phase_(phase) {
+      if (p_) t0_ = clock::now();
+    }
+    ~Scope() {
+      if (p_) p_->add(phase_, std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0_).count());
+    }
+
+    Scope(const Scope&) = delete;
+    Scope& operator=(const Scope&) = delete;
+
+  private:
+    using clock = std::chrono::steady_clock;
+    RenderProfiler* p_;
+    RenderPhase phase_;
+    clock::time_point t0_{};
+  };
+
+  // Times a whole draw (all phases plus overhead).
+  class FrameScope {
+  public:
+    explicit FrameScope(RenderProfiler* p) : p_(p) {
+      if (p_) t0_ = clock::now();
+    }
+    ~FrameScope() {
+      if (p_) p_->add_frame(std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - t0_).count());
+    }
+
+    FrameScope(const FrameScope&) = delete;
+    FrameScope& operator=(const FrameScope&) = delete;
+
+  private:
+    using clock = std::chrono::steady_clock;
+    RenderProfiler* p_;
+    clock::time_point t0_{};
+  };
+
+  struct Summary {
+    std::uint64_t count = 0;
+    double mean_ms = 0.0;
+    double p50_ms = 0.0;
+    double p99_ms = 0.0;
+    double max_ms = 0.0;
+    double total_ms = 0.0;
+  };
+
+  void add(RenderPhase phase, std::int64_t ns) { phases_[static_cast<std::size_t>(phase)].add(ns); }
+  void add_frame(std::int64_t ns) { frames_.add(ns); }
+  void reset();
+
+  const LatencyHistogram& phase(RenderPhase p) const { return phases_[static_cast<std::size_t>(p)]; }
+  const LatencyHistogram& frames() const { return frames_; }
+
+  static Summary summarize(const LatencyHistogram& h);
+  Summary phase_summary(RenderPhase p) const { return summarize(phase(p)); }
+  Summary frame_summary() const { return summarize(frames_); }
+
+  // Phase with the largest accumulated time (what to optimize first).
+  RenderPhase most_expensive() const;
+
+private:
+  std::array<LatencyHistogram, kRenderPhaseCount> phases_{};
+  LatencyHistogram frames_;
+};
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// Single-writer "latest value" slot. The writer never blocks or waits for
+// readers; readers retry if they raced with a write. The payload is stored as
+// relaxed atomic words so concurrent access is well-defined.
+template <class T>
+class SeqLock {
+  static_assert(std::is_trivially_copyable_v<T>, "SeqLock payload must be trivially copyable");
+
+public:
+  // Sequence 0 means "never written"; C++20 atomics start zeroed.
+  SeqLock() = default;
+
+  // Writer side (one thread only).
+  void store(const T& v) {
+    std::uint64_t buf[kWords] = {};
+    std::memcpy(buf, &v, sizeof(T));
+
+    const std::uint64_t s = seq_.load(std::memory_order_relaxed);
+    seq_.store(s + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i = 0; i < kWords; ++i) words_[i].store(buf[i], std::memory_order_relaxed);
+    seq_.store(s + 2, std::memory_order_release);
+  }
+
+  // Reader side (any thread). Returns the sequence number of the copy;
+  // it only grows, so callers can detect "nothing new since last time".
+  std::uint64_t load(T& out) const {
+    std::uint64_t buf[kWords];
+    std::uint64_t s0 = 0;
+    std::uint64_t s1 = 0;
+    do {
+      s0 = seq_.load(std::memory_order_acquire);
+      if (s0 & 1u) continue;
+      for (std::size_t i = 0; i < kWords; ++i) buf[i] = words_[i].load(std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_acquire);
+      s1 = seq_.load(std::memory_order_relaxed);
+    } while ((s0 & 1u) || s0 != s1);
+
+    std::memcpy(&out, buf, sizeof(T));
+    return s0;
+  }
+
+  std::uint64_t sequence() const { return seq_.load(std::memory_order_acquire); }
+
+private:
+  static constexpr std::size_t kWords = (sizeof(T) + sizeof(std::uint64_t) - 1) / sizeof(std::uint64_t);
+
+  std::atomic<std::uint64_t> seq_{0};
+  std::atomic<std::uint64_t> words_[kWords];
+};
@@ -0,0 +1,163 @@
+#include "snapshot_gauge.hpp"
+
+#include <algorithm>
+#include <numbers>
+#include <optional>
+#include <utility>
+
+namespace {
+
+// Records Cairo drawing into a new cairo render node covering `bounds`.
+template <class Draw>
+GskRenderNode* record_cairo_node(double x, double y, double w, double h, Draw&& draw) {
+  graphene_rect_t bounds;
+  graphene_rect_init(&bounds, static_cast<float>(x), static_cast<float>(y),
+                     static_cast<float>(w), static_cast<float>(h));
+
+  GskRenderNode* node = gsk_cairo_node_new(&bounds);
+  // The wrapper takes over the reference returned by get_draw_context().
+  auto cr = Cairo::make_refptr_for_instance<Cairo::Context>(
+      new Cairo::Context(gsk_cairo_node_get_draw_context(node), true));
+  draw(cr);
+  return node;
+}
+
+} // namespace
+
+SnapshotGauge::SnapshotGauge()
+: SnapshotGauge(std::make_unique<GaugeFace>()) {}
+
+SnapshotGauge::SnapshotGauge(std::unique_ptr<GaugeFace> face)
+: Glib::ObjectBase("SnapshotGauge"),
+  GaugeControl(*this, std::move(face)) {}
+
+SnapshotGauge::~SnapshotGauge() = default;
+
+void SnapshotGauge::measure_vfunc(Gtk::Orientation /*orientation*/, int /*for_size*/,
+                                  int& minimum, int& natural,
+                                  int& minimum_baseline, int& natural_baseline) const {
+  // Same default as CircularGauge's content size.
+  minimum = 0;
+  natural = 260;
+  minimum_baseline = -1;
+  natural_baseline = -1;
+}
+
+void SnapshotGauge::rebuild_dial_(int width, int height, int scale) {
+  const auto& surface = face().dial_surface(width, height, scale);
+
+  GBytes* bytes = g_bytes_new(surface->get_data(),
+                              static_cast<gsize>(surface->get_stride()) * surface->get_height());
+  GdkTexture* texture = gdk_memory_texture_new(surface->get_width(), surface->get_height(),
+                                               GDK_MEMORY_DEFAULT, bytes,
+                                               static_cast<gsize>(surface->get_stride()));
+  g_bytes_unref(bytes);
+
+  graphene_rect_t bounds;
+  graphene_rect_init(&bounds, 0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height));
+  dial_node_.reset(gsk_texture_node_new(texture, &bounds));
+  g_object_unref(texture);
+
+  dial_generation_ = face().dial_generation();
+  node_width_  = width;
+  node_height_ = height;
+  node_scale_  = scale;
+
+  rebuild_dynamic_(width, height);
+}
+
+void SnapshotGauge::rebuild_dynamic_(int width, int height) {
+  // The needle's look depends on style and radius: a new dial, or a style
+  // change that left the dial alone (e.g. a new needle colour).
+  const double r = GaugeFace::radius_for(width, height);
+  needle_node_.reset(record_cairo_node(-r, -r, 2.0 * r, 2.0 * r, [&](const auto& cr) {
+    face().draw_needle(cr, 0.0, 0.0, r, 0.0);
+  }));
+  needle_xform_node_.reset();
+  style_generation_ = face().style_generation();
+
+  // Readout and marks depend on the radius and style too.
+  readout_node_.reset();
+  mark_nodes_.clear();
+  marks_recorded_.clear();
+}
+
+void SnapshotGauge::rebuild_readout_(int width, int height, const GaugeFace::Text& text) {
+  readout_node_.reset(record_cairo_node(0.0, 0.0, width, height, [&](const auto& cr) {
+    face().draw_readout(cr, width, height);
+  }));
+  readout_text_ = text;
+}
+
+void SnapshotGauge::update_marks_(int width, int height) {
+  const auto& marks = face().marks();
+  mark_nodes_.resize(marks.size());
+  marks_recorded_.resize(marks.size());
+
+  std::optional<RenderProfiler::Scope> timed;  // one sample per frame that records any
+  for (std::size_t i = 0; i < marks.size(); ++i) {
+    const auto& m = marks[i];
+    if (mark_nodes_[i] && marks_recorded_[i] == m) continue;
+    if (!timed) timed.emplace(face().profiler(), RenderPhase::marks);
+
+    const GaugeFace::Box b = face().mark_bounds(width, height, m);
+    mark_nodes_[i].reset(b.empty() ? nullptr
+                                   : record_cairo_node(b.x0, b.y0, b.x1 - b.x0, b.y1 - b.y0, [&](const auto& cr) {
+                                       face().draw_mark(cr, width, height, m);
+                                     }));
+    marks_recorded_[i] = m;
+  }
+}
+
+void SnapshotGauge::rebuild_needle_(double cx, double cy, double angle_rad) {
+  graphene_point_t center;
+  graphene_point_init(&center, static_cast<float>(cx), static_cast<float>(cy));
+
+  GskTransform* t = gsk_transform_translate(nullptr, &center);
+  t = gsk_transform_rotate(t, static_cast<float>(angle_rad * 180.0 / std::numbers::pi));
+  needle_xform_node_.reset(gsk_transform_node_new(needle_node_.get(), t));
+  gsk_transform_unref(t);
+
+  needle_xform_angle_ = angle_rad;
+}
+
+void SnapshotGauge::snapshot_vfunc(const Glib::RefPtr<Gtk::Snapshot>& snapshot) {
+  const int width  = get_width();
+  const int height = get_height();
+  if (width <= 0 || height <= 0) return;
+
+  const int scale = std::max(1, get_scale_factor());
+  GtkSnapshot* s = snapshot->gobj();
+  RenderProfiler::FrameScope timed(face().profiler());
+
+  if (!dial_node_ || face().dial_dirty() || face().dial_generation() != dial_generation_ ||
+      width != node_width_ || height != node_height_ || scale != node_scale_) {
+    rebuild_dial_(width, height, scale);
+  } else if (face().style_generation() != style_generation_) {
+    rebuild_dynamic_(width, height);
+  }
+  gtk_snapshot_append_node(s, dial_node_.get());
+
+  const GaugeFace::Text text = face().readout_text();
+  if (!readout_node_ || text != readout_text_) rebuild_readout_(width, height, text);
+  gtk_snapshot_append_node(s, readout_node_.get());
+
+  update_marks_(width, height);
+  const auto& marks = face().marks();
+  std::size_t i = 0;
+  for (; i < marks.size() && !marks[i].over_needle(); ++i) {
+    if (mark_nodes_[i]) gtk_snapshot_append_node(s, mark_nodes_[i].get());
+  }
+
+  const double angle = face().needle_angle_rad();
+  if (!needle_xform_node_ || angle != needle_xform_angle_) rebuild_needle_(width * 0.5, height * 0.5, angle);
+  if (face().stale()) gtk_snapshot_push_opacity(s, GaugeFace::kStaleAlpha);
+  gtk_snapshot_append_node(s, needle_xform_node_.get());
+  if (face().stale()) gtk_snapshot_pop(s);
+
+  for (; i < marks.size(); ++i) {
+    if (mark_nodes_[i]) gtk_snapshot_append_node(s, mark_nodes_[i].get());
+  }
+
+  note_drawn();
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "gauge_control.hpp"
+
+#include <gtkmm.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Render-node gauge: builds GSK nodes in snapshot_vfunc() instead of
+// drawing through a Cairo draw func.
+//
+//  - dial:    texture node wrapping the face's cached dial raster; rebuilt
+//             only when that raster is (style/range/zones/labels/size/scale)
+//  - readout: cairo node, re-recorded only when the readout text changes
+//  - marks:   one cairo node per mark, covering just that mark; only marks
+//             that changed are re-recorded, so moving one of several
+//             indicators records one small node
+//  - needle:  cairo node drawn once pointing along +x at the origin, emitted
+//             through a transform node that is rebuilt only when the angle
+//             changes; redrawn with the dial or a style change the dial
+//             doesn't show
+//
+// A texture node is a plain blit for the cairo GSK renderer and stays
+// resident on the GPU renderers, so the dial is never re-rasterized per frame.
+class SnapshotGauge : public Gtk::Widget, public GaugeControl {
+public:
+  SnapshotGauge();
+  explicit SnapshotGauge(std::unique_ptr<GaugeFace> face);
+  ~SnapshotGauge() override;
+
+protected:
+  void measure_vfunc(Gtk::Orientation orientation, int for_size,
+                     int& minimum, int& natural,
+                     int& minimum_baseline, int& natural_baseline) const override;
+  void snapshot_vfunc(const Glib::RefPtr<Gtk::Snapshot>& snapshot) override;
+
+private:
+  struct NodeUnref {
+    void operator()(GskRenderNode* n) const { gsk_render_node_unref(n); }
+  };
+  using NodePtr = std::unique_ptr<GskRenderNode, NodeUnref>;
+
+  void rebuild_dial_(int width, int height, int scale);
+  void rebuild_dynamic_(int width, int height);  // needle node; drops readout and marks
+  void rebuild_readout_(int width, int height, const GaugeFace::Text& text);
+  void update_marks_(int width, int height);
+  void rebuild_needle_(double cx, double cy, double angle_rad);
+
+  NodePtr dial_node_;
+  std::uint64_t dial_generation_ = 0;
+  int node_width_  = 0;
+  int node_height_ = 0;
+  int node_scale_  = 0;
+
+  NodePtr needle_node_;  // untransformed: hub at origin, pointing along +x
+  NodePtr needle_xform_node_;
+  double needle_xform_angle_ = 0.0;
+  std::uint64_t style_generation_ = 0;  // of the face, when the needle node was drawn
+
+  NodePtr readout_node_;
+  GaugeFace::Text readout_text_;
+
+  std::vector<NodePtr> mark_nodes_;  // parallel to marks_recorded_; null for a mark with no extent
+  std::vector<GaugeFace::Mark> marks_recorded_;
+};
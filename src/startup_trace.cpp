@@ -0,0 +1,80 @@
+#include "startup_trace.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+
+namespace startup_trace {
+namespace {
+
+struct Span {
+  const char* name = nullptr;
+  const char* note = nullptr;
+  std::int64_t begin_us = 0;
+  std::int64_t end_us = 0;
+};
+
+constexpr std::size_t kMaxSpans = 32;
+
+std::atomic<bool> g_enabled{false};
+std::mutex g_mutex;
+std::int64_t g_t0_us = 0;
+std::array<Span, kMaxSpans> g_spans;
+std::size_t g_count = 0;
+
+// Caller holds g_mutex.
+bool seen_(const char* name) {
+  for (std::size_t i = 0; i < g_count; ++i) {
+    if (std::strcmp(g_spans[i].name, name) == 0) return true;
+  }
+  return false;
+}
+
+void add_(const char* name, std::int64_t begin_us, const char* note, bool once) {
+  if (!enabled()) return;
+  const std::int64_t end = now_us();
+  std::lock_guard lock(g_mutex);
+  if (g_count == kMaxSpans || (once && seen_(name))) return;
+  g_spans[g_count++] = Span{name, note, begin_us, end};
+}
+
+} // namespace
+
+void start(std::int64_t t0_us) {
+  std::lock_guard lock(g_mutex);
+  g_t0_us = t0_us;
+  g_count = 0;
+  g_enabled.store(true, std::memory_order_release);
+}
+
+bool enabled() { return g_enabled.load(std::memory_order_acquire); }
+
+std::int64_t now_us() {
+  timespec ts{};
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return static_cast<std::int64_t>(ts.tv_sec) * 1'000'000 + ts.tv_nsec / 1000;
+}
+
+void phase(const char* name, std::int64_t begin_us) { add_(name, begin_us, nullptr, false); }
+
+void first(const char* name, std::int64_t begin_us, const char* note) { add_(name, begin_us, note, true); }
+
+void report(const char* milestone) {
+  if (!g_enabled.exchange(false, std::memory_order_acq_rel)) return;
+  const std::int64_t end = now_us();
+  std::lock_guard lock(g_mutex);
+
+  auto ms = [](std::int64_t us) { return static_cast<double>(us) / 1000.0; };
+  std::fprintf(stderr, "startup trace (ms since start):\n");
+  for (std::size_t i = 0; i < g_count; ++i) {
+    const Span& s = g_spans[i];
+    std::fprintf(stderr, "  %8.2f .. %8.2f  %7.2f  %s%s%s\n", ms(s.begin_us - g_t0_us), ms(s.end_us - g_t0_us),
+                 ms(s.end_us - s.begin_us), s.name, s.note ? "  " : "", s.note ? s.note : "");
+  }
+  std::fprintf(stderr, "  %8.2f              %s\n", ms(end - g_t0_us), milestone);
+}
+
+} // namespace startup_trace
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+// Cold-start timeline: how long after process start each startup phase
+// (GTK init, font setup, first dial, first present) ran, printed once to
+// stderr. Off until start() is called; a disabled call is one atomic load.
+//
+// Thread-safe, but meant for the UI thread.
+namespace startup_trace {
+
+// Enables tracing; times are relative to `t0_us` (monotonic, e.g. now_us()
+// at the top of main).
+void start(std::int64_t t0_us);
+bool enabled();
+
+// Monotonic microseconds (g_get_monotonic_time's clock).
+std::int64_t now_us();
+
+// Records a phase that ran from `begin_us` until now.
+void phase(const char* name, std::int64_t begin_us);
+// Like phase(), but only the first call for `name` counts (e.g. the first
+// dial, whichever gauge renders it). `note` is appended in the report.
+void first(const char* name, std::int64_t begin_us, const char* note = nullptr);
+
+// Prints the timeline to stderr, ending with `milestone` at now, and stops
+// tracing. Later calls do nothing.
+void report(const char* milestone);
+
+} // namespace startup_trace
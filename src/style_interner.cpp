@@ -0,0 +1,78 @@
+#include "style_interner.hpp"
+
+#include <iterator>
+#include <memory>
+#include <string>
+
+std::size_t hash_value(const Gdk::RGBA& c) {
+  const std::hash<double> h;
+  std::size_t seed = h(c.get_red());
+  hash_combine(seed, h(c.get_green()));
+  hash_combine(seed, h(c.get_blue()));
+  hash_combine(seed, h(c.get_alpha()));
+  return seed;
+}
+
+std::size_t hash_value(const GaugeFace::Style& s) {
+  const std::hash<double> h;
+  std::size_t seed = h(s.start_deg);
+  hash_combine(seed, h(s.end_deg));
+  hash_combine(seed, std::hash<int>{}(s.major_ticks));
+  hash_combine(seed, std::hash<int>{}(s.minor_ticks));
+  hash_combine(seed, h(s.value_precision));
+  hash_combine(seed, h(s.ring_width_frac));
+  hash_combine(seed, h(s.tick_len_major_frac));
+  hash_combine(seed, h(s.tick_len_minor_frac));
+  hash_combine(seed, h(s.label_radius_frac));
+  hash_combine(seed, h(s.value_radius_frac));
+  hash_combine(seed, h(s.zone_width_mul));
+  hash_combine(seed, h(s.zone_radius_mul));
+  for (const auto* c : {&s.bg, &s.ring, &s.face, &s.tick, &s.text, &s.subtext, &s.needle, &s.hub}) {
+    hash_combine(seed, hash_value(*c));
+  }
+  hash_combine(seed, std::hash<std::string>{}(s.font_family));
+  return seed;
+}
+
+std::size_t hash_value(const GaugeFace::Zone& z) {
+  const std::hash<double> h;
+  std::size_t seed = h(z.from_value);
+  hash_combine(seed, h(z.to_value));
+  hash_combine(seed, hash_value(z.color));
+  hash_combine(seed, h(z.alpha));
+  return seed;
+}
+
+std::size_t hash_value(const GaugeFace::ZoneRamp& r) {
+  const std::hash<double> h;
+  std::size_t seed = h(r.alpha);
+  for (const auto& c : r.buckets) hash_combine(seed, hash_value(c));
+  for (const auto& s : r.stops) {
+    hash_combine(seed, h(s.value));
+    hash_combine(seed, hash_value(s.color));
+  }
+  return seed;
+}
+
+GaugeFace::SharedStyle StyleInterner::intern(const GaugeFace::Style& style) {
+  auto& bucket = by_hash_[hash_value(style)];
+  for (const auto& s : bucket) {
+    if (*s == style) return s;
+  }
+  bucket.push_back(std::make_shared<const GaugeFace::Style>(style));
+  ++count_;
+  return bucket.back();
+}
+
+std::size_t StyleInterner::purge() {
+  std::size_t dropped = 0;
+  for (auto it = by_hash_.begin(); it != by_hash_.end();) {
+    auto& bucket = it->second;
+    const auto n = bucket.size();
+    std::erase_if(bucket, [](const GaugeFace::SharedStyle& s) { return s.use_count() == 1; });
+    dropped += n - bucket.size();
+    it = bucket.empty() ? by_hash_.erase(it) : std::next(it);
+  }
+  count_ -= dropped;
+  return dropped;
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "gauge_face.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+// Hash helpers for gauge model values (interning, dial cache keys).
+inline void hash_combine(std::size_t& seed, std::size_t v) {
+  seed ^= v + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2);
+}
+std::size_t hash_value(const Gdk::RGBA& c);
+std::size_t hash_value(const GaugeFace::Style& s);
+std::size_t hash_value(const GaugeFace::Zone& z);
+std::size_t hash_value(const GaugeFace::ZoneRamp& r);
+
+// Flyweight pool of immutable gauge styles. intern() returns the one shared
+// instance equal to the given style, so N gauges with the same look hold N
+// pointers to a single Style instead of N copies, and dial cache lookups
+// between them compare equal by pointer.
+//
+// Not thread-safe; use from the UI thread.
+class StyleInterner {
+public:
+  GaugeFace::SharedStyle intern(const GaugeFace::Style& style);
+
+  // Number of distinct styles held.
+  std::size_t size() const { return count_; }
+
+  // Drops styles no longer referenced outside the pool; returns how many.
+  std::size_t purge();
+
+private:
+  std::unordered_map<std::size_t, std::vector<GaugeFace::SharedStyle>> by_hash_;
+  std::size_t count_ = 0;
+};
@@ -0,0 +1,116 @@
+#include "theme_file.hpp"
+
+#include <glibmm/keyfile.h>
+
+namespace {
+
+constexpr unsigned kDebounceMs = 100;
+
+struct ColorKey {
+  const char* group;
+  const char* key;
+  Gdk::RGBA SailTheme::*panel = nullptr;
+  Gdk::RGBA GaugeFace::Style::*gauge = nullptr;
+};
+
+constexpr ColorKey kColorKeys[] = {
+    {"panel", "background", &SailTheme::panel_bg},
+    {"panel", "zone-red", &SailTheme::accent_red},
+    {"panel", "zone-green", &SailTheme::accent_green},
+    {"panel", "zone-no-go", &SailTheme::accent_no_go},
+    {"panel", "gust", &SailTheme::accent_gust},
+    {"panel", "lull", &SailTheme::accent_lull},
+    {"panel", "true-wind", &SailTheme::accent_true_wind},
+    {"panel", "target", &SailTheme::accent_target},
+    {"gauge", "background", nullptr, &GaugeFace::Style::bg},
+    {"gauge", "face", nullptr, &GaugeFace::Style::face},
+    {"gauge", "ring", nullptr, &GaugeFace::Style::ring},
+    {"gauge", "tick", nullptr, &GaugeFace::Style::tick},
+    {"gauge", "text", nullptr, &GaugeFace::Style::text},
+    {"gauge", "subtext", nullptr, &GaugeFace::Style::subtext},
+    {"gauge", "needle", nullptr, &GaugeFace::Style::needle},
+    {"gauge", "hub", nullptr, &GaugeFace::Style::hub},
+};
+
+bool has_key(const Glib::RefPtr<Glib::KeyFile>& kf, const char* group, const char* key) {
+  return kf->has_group(group) && kf->has_key(group, key);
+}
+
+} // namespace
+
+bool load_sail_theme(const std::string& path, SailTheme& theme, std::string* error) {
+  auto fail = [&](const std::string& what) {
+    if (error) *error = path + ": " + what;
+    return false;
+  };
+
+  auto kf = Glib::KeyFile::create();
+  try {
+    kf->load_from_file(path);
+  } catch (const Glib::Error& e) {
+    return fail(e.what());
+  }
+
+  // Parse into a copy: a bad value leaves the caller's theme untouched.
+  SailTheme t = theme;
+  for (const auto& c : kColorKeys) {
+    if (!has_key(kf, c.group, c.key)) continue;
+    Gdk::RGBA color;
+    const Glib::ustring text = kf->get_string(c.group, c.key);
+    if (!color.set(text)) return fail(std::string("[") + c.group + "] " + c.key + ": bad colour '" + text + "'");
+    if (c.panel) t.*c.panel = color;
+    else t.gauge.style.*c.gauge = color;
+  }
+  if (has_key(kf, "gauge", "font")) t.gauge.style.font_family = kf->get_string("gauge", "font");
+
+  theme = std::move(t);
+  return true;
+}
+
+bool ThemeFileWatcher::watch(const std::string& path, const SailTheme& base, Apply apply, std::string* error) {
+  stop();
+  path_ = path;
+  base_ = base;
+  apply_ = std::move(apply);
+  if (!reload_(error)) return false;
+
+  try {
+    // Watching the file (not a descriptor) follows editors that save by
+    // renaming a new file over it.
+    monitor_ = Gio::File::create_for_path(path_)->monitor_file(Gio::FileMonitor::Flags::WATCH_MOVES);
+  } catch (const Glib::Error& e) {
+    if (error) *error = path_ + ": " + e.what();
+    return false;
+  }
+  monitor_->signal_changed().connect(sigc::mem_fun(*this, &ThemeFileWatcher::on_changed_));
+  return true;
+}
+
+void ThemeFileWatcher::stop() {
+  debounce_.disconnect();
+  if (monitor_) {
+    monitor_->cancel();
+    monitor_.reset();
+  }
+}
+
+void ThemeFileWatcher::on_changed_(const Glib::RefPtr<Gio::File>& /*file*/,
+                                   const Glib::RefPtr<Gio::File>& /*other*/,
+                                   Gio::FileMonitor::Event event) {
+  // A save arrives as several events; deleted alone means "wait for the new one".
+  if (event == Gio::FileMonitor::Event::DELETED || event == Gio::FileMonitor::Event::ATTRIBUTE_CHANGED) return;
+
+  debounce_.disconnect();
+  debounce_ = Glib::signal_timeout().connect([this] {
+    std::string err;
+    if (!reload_(&err) && on_error_) on_error_(err);
+    return false;
+  }, kDebounceMs);
+}
+
+bool ThemeFileWatcher::reload_(std::string* error) {
+  SailTheme t = base_;
+  if (!load_sail_theme(path_, t, error)) return false;
+  if (apply_) apply_(t);
+  return true;
+}
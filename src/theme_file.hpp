@@ -0,0 +1,59 @@
+#pragma once
+
+#include "wind_instrument.hpp"
+
+#include <giomm.h>
+#include <functional>
+#include <string>
+
+// SailTheme in a key file, e.g.:
+//
+//   [panel]
+//   background=#0b0e12
+//   zone-red=#ff3b30
+//
+//   [gauge]
+//   needle=#ff453a
+//   font=Sans
+//
+// Keys: [panel] background, zone-red, zone-green, zone-no-go, gust, lull,
+// true-wind, target; [gauge] background, face, ring, tick, text, subtext, needle,
+// hub (colours as CSS strings) and font. Keys left out keep the values of
+// the theme passed in, so a night theme can list only what it changes.
+bool load_sail_theme(const std::string& path, SailTheme& theme, std::string* error = nullptr);
+
+// Reloads a theme file whenever it changes on disk. Events are debounced,
+// so an editor's save (often a write plus a rename) reloads once. A file
+// that fails to parse keeps the current theme. Callbacks run on the main
+// loop.
+class ThemeFileWatcher {
+public:
+  using Apply = std::function<void(const SailTheme&)>;
+  using Error = std::function<void(const std::string&)>;
+
+  ThemeFileWatcher() = default;
+  ~ThemeFileWatcher() { stop(); }
+
+  ThemeFileWatcher(const ThemeFileWatcher&) = delete;
+  ThemeFileWatcher& operator=(const ThemeFileWatcher&) = delete;
+
+  // Loads `path` over `base` and passes the result to `apply`, then again
+  // after every change. Returns false if the first load or the monitor fails.
+  bool watch(const std::string& path, const SailTheme& base, Apply apply, std::string* error = nullptr);
+  void stop();
+
+  void set_error_handler(Error fn) { on_error_ = std::move(fn); }
+
+private:
+  void on_changed_(const Glib::RefPtr<Gio::File>& file, const Glib::RefPtr<Gio::File>& other,
+                   Gio::FileMonitor::Event event);
+  bool reload_(std::string* error);
+
+  std::string path_;
+  SailTheme base_;
+  Apply apply_;
+  Error on_error_;
+
+  Glib::RefPtr<Gio::FileMonitor> monitor_;
+  sigc::connection debounce_;
+};
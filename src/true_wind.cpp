@@ -0,0 +1,235 @@
+#include "true_wind.hpp"
+
+#include "log_replay.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+constexpr std::size_t kChunk = 256;
+constexpr float kTwoPi = 2.0f * std::numbers::pi_v<float>;
+constexpr float kRadToDeg = 180.0f / std::numbers::pi_v<float>;
+
+// All helpers are branch-free (selects only) so loops using them vectorize.
+
+// Nearest integer for |x| < 2^31, via truncation (cvttps2dq on plain SSE2).
+inline float round_nearest(float x) {
+  return static_cast<float>(static_cast<int>(x + (x >= 0.0f ? 0.5f : -0.5f)));
+}
+
+// sin(2*pi*t) for t in turns; reduced to a quarter turn, odd Taylor to x^9.
+inline float sin_turns(float t) {
+  t -= round_nearest(t);                  // [-0.5, 0.5]
+  t = t >  0.25f ?  0.5f - t : t;         // sin(pi - x) = sin(x)
+  t = t < -0.25f ? -0.5f - t : t;
+  const float x  = t * kTwoPi;            // [-pi/2, pi/2]
+  const float x2 = x * x;
+  return x * (1.0f + x2 * (-1.0f / 6.0f + x2 * (1.0f / 120.0f + x2 * (-1.0f / 5040.0f + x2 * (1.0f / 362880.0f)))));
+}
+
+inline float sin_deg(float d) { return sin_turns(d * (1.0f / 360.0f)); }
+inline float cos_deg(float d) { return sin_turns(d * (1.0f / 360.0f) + 0.25f); }
+
+// atan2 in degrees; Abramowitz & Stegun 4.4.49 on [0, 1], error ~1e-5 rad.
+inline float atan2_deg(float y, float x) {
+  const float ax = std::fabs(x);
+  const float ay = std::fabs(y);
+  const float hi = std::max(ax, ay);
+  const float lo = std::min(ax, ay);
+  const float a  = lo / (hi > 0.0f ? hi : 1.0f);
+  const float s  = a * a;
+  float r = a * (0.9998660f + s * (-0.3302995f + s * (0.1801410f + s * (-0.0851330f + s * 0.0208351f))));
+  r = ay > ax ? 0.5f * std::numbers::pi_v<float> - r : r;
+  r = x < 0.0f ? std::numbers::pi_v<float> - r : r;
+  r = y < 0.0f ? -r : r;
+  return r * kRadToDeg;
+}
+
+inline float wrap_360(float d) {
+  d -= 360.0f * round_nearest(d * (1.0f / 360.0f) - 0.5f);
+  return d >= 360.0f ? d - 360.0f : (d < 0.0f ? d + 360.0f : d);
+}
+
+// Kernel stages. Restrict-qualified parameters (rather than locals) are what
+// lets the compiler drop runtime alias checks and vectorize the loops.
+
+void leeway_from_heel(std::size_t m, float k, const float* __restrict heel,
+                      const float* __restrict stw, float* __restrict leeway) {
+  for (std::size_t i = 0; i < m; ++i) {
+    const float v2 = std::max(stw[i] * stw[i], 0.25f);  // below 0.5 kn leeway is meaningless
+    leeway[i] = std::clamp(k * heel[i] / v2, -20.0f, 20.0f);
+  }
+}
+
+void cross_scale(std::size_t m, const float* __restrict heel, float* __restrict cross) {
+  for (std::size_t i = 0; i < m; ++i) cross[i] = 1.0f / std::max(cos_deg(heel[i]), 0.5f);
+}
+
+void over_water(std::size_t m,
+                const float* __restrict awa, const float* __restrict aws,
+                const float* __restrict stw, const float* __restrict hdg,
+                const float* __restrict leeway, const float* __restrict cross,
+                float* __restrict twa, float* __restrict tws, float* __restrict twd,
+                float* __restrict ax_out, float* __restrict ay_out) {
+  for (std::size_t i = 0; i < m; ++i) {
+    const float ax = aws[i] * cos_deg(awa[i]);
+    const float ay = aws[i] * sin_deg(awa[i]) * cross[i];
+    const float tx = ax - stw[i] * cos_deg(leeway[i]);
+    const float ty = ay - stw[i] * sin_deg(leeway[i]);
+
+    const float a = atan2_deg(ty, tx);
+    twa[i] = a;
+    tws[i] = std::sqrt(tx * tx + ty * ty);
+    twd[i] = wrap_360(hdg[i] + a);
+    ax_out[i] = ax;
+    ay_out[i] = ay;
+  }
+}
+
+void over_ground(std::size_t m,
+                 const float* __restrict hdg, const float* __restrict cog,
+                 const float* __restrict sog, const float* __restrict ax,
+                 const float* __restrict ay, float* __restrict twd) {
+  for (std::size_t i = 0; i < m; ++i) {
+    const float ch = cos_deg(hdg[i]);
+    const float sh = sin_deg(hdg[i]);
+    const float north = ax[i] * ch - ay[i] * sh - sog[i] * cos_deg(cog[i]);
+    const float east  = ax[i] * sh + ay[i] * ch - sog[i] * sin_deg(cog[i]);
+    twd[i] = wrap_360(atan2_deg(east, north));
+  }
+}
+
+} // namespace
+
+void compute_true_wind(const TrueWindInput& in, const TrueWindOutput& out, const TrueWindConfig& config) {
+  const std::size_t n = in.awa_deg.size();
+  const bool has_heel   = !in.heel_deg.empty();
+  const bool has_ground = !in.cog_deg.empty() && !in.sog_kn.empty();
+
+  // Per-chunk scratch; lives on the stack so the live path never allocates.
+  alignas(64) float leeway[kChunk];
+  alignas(64) float cross[kChunk];  // cross-wind scale from heel
+  alignas(64) float ax[kChunk];
+  alignas(64) float ay[kChunk];
+
+  for (std::size_t off = 0; off < n; off += kChunk) {
+    const std::size_t m = std::min(kChunk, n - off);
+
+    if (!in.leeway_deg.empty()) {
+      std::copy_n(in.leeway_deg.data() + off, m, leeway);
+    } else if (config.leeway_hook) {
+      config.leeway_hook(in, off, std::span<float>(leeway, m));
+    } else if (has_heel && config.leeway_k != 0.0f) {
+      leeway_from_heel(m, config.leeway_k, in.heel_deg.data() + off, in.stw_kn.data() + off, leeway);
+    } else {
+      std::fill_n(leeway, m, 0.0f);
+    }
+
+    if (has_heel && config.heel_correct_awa) cross_scale(m, in.heel_deg.data() + off, cross);
+    else                                     std::fill_n(cross, m, 1.0f);
+
+    over_water(m, in.awa_deg.data() + off, in.aws_kn.data() + off, in.stw_kn.data() + off,
+               in.heading_deg.data() + off, leeway, cross,
+               out.twa_deg.data() + off, out.tws_kn.data() + off, out.twd_deg.data() + off, ax, ay);
+
+    if (has_ground) {
+      over_ground(m, in.heading_deg.data() + off, in.cog_deg.data() + off, in.sog_kn.data() + off,
+                  ax, ay, out.twd_deg.data() + off);
+    }
+  }
+}
+
+TrueWind true_wind_one(double awa_deg, double aws_kn, double stw_kn, double heading_deg,
+                       double heel_deg, bool has_ground, double cog_deg, double sog_kn,
+                       const TrueWindConfig& config) {
+  const float awa = static_cast<float>(awa_deg);
+  const float aws = static_cast<float>(aws_kn);
+  const float stw = static_cast<float>(stw_kn);
+  const float hdg = static_cast<float>(heading_deg);
+  const float heel = static_cast<float>(heel_deg);
+  const float cog = static_cast<float>(cog_deg);
+  const float sog = static_cast<float>(sog_kn);
+
+  TrueWindInput in;
+  in.awa_deg     = {&awa, 1};
+  in.aws_kn      = {&aws, 1};
+  in.stw_kn      = {&stw, 1};
+  in.heading_deg = {&hdg, 1};
+  in.heel_deg    = {&heel, 1};
+  if (has_ground) {
+    in.cog_deg = {&cog, 1};
+    in.sog_kn  = {&sog, 1};
+  }
+
+  float twa = 0.0f, tws = 0.0f, twd = 0.0f;
+  compute_true_wind(in, {{&twa, 1}, {&tws, 1}, {&twd, 1}}, config);
+  return {twa, tws, twd};
+}
+
+void TrueWindBatch::clear() {
+  for (auto* v : {&awa_deg, &aws_kn, &stw_kn, &heading_deg, &cog_deg, &sog_kn, &twa_deg, &tws_kn, &twd_deg}) {
+    v->clear();
+  }
+  time_us.clear();
+  has_ground = false;
+}
+
+void TrueWindBatch::reserve(std::size_t n) {
+  for (auto* v : {&awa_deg, &aws_kn, &stw_kn, &heading_deg, &cog_deg, &sog_kn}) v->reserve(n);
+  time_us.reserve(n);
+}
+
+bool TrueWindBatch::append(const WindSample& s) {
+  if (!s.has_wind() || !s.has_boat()) return false;
+
+  time_us.push_back(s.time_us);
+  awa_deg.push_back(static_cast<float>(s.awa_deg));
+  aws_kn.push_back(static_cast<float>(s.aws_kn));
+  stw_kn.push_back(static_cast<float>(s.stw_kn));
+  heading_deg.push_back(static_cast<float>(s.heading_deg));
+  cog_deg.push_back(static_cast<float>(s.has_ground ? s.cog_deg : s.heading_deg));
+  sog_kn.push_back(static_cast<float>(s.has_ground ? s.sog_kn : s.stw_kn));
+  has_ground |= s.has_ground;
+  return true;
+}
+
+TrueWindInput TrueWindBatch::input() const {
+  TrueWindInput in;
+  in.awa_deg     = awa_deg;
+  in.aws_kn      = aws_kn;
+  in.stw_kn      = stw_kn;
+  in.heading_deg = heading_deg;
+  if (has_ground) {
+    in.cog_deg = cog_deg;
+    in.sog_kn  = sog_kn;
+  }
+  return in;
+}
+
+void TrueWindBatch::compute(const TrueWindConfig& config) {
+  twa_deg.resize(size());
+  tws_kn.resize(size());
+  twd_deg.resize(size());
+  compute_true_wind(input(), {twa_deg, tws_kn, twd_deg}, config);
+}
+
+TrueWindBatch true_wind_from_log(const LogReader& log) {
+  TrueWindBatch batch;
+  WindSample s;
+  bool pending = false;  // apparent wind seen at s.time_us; emit once the timestamp moves on
+
+  for (std::size_t i = 0; i < log.size(); ++i) {
+    const auto& r = log[i];
+    if (pending && r.time_us != s.time_us) {
+      batch.append(s);
+      pending = false;
+    }
+    if (!instlog::apply(r, s)) continue;
+    const auto ch = static_cast<instlog::Channel>(r.channel);
+    pending |= (ch == instlog::Channel::awa_deg || ch == instlog::Channel::aws_kn);
+  }
+  if (pending) batch.append(s);
+  return batch;
+}
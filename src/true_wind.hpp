@@ -0,0 +1,100 @@
+#pragma once
+
+#include "wind_sample.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <vector>
+
+class LogReader;
+
+// True wind from apparent wind and boat motion.
+//
+// Conventions: angles in degrees, AWA/TWA in -180..180 (starboard +),
+// heading/COG/TWD true in 0..360, speeds in knots. Heel is positive to
+// starboard; leeway is positive when the boat slides to starboard of its
+// heading.
+//
+//   apparent "from" vector (boat frame)  a = AWS * (cos AWA, sin AWA / cos heel)
+//   boat velocity through water           b = STW * (cos leeway, sin leeway)
+//   true wind over water                  t = a - b  ->  TWA, TWS, TWD = heading + TWA
+//
+// With COG/SOG, TWD is taken over ground instead: a rotated into the earth
+// frame minus the ground velocity.
+//
+// The kernel works on structure-of-arrays batches, in fixed chunks with
+// branch-free inner loops and polynomial trig, so it auto-vectorizes.
+// Angles are within ~0.005 degrees of a double-precision reference. Live
+// code uses the same kernel with a batch of one (true_wind_one()).
+
+// Input columns; all non-empty spans have the same length.
+struct TrueWindInput {
+  std::span<const float> awa_deg;
+  std::span<const float> aws_kn;
+  std::span<const float> stw_kn;
+  std::span<const float> heading_deg;
+  std::span<const float> heel_deg   = {};  // optional: heel correction and leeway model
+  std::span<const float> leeway_deg = {};  // optional: overrides the leeway model
+  std::span<const float> cog_deg    = {};  // optional, with sog_kn: TWD over ground
+  std::span<const float> sog_kn     = {};
+};
+
+struct TrueWindOutput {
+  std::span<float> twa_deg;
+  std::span<float> tws_kn;
+  std::span<float> twd_deg;
+};
+
+struct TrueWindConfig {
+  // The masthead unit heels with the rig and under-reads the cross-wind component.
+  bool heel_correct_awa = true;
+
+  // Classic leeway estimate: leeway = leeway_k * heel / STW^2 (0 disables).
+  float leeway_k = 0.0f;
+
+  // Custom leeway model, called once per chunk of `offset`..offset+out.size()
+  // samples in place of the formula above. Writes leeway in degrees.
+  std::function<void(const TrueWindInput& in, std::size_t offset, std::span<float> leeway_deg)> leeway_hook;
+};
+
+// n = in.awa_deg.size(); output spans must be at least that long.
+void compute_true_wind(const TrueWindInput& in, const TrueWindOutput& out,
+                       const TrueWindConfig& config = TrueWindConfig{});
+
+struct TrueWind {
+  double twa_deg = 0.0;
+  double tws_kn  = 0.0;
+  double twd_deg = 0.0;
+};
+
+// One live sample through the batch kernel. Pass has_ground = false to
+// ignore cog/sog.
+TrueWind true_wind_one(double awa_deg, double aws_kn, double stw_kn, double heading_deg,
+                       double heel_deg, bool has_ground, double cog_deg, double sog_kn,
+                       const TrueWindConfig& config = TrueWindConfig{});
+
+// Column storage for offline work: append samples, then compute() runs the
+// whole batch through the kernel. If some rows have ground data, the rest
+// get COG = heading and SOG = STW (no current), i.e. TWD over water.
+struct TrueWindBatch {
+  std::vector<std::int64_t> time_us;
+  std::vector<float> awa_deg, aws_kn, stw_kn, heading_deg, cog_deg, sog_kn;
+  std::vector<float> twa_deg, tws_kn, twd_deg;
+  bool has_ground = false;
+
+  std::size_t size() const { return time_us.size(); }
+  void clear();
+  void reserve(std::size_t n);
+
+  // Needs has_wind() and has_boat(); returns false (nothing added) otherwise.
+  bool append(const WindSample& s);
+
+  TrueWindInput input() const;
+  void compute(const TrueWindConfig& config = TrueWindConfig{});
+};
+
+// One row per log timestamp carrying apparent wind, once wind, STW and
+// heading have all been seen; other channels are sample-and-hold.
+TrueWindBatch true_wind_from_log(const LogReader& log);
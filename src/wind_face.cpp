@@ -0,0 +1,168 @@
+#include "wind_face.hpp"
+
+#include <cmath>
+
+namespace {
+
+// The wind and boat speed dials have a fixed sweep, so their tick
+// directions are built by the compiler (37, 41 and 17 ticks).
+constexpr auto kAngleTicks = make_tick_table<13, 2>(-270.0, 90.0);
+constexpr auto kSpeedTicks = make_tick_table<9, 4>(-225.0, 45.0);
+constexpr auto kBoatSpeedTicks = make_tick_table<9, 1>(-225.0, 45.0);
+
+static_assert(kAngleTicks.majors[6].cos > -1e-12 && kAngleTicks.majors[6].cos < 1e-12 &&
+              kAngleTicks.majors[6].sin < -0.999999, "0 deg AWA must point up");
+
+} // namespace
+
+double WindAngleFace::clamp_180(double deg) {
+  return std::clamp(deg, -180.0, 180.0);
+}
+
+WindAngleFace::WindAngleFace() {
+  set_title("APP WIND");
+  set_unit("AWA");
+  set_range(-180.0, 180.0);
+
+  Style s = style();
+  apply_geometry_overrides_(s);
+  set_style(s);
+}
+
+void WindAngleFace::apply_theme(const Theme& theme) {
+  // The 30°/10° geometry goes in before the diff, so re-theming only
+  // touches what the theme really changed.
+  Theme t = theme;
+  apply_geometry_overrides_(t.style);
+  GaugeFace::apply_theme(t);
+}
+
+void WindAngleFace::apply_geometry_overrides_(Style& s) {
+  // Full 360° dial:
+  // 0° at top (bow), +90° right, -90° left, ±180° bottom (stern).
+  s.start_deg = -90.0 - 180.0; // -270
+  s.end_deg   = -90.0 + 180.0; // +90
+
+  // Major every 30° across -180..+180 => 13 majors (12 intervals => 360/12=30°).
+  // Minor every 10° => 2 minors between majors (30/(2+1)=10°).
+  s.major_ticks = 13;
+  s.minor_ticks = 2;
+
+  // Lower the AWS readout noticeably so it doesn't get covered by the needle.
+  // (Your previous 0.28 was still close to center.)
+  s.value_radius_frac = 0.48;
+
+  s.value_precision = 0;
+}
+
+void WindAngleFace::set_angle_deg(double deg) {
+  set_value(clamp_180(deg));
+}
+
+double WindAngleFace::value_to_angle_rad(double v) const {
+  // Direct wind mapping: angle = -90° + AWA (so 0 is up)
+  const double ang_deg = -90.0 + clamp_180(v);
+  return deg_to_rad(ang_deg);
+}
+
+void WindAngleFace::format_major_label(int major_index, double major_value, Text& out) const {
+  const int v = static_cast<int>(std::lround(clamp_180(major_value)));
+
+  // Full-circle dials duplicate the endpoint at the same angle.
+  // Drop the FIRST endpoint label (-180) and keep the last (+180).
+  if (major_index == 0 && std::abs(v) == 180) return;
+
+  out.append_int(std::abs(v) == 180 ? 180 : v);
+}
+
+std::unique_ptr<GaugeFace> WindAngleFace::create_mirror() const {
+  return std::make_unique<WindAngleFace>();
+}
+
+void WindAngleFace::mirror_to(GaugeFace& mirror) const {
+  GaugeFace::mirror_to(mirror);
+  static_cast<WindAngleFace&>(mirror).set_speed_kn(speed_kn_);
+}
+
+TickDirections WindAngleFace::fixed_ticks() const {
+  return kAngleTicks;
+}
+
+void WindAngleFace::format_value_readout(double /*v*/, Text& out) const {
+  // Show speed (kn) on the wind angle gauge readout.
+  out.append_fixed(speed_kn_, 1).append(" kn");
+}
+
+// ---------------- WindSpeedFace ----------------
+
+WindSpeedFace::WindSpeedFace() {
+  set_title("WIND SPD");
+  set_unit("kn");
+  set_range(0.0, 40.0);
+
+  Style s = style();
+  apply_geometry_overrides_(s);
+  set_style(s);
+}
+
+void WindSpeedFace::apply_theme(const Theme& theme) {
+  Theme t = theme;
+  apply_geometry_overrides_(t.style);
+  GaugeFace::apply_theme(t);
+}
+
+std::unique_ptr<GaugeFace> WindSpeedFace::create_mirror() const {
+  return std::make_unique<WindSpeedFace>();
+}
+
+TickDirections WindSpeedFace::fixed_ticks() const {
+  return kSpeedTicks;
+}
+
+void WindSpeedFace::apply_geometry_overrides_(Style& s) {
+  s.start_deg = -225.0;
+  s.end_deg   =   45.0;
+
+  s.major_ticks = 9;   // 0..40 step 5
+  s.minor_ticks = 4;
+  s.value_precision = 1;
+
+  // Slightly below center for speed gauge, but not as low as wind angle readout.
+  s.value_radius_frac = 0.48;
+}
+
+// ---------------- BoatSpeedFace ----------------
+
+BoatSpeedFace::BoatSpeedFace() {
+  set_title("BOAT SPD");
+  set_unit("kn");
+  set_range(0.0, 16.0);
+
+  Style s = style();
+  apply_geometry_overrides_(s);
+  set_style(s);
+}
+
+void BoatSpeedFace::apply_theme(const Theme& theme) {
+  Theme t = theme;
+  apply_geometry_overrides_(t.style);
+  GaugeFace::apply_theme(t);
+}
+
+std::unique_ptr<GaugeFace> BoatSpeedFace::create_mirror() const {
+  return std::make_unique<BoatSpeedFace>();
+}
+
+TickDirections BoatSpeedFace::fixed_ticks() const {
+  return kBoatSpeedTicks;
+}
+
+void BoatSpeedFace::apply_geometry_overrides_(Style& s) {
+  s.start_deg = -225.0;
+  s.end_deg   =   45.0;
+
+  s.major_ticks = 9;   // 8 steps: 0..16 step 2 by default
+  s.minor_ticks = 1;
+  s.value_precision = 1;
+  s.value_radius_frac = 0.48;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "gauge_face.hpp"
+
+// Apparent wind angle: -180..+180 (port -, starboard +).
+class WindAngleFace final : public GaugeFace {
+public:
+  WindAngleFace();
+
+  void set_angle_deg(double deg); // clamps to [-180, 180]
+  void set_speed_kn(double kn) { speed_kn_ = kn; }
+  double speed_kn() const { return speed_kn_; }
+
+  // Themes keep this dial's fixed geometry (sweep, ticks, readout placement).
+  void apply_theme(const Theme& theme) override;
+
+  // Full-circle dial: -180 and +180 are the same needle position.
+  double wrap_period() const override { return 360.0; }
+
+  std::unique_ptr<GaugeFace> create_mirror() const override;
+  void mirror_to(GaugeFace& mirror) const override;  // plus the speed readout
+
+protected:
+  double value_to_angle_rad(double v) const override;
+  void format_major_label(int major_index, double major_value, Text& out) const override;
+  void format_value_readout(double v, Text& out) const override;
+  TickDirections fixed_ticks() const override;
+
+private:
+  static double clamp_180(double deg);
+  static void apply_geometry_overrides_(Style& s);
+
+  double speed_kn_ = 0.0;
+};
+
+// Wind speed gauge: standard arc gauge
+class WindSpeedFace final : public GaugeFace {
+public:
+  WindSpeedFace();
+  void set_speed_kn(double kn) { set_value(kn); }
+
+  void apply_theme(const Theme& theme) override;
+  std::unique_ptr<GaugeFace> create_mirror() const override;
+
+protected:
+  TickDirections fixed_ticks() const override;
+
+private:
+  static void apply_geometry_overrides_(Style& s);
+};
+
+// Boat speed through water, same sweep as the wind speed dial. The range
+// should span a multiple of 8 knots so the 9 majors land on whole numbers.
+class BoatSpeedFace final : public GaugeFace {
+public:
+  BoatSpeedFace();
+
+  void apply_theme(const Theme& theme) override;
+  std::unique_ptr<GaugeFace> create_mirror() const override;
+
+protected:
+  TickDirections fixed_ticks() const override;
+
+private:
+  static void apply_geometry_overrides_(Style& s);
+};
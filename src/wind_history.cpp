@@ -0,0 +1,194 @@
+#include "wind_history.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+constexpr std::int64_t kSecondUs = 1'000'000;
+constexpr std::int64_t kBaseUs   = 50'000;          // 20 Hz
+constexpr std::int64_t kSpanUs   = 24 * 3600 * kSecondUs;
+
+constexpr double kLabelWidth = 40.0;  // left gutter for channel labels
+
+struct Range {
+  const char* label;
+  std::int64_t window_us;
+};
+
+constexpr Range kRanges[] = {
+    {"1 min",  60 * kSecondUs},
+    {"10 min", 600 * kSecondUs},
+    {"1 h",    3600 * kSecondUs},
+    {"6 h",    6 * 3600 * kSecondUs},
+    {"24 h",   24 * 3600 * kSecondUs},
+};
+
+void set_source(const Cairo::RefPtr<Cairo::Context>& cr, const Gdk::RGBA& c, double alpha_mul = 1.0) {
+  cr->set_source_rgba(c.get_red(), c.get_green(), c.get_blue(), c.get_alpha() * alpha_mul);
+}
+
+} // namespace
+
+WindHistoryStrip::WindHistoryStrip()
+: Gtk::Box(Gtk::Orientation::VERTICAL),
+  awa_(kBaseUs, kSpanUs),
+  aws_(kBaseUs, kSpanUs),
+  window_us_(kRanges[1].window_us) {
+  set_spacing(4);
+
+  ranges_.set_spacing(4);
+  ranges_.set_halign(Gtk::Align::END);
+  Gtk::ToggleButton* first = nullptr;
+  for (const auto& r : kRanges) {
+    auto b = Gtk::make_managed<Gtk::ToggleButton>(r.label);
+    b->add_css_class("flat");
+    if (first) b->set_group(*first);
+    else first = b;
+    b->set_active(r.window_us == window_us_);
+    b->signal_toggled().connect([this, b, w = r.window_us] {
+      if (b->get_active()) set_window(w);
+    });
+    ranges_.append(*b);
+  }
+
+  plot_.set_content_height(120);
+  plot_.set_hexpand(true);
+  plot_.set_draw_func(sigc::mem_fun(*this, &WindHistoryStrip::on_draw_plot));
+
+  append(ranges_);
+  append(plot_);
+}
+
+void WindHistoryStrip::set_window(std::int64_t window_us) {
+  window_us_ = std::clamp<std::int64_t>(window_us, kSecondUs, kSpanUs);
+  plot_.queue_draw();  // zooming re-queries the pyramid; raw data is never rescanned
+}
+
+void WindHistoryStrip::set_colors(const Colors& c) {
+  if (c == colors_) return;
+  colors_ = c;
+  plot_.queue_draw();
+}
+
+bool WindHistoryStrip::newest_outside_drawn_(const MinMaxPyramid::Bucket& drawn, double v) const {
+  return drawn.empty() || v < drawn.min || v > drawn.max;
+}
+
+void WindHistoryStrip::push(std::int64_t time_us, double awa_deg, double aws_kn) {
+  awa_.push(time_us, awa_deg);
+  aws_.push(time_us, aws_kn);
+
+  if (drawn_latest_us_ < 0 || drawn_columns_ <= 0) {
+    plot_.queue_draw();
+    return;
+  }
+
+  const std::int64_t column_us = std::max<std::int64_t>(1, window_us_ / drawn_columns_);
+  if (awa_.latest_time_us() - drawn_latest_us_ >= column_us ||
+      newest_outside_drawn_(drawn_awa_last_, awa_deg) ||
+      newest_outside_drawn_(drawn_aws_last_, aws_kn) || aws_kn > drawn_aws_top_) {
+    plot_.queue_draw();
+  }
+}
+
+void WindHistoryStrip::draw_trace_(const Cairo::RefPtr<Cairo::Context>& cr,
+                                   const std::vector<MinMaxPyramid::Bucket>& cols,
+                                   double x, double y, double h, double lo, double hi,
+                                   bool wraps) const {
+  auto to_y = [&](double v) { return y + h - (std::clamp(v, lo, hi) - lo) / (hi - lo) * h; };
+
+  // One vertical segment per column, stretched to meet its neighbour so the
+  // trace stays connected. On a wrapping axis (AWA) jumps across ±180 are
+  // left unconnected.
+  cr->begin_new_path();
+  const MinMaxPyramid::Bucket* prev = nullptr;
+  for (std::size_t i = 0; i < cols.size(); ++i) {
+    const auto& c = cols[i];
+    if (c.empty()) {
+      prev = nullptr;
+      continue;
+    }
+
+    double top = c.max;
+    double bottom = c.min;
+    if (prev && !(wraps && std::max(std::abs(prev->min - c.max), std::abs(prev->max - c.min)) > 180.0)) {
+      bottom = std::min<double>(bottom, prev->max);
+      top = std::max<double>(top, prev->min);
+    }
+
+    const double px = x + static_cast<double>(i) + 0.5;
+    cr->move_to(px, to_y(top));
+    cr->line_to(px, to_y(bottom));
+    prev = &c;
+  }
+  cr->stroke();
+}
+
+void WindHistoryStrip::on_draw_plot(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height) {
+  const int columns = std::max(0, static_cast<int>(width - kLabelWidth));
+  if (columns <= 0 || height <= 0) return;
+
+  awa_cols_.resize(static_cast<std::size_t>(columns));
+  aws_cols_.resize(static_cast<std::size_t>(columns));
+
+  const std::int64_t t1 = std::max<std::int64_t>(awa_.latest_time_us(), 0) + 1;
+  const std::int64_t t0 = t1 - window_us_;
+  awa_.query(t0, t1, awa_cols_);
+  aws_.query(t0, t1, aws_cols_);
+
+  // AWS axis: visible maximum rounded up to 5 kn, at least 10 kn.
+  double aws_max = 0.0;
+  for (const auto& c : aws_cols_) {
+    if (!c.empty()) aws_max = std::max<double>(aws_max, c.max);
+  }
+  const double aws_top = std::max(10.0, std::ceil(aws_max / 5.0) * 5.0);
+
+  const double band_h = (height - 6.0) * 0.5;
+  const double awa_y = 0.0;
+  const double aws_y = band_h + 6.0;
+  const double x = kLabelWidth;
+
+  // Grid: AWA 0 and ±90, AWS half and full scale.
+  set_source(cr, colors_.grid);
+  cr->set_line_width(1.0);
+  for (double v : {-90.0, 0.0, 90.0}) {
+    const double gy = std::round(awa_y + band_h - (v + 180.0) / 360.0 * band_h) + 0.5;
+    cr->move_to(x, gy);
+    cr->line_to(x + columns, gy);
+  }
+  for (double f : {0.0, 0.5, 1.0}) {
+    const double gy = std::round(aws_y + band_h - f * band_h) + 0.5;
+    cr->move_to(x, gy);
+    cr->line_to(x + columns, gy);
+  }
+  cr->stroke();
+
+  // Labels
+  set_source(cr, colors_.text);
+  const double size = 10.0;
+  GaugeTextCache::show_centered(cr, text_.shape("AWA", colors_.font_family, GaugeTextCache::Weight::bold, size),
+                                kLabelWidth * 0.5, awa_y + band_h * 0.5);
+  GaugeTextCache::show_centered(cr, text_.shape("AWS", colors_.font_family, GaugeTextCache::Weight::bold, size),
+                                kLabelWidth * 0.5, aws_y + band_h * 0.5 - size * 0.7);
+  char top_label[32];
+  std::snprintf(top_label, sizeof(top_label), "%.0f kn", aws_top);
+  GaugeTextCache::show_centered(cr, text_.shape(top_label, colors_.font_family, GaugeTextCache::Weight::normal, size),
+                                kLabelWidth * 0.5, aws_y + band_h * 0.5 + size * 0.7);
+
+  // Traces
+  cr->set_line_width(1.5);
+  cr->set_line_cap(Cairo::Context::LineCap::ROUND);
+  set_source(cr, colors_.awa);
+  draw_trace_(cr, awa_cols_, x, awa_y, band_h, -180.0, 180.0, true);
+  set_source(cr, colors_.aws);
+  draw_trace_(cr, aws_cols_, x, aws_y, band_h, 0.0, aws_top, false);
+
+  drawn_latest_us_ = awa_.latest_time_us();
+  drawn_columns_   = columns;
+  drawn_aws_top_   = aws_top;
+  drawn_awa_last_  = awa_cols_.back();
+  drawn_aws_last_  = aws_cols_.back();
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "gauge_text.hpp"
+#include "minmax_pyramid.hpp"
+
+#include <gtkmm.h>
+#include <cstdint>
+#include <vector>
+
+// Trend strip for AWA and AWS over the last 1 minute to 24 hours.
+//
+// Samples go into one MinMaxPyramid per channel (20 Hz base buckets, 24 h
+// span, fixed memory). A redraw queries one min/max pair per pixel column,
+// so drawing and zooming cost O(width) however many samples the window
+// holds. Each trace is one path and one stroke.
+//
+// The right edge is the newest sample's time, so replayed logs scroll at
+// replay speed. Redraws are requested only when the plot would visibly
+// change: time advanced by a column, or a new value fell outside the
+// newest column's drawn range.
+class WindHistoryStrip final : public Gtk::Box {
+public:
+  struct Colors {
+    Gdk::RGBA grid = Gdk::RGBA("#27313b");
+    Gdk::RGBA text = Gdk::RGBA("#9fb0c3");
+    Gdk::RGBA awa  = Gdk::RGBA("#ff453a");
+    Gdk::RGBA aws  = Gdk::RGBA("#d7dee8");
+    std::string font_family = "Sans";
+
+    bool operator==(const Colors&) const = default;
+  };
+
+  WindHistoryStrip();
+
+  void push(std::int64_t time_us, double awa_deg, double aws_kn);
+
+  void set_window(std::int64_t window_us);
+  std::int64_t window() const { return window_us_; }
+
+  void set_colors(const Colors& c);
+
+private:
+  void on_draw_plot(const Cairo::RefPtr<Cairo::Context>& cr, int width, int height);
+  void draw_trace_(const Cairo::RefPtr<Cairo::Context>& cr,
+                   const std::vector<MinMaxPyramid::Bucket>& cols,
+                   double x, double y, double h, double lo, double hi, bool wraps) const;
+  bool newest_outside_drawn_(const MinMaxPyramid::Bucket& drawn, double v) const;
+
+  Gtk::Box ranges_;
+  Gtk::DrawingArea plot_;
+
+  MinMaxPyramid awa_;
+  MinMaxPyramid aws_;
+  std::int64_t window_us_;
+
+  Colors colors_;
+  GaugeTextCache text_;
+
+  // Per-draw scratch, sized to the plot width.
+  std::vector<MinMaxPyramid::Bucket> awa_cols_;
+  std::vector<MinMaxPyramid::Bucket> aws_cols_;
+
+  // What the last draw showed.
+  std::int64_t drawn_latest_us_ = -1;
+  int drawn_columns_ = 0;
+  double drawn_aws_top_ = 0.0;
+  MinMaxPyramid::Bucket drawn_awa_last_;
+  MinMaxPyramid::Bucket drawn_aws_last_;
+};
@@ -1,136 +1,89 @@
 #include "wind_instrument.hpp"
 
-#include <sstream>
-#include <iomanip>
+#include <algorithm>
+#include <array>
+#include <span>
 #include <cmath>
 #include <cstdio>
 
-double WindAngleGauge::clamp_180(double deg) {
-  return std::clamp(deg, -180.0, 180.0);
-}
-
-WindAngleGauge::WindAngleGauge() {
-  set_title("APP WIND");
-  set_unit("AWA");
-  set_range(-180.0, 180.0);
-
-  apply_geometry_overrides_();
-}
-
-void WindAngleGauge::apply_theme(const CircularGauge::Theme& theme) {
-  CircularGauge::apply_theme(theme);
-  apply_geometry_overrides_();  // re-apply 30°/10° geometry after theme overwrite
-}
-
-void WindAngleGauge::apply_geometry_overrides_() {
-  // Full 360° dial:
-  // 0° at top (bow), +90° right, -90° left, ±180° bottom (stern).
-  style().start_deg = -90.0 - 180.0; // -270
-  style().end_deg   = -90.0 + 180.0; // +90
-
-  // Major every 30° across -180..+180 => 13 majors (12 intervals => 360/12=30°).
-  // Minor every 10° => 2 minors between majors (30/(2+1)=10°).
-  style().major_ticks = 13;
-  style().minor_ticks = 2;
-
-  // Lower the AWS readout noticeably so it doesn't get covered by the needle.
-  // (Your previous 0.28 was still close to center.)
-  style().value_radius_frac = 0.48;
-
-  style().value_precision = 0;
-}
-
-void WindAngleGauge::set_angle_deg(double deg) {
-  set_value(clamp_180(deg));
-}
+// ---------------- Panel ----------------
 
-double WindAngleGauge::value_to_angle_rad(double v) const {
-  // Direct wind mapping: angle = -90° + AWA (so 0 is up)
-  const double ang_deg = -90.0 + clamp_180(v);
-  return deg_to_rad(ang_deg);
-}
+template <class Host>
+Gtk::Widget& WindInstrumentPanel::create_gauges_() {
+  auto row = Gtk::make_managed<Gtk::Box>(Gtk::Orientation::HORIZONTAL);
+  row->set_spacing(12);
 
-std::string WindAngleGauge::format_major_label(int major_index, double major_value) const {
-  const int v = static_cast<int>(std::lround(clamp_180(major_value)));
+  auto angle = Gtk::make_managed<BasicWindAngleGauge<Host>>();
+  auto speed = Gtk::make_managed<BasicWindSpeedGauge<Host>>();
+  auto boat = Gtk::make_managed<BasicBoatSpeedGauge<Host>>();
+  boat->set_visible(false);
 
-  // Full-circle dials duplicate the endpoint at the same angle.
-  // Drop the FIRST endpoint label (-180) and keep the last (+180).
-  if (major_index == 0 && std::abs(v) == 180) {
-    return std::string{};
+  for (Gtk::Widget* w : {static_cast<Gtk::Widget*>(angle), static_cast<Gtk::Widget*>(speed),
+                         static_cast<Gtk::Widget*>(boat)}) {
+    w->set_hexpand(true);
+    w->set_vexpand(true);
+    row->append(*w);
   }
 
-  if (std::abs(v) == 180) return "180";
-  return std::to_string(v);
+  angle_ = angle;
+  speed_ = speed;
+  boat_ = boat;
+  boat_widget_ = boat;
+  return *row;
 }
 
-std::string WindAngleGauge::format_value_readout(double /*v*/) const {
-  // Show speed (kn) on the wind angle gauge readout.
-  char buf[64];
-  std::snprintf(buf, sizeof(buf), "%.1f kn", speed_kn_);
-  return std::string(buf);
-}
-
-// ---------------- WindSpeedGauge ----------------
-
-WindSpeedGauge::WindSpeedGauge() {
-  set_title("WIND SPD");
-  set_unit("kn");
-  set_range(0.0, 40.0);
-
-  apply_geometry_overrides_();
-}
-
-void WindSpeedGauge::apply_theme(const CircularGauge::Theme& theme) {
-  CircularGauge::apply_theme(theme);
-  apply_geometry_overrides_();
-}
-
-void WindSpeedGauge::apply_geometry_overrides_() {
-  style().start_deg = -225.0;
-  style().end_deg   =   45.0;
-
-  style().major_ticks = 9;   // 0..40 step 5
-  style().minor_ticks = 4;
-  style().value_precision = 1;
-
-  // Slightly below center for speed gauge, but not as low as wind angle readout.
-  style().value_radius_frac = 0.48;
-}
-
-// ---------------- Panel ----------------
-
-WindInstrumentPanel::WindInstrumentPanel()
+WindInstrumentPanel::WindInstrumentPanel(Backend backend)
 : Gtk::Box(Gtk::Orientation::VERTICAL) {
   set_spacing(12);
   set_margin(16);
 
-  auto row = Gtk::make_managed<Gtk::Box>(Gtk::Orientation::HORIZONTAL);
-  row->set_spacing(12);
+  Gtk::Widget& row = (backend == Backend::render_nodes) ? create_gauges_<SnapshotGauge>()
+                                                         : create_gauges_<CircularGauge>();
 
-  angle_.set_hexpand(true);
-  angle_.set_vexpand(true);
-  speed_.set_hexpand(true);
-  speed_.set_vexpand(true);
+  // Day and night dials stay cached, so switching back is a blit.
+  for (GaugeControl* g : {angle_, speed_, boat_}) g->set_dial_cache(dial_cache_);
 
-  row->append(angle_);
-  row->append(speed_);
+  css_ = Gtk::CssProvider::create();
+  Gtk::StyleContext::add_provider_for_display(Gdk::Display::get_default(), css_,
+                                              GTK_STYLE_PROVIDER_PRIORITY_APPLICATION);
+
+  // Critically damped needles; WindAngleFace wraps, so ±180° crossings take the short way.
+  angle_->set_needle_smoothing({true, 0.25, 0.1});
+  speed_->set_needle_smoothing({true, 0.35, 0.1});
+  boat_->set_needle_smoothing({true, 0.5, 0.05});
 
   readout_.set_xalign(0.5f);
   readout_.set_margin_top(6);
   readout_.set_margin_bottom(2);
 
-  append(*row);
+  hud_.add_css_class("gauge-hud");
+  hud_.set_halign(Gtk::Align::START);
+  hud_.set_valign(Gtk::Align::START);
+  hud_.set_xalign(0.0f);
+  hud_.set_can_target(false);
+  hud_.set_visible(false);
+  gauge_overlay_.set_child(row);
+  gauge_overlay_.add_overlay(hud_);
+  signal_realize().connect(sigc::mem_fun(*this, &WindInstrumentPanel::connect_after_paint_));
+
+  append(gauge_overlay_);
   append(readout_);
+  append(history_);
 
   apply_theme(SailTheme{});
 }
 
+WindInstrumentPanel::~WindInstrumentPanel() {
+  Gtk::StyleContext::remove_provider_for_display(Gdk::Display::get_default(), css_);
+}
+
 void WindInstrumentPanel::apply_theme(const SailTheme& t) {
   theme_ = t;
 
   // These now keep their 30°/10° and readout offsets after theming
-  angle_.apply_theme(theme_.gauge);
-  speed_.apply_theme(theme_.gauge);
+  angle_->apply_theme(theme_.gauge);
+  speed_->apply_theme(theme_.gauge);
+  boat_->apply_theme(theme_.gauge);
 
   // Zones per request:
   // - no-go: -20..+20 (NOT red; "usual" caution color)
@@ -146,27 +99,329 @@ void WindInstrumentPanel::apply_theme(const SailTheme& t) {
   zones.push_back({ 160.0,  180.0, theme_.accent_no_go, 1.0 });
   zones.push_back({-180.0, -160.0, theme_.accent_no_go, 1.0 });
 
-  angle_.set_zones(std::move(zones));
-  speed_.set_zones({});
+  angle_->set_zones(std::move(zones));
+  speed_->set_zones({});
+  boat_->set_zones({});
+
+  WindHistoryStrip::Colors hc;
+  hc.grid = theme_.gauge.style.ring;
+  hc.text = theme_.gauge.style.subtext;
+  hc.awa  = theme_.gauge.style.needle;
+  hc.aws  = theme_.gauge.style.tick;
+  hc.font_family = theme_.gauge.style.font_family;
+  history_.set_colors(hc);
+  update_marks_();  // mark colours come from the theme
+
+#if GAUGES_HAVE_FRAME_RING
+  if (frame_output_) frame_output_->set_background(theme_.panel_bg);
+#endif
+
+  // Panel background via CSS. One provider per panel, reloaded in place:
+  // a provider added per theme change would pile up on the display and
+  // make every style recomputation slower.
+  const std::string css = "window, box { background-color: " + theme_.panel_bg.to_string() + "; }\n"
+                          ".gauge-hud { font-family: monospace; font-size: 10px; padding: 4px 6px;"
+                          " border-radius: 4px; background-color: rgba(0, 0, 0, 0.6); color: " +
+                          theme_.gauge.style.text.to_string() + "; }";
+  if (css != css_text_) {
+    css_text_ = css;
+    css_->load_from_data(css_text_);
+  }
+}
+
+void WindInstrumentPanel::set_deadband(const CircularGauge::Deadband& d) {
+  angle_->set_deadband(d);
+  speed_->set_deadband(d);
+  boat_->set_deadband(d);
+}
+
+void WindInstrumentPanel::set_wind(double awa_deg, double aws_kn, std::int64_t time_us) {
+  true_wind_.reset();
+  clear_perf_();
+  show_(awa_deg, aws_kn, time_us);
+}
+
+void WindInstrumentPanel::set_sample(const WindSample& s) {
+  if (s.has_boat()) {
+    // No live heel source yet; leeway still applies through the config hook.
+    true_wind_ = true_wind_one(s.awa_deg, s.aws_kn, s.stw_kn, s.heading_deg, 0.0,
+                               s.has_ground, s.cog_deg, s.sog_kn, true_wind_config_);
+  } else {
+    true_wind_.reset();
+  }
+  update_perf_(s);
+  show_(s.awa_deg, s.aws_kn, s.time_us);
+}
+
+void WindInstrumentPanel::set_polar(std::shared_ptr<const PolarTable> polar) {
+  polar_ = std::move(polar);
+  clear_perf_();
+  boat_widget_->set_visible(static_cast<bool>(polar_));
+  if (!polar_) return;
+  // 8 major steps of whole knots, with headroom over the fastest target.
+  const double top = 8.0 * std::max(1.0, std::ceil(polar_->max_speed_kn() * 1.2 / 8.0));
+  boat_->set_range(0.0, top);
+}
+
+// Two O(1) polar lookups per sample (see PolarTable), cheap at sensor rate.
+void WindInstrumentPanel::update_perf_(const WindSample& s) {
+  if (!polar_ || !true_wind_ || !s.has_stw) {
+    clear_perf_();
+    return;
+  }
+  Performance p;
+  p.stw_kn = s.stw_kn;
+  p.target_kn = polar_->boat_speed(true_wind_->tws_kn, true_wind_->twa_deg);
+  p.vmg = polar_->targets(true_wind_->tws_kn, true_wind_->twa_deg);
+  perf_ = p;
+  polar_target_twa_ = p.vmg.bsp_kn > 0.0 ? std::optional<double>(p.vmg.twa_deg) : std::nullopt;
+}
+
+// Drops the polar's targets, so their marks don't outlive the polar or the
+// STW and true wind they were computed from.
+void WindInstrumentPanel::clear_perf_() {
+  if (!perf_ && !polar_target_twa_) return;
+  perf_.reset();
+  polar_target_twa_.reset();
+  update_marks_();
+}
+
+void WindInstrumentPanel::bind_channels(ChannelBus& bus, double max_rate_hz) {
+  binder_ = std::make_unique<ChannelBinder>(*this, bus);
+  bound_ = {};
+  bound_wind_new_ = false;
+
+  // Each channel fills its field of bound_; one frame's deliveries are then shown together.
+  auto field = [this](double WindSample::*value, bool WindSample::*has, bool wind) {
+    return [this, value, has, wind](const ChannelBinder::Reading& r) {
+      if (r.valid) bound_.*value = r.value;
+      bound_.*has = !r.stale;
+      if (wind && !r.stale) {
+        bound_.time_us = std::max(bound_.time_us, r.time_us);
+        bound_wind_new_ = true;
+      }
+    };
+  };
+  binder_->bind(channels::kWindAngleApparent, field(&WindSample::awa_deg, &WindSample::has_angle, true), max_rate_hz);
+  binder_->bind(channels::kWindSpeedApparent, field(&WindSample::aws_kn, &WindSample::has_speed, true), max_rate_hz);
+  binder_->bind(channels::kSpeedThroughWater, field(&WindSample::stw_kn, &WindSample::has_stw, false), max_rate_hz);
+  binder_->bind(channels::kHeadingTrue, field(&WindSample::heading_deg, &WindSample::has_heading, false), max_rate_hz);
+  // COG and SOG are published together, so either one's age stands for both.
+  binder_->bind(channels::kCourseOverGround, field(&WindSample::cog_deg, &WindSample::has_ground, false), max_rate_hz);
+  binder_->bind(channels::kSpeedOverGround, field(&WindSample::sog_kn, &WindSample::has_ground, false), max_rate_hz);
+  binder_->set_after_deliver([this] { show_bound_(); });
+}
 
-  // Panel background via CSS
-  auto css = Gtk::CssProvider::create();
-  const auto bg = theme_.panel_bg.to_string(); // rgba(...)
-  css->load_from_data("window, box { background-color: " + bg + "; }");
-  Gtk::StyleContext::add_provider_for_display(
-      Gdk::Display::get_default(),
-      css,
-      GTK_STYLE_PROVIDER_PRIORITY_APPLICATION
-  );
+void WindInstrumentPanel::show_bound_() {
+  angle_->set_stale(!bound_.has_angle);
+  speed_->set_stale(!bound_.has_speed);
+  boat_->set_stale(!bound_.has_stw);
+  if (!bound_wind_new_ || !bound_.has_wind()) return;
+  bound_wind_new_ = false;
+  set_sample(bound_);
 }
 
-void WindInstrumentPanel::set_wind(double awa_deg, double aws_kn) {
-  angle_.set_angle_deg(awa_deg);
-  angle_.set_speed_kn(aws_kn);  // readout on AWA gauge is AWS
-  speed_.set_speed_kn(aws_kn);
+void WindInstrumentPanel::show_(double awa_deg, double aws_kn, std::int64_t time_us) {
+  if (time_us < 0) time_us = g_get_monotonic_time();
+  history_.push(time_us, awa_deg, aws_kn);
+  stats_.push(time_us, awa_deg, aws_kn);
+  update_marks_();
+
+  // Through the face so the panel need not know which backend it built.
+  static_cast<WindAngleFace&>(angle_->face()).set_speed_kn(aws_kn);  // readout on AWA gauge is AWS
+  angle_->set_value(awa_deg);
+  speed_->set_value(aws_kn);
+  if (perf_) boat_->set_value(perf_->stw_kn);
+
+  // Built in a fixed buffer and handed to GTK only when it changed, so a
+  // steady sample costs no allocation here.
+  FixedText<192> t;
+  t.append("AWA ").append_int(std::lround(std::clamp(awa_deg, -180.0, 180.0))).append("°");
+  t.append("   |   AWS ").append_fixed(aws_kn, 1).append(" kn");
+  if (true_wind_) {
+    t.append("   |   TWA ").append_int(std::lround(true_wind_->twa_deg)).append("°");
+    t.append("  TWS ").append_fixed(true_wind_->tws_kn, 1).append(" kn");
+    t.append("  TWD ").append_int(std::lround(true_wind_->twd_deg) % 360).append("°");
+  }
+  if (perf_ && perf_->target_kn > 0.0) {
+    t.append("   |   BSP ").append_fixed(perf_->stw_kn, 1).append(" / ").append_fixed(perf_->target_kn, 1);
+    t.append(" kn  ").append_int(std::lround(100.0 * perf_->stw_kn / perf_->target_kn)).append("%");
+  }
+  if (stats_.gust() != WindStats::Gust::none) {
+    t.append(stats_.gust() == WindStats::Gust::gust ? "   |   GUST " : "   |   LULL ");
+    t.append_fixed(stats_.gust_peak_kn(), 1).append(" kn");
+  }
+  if (t == readout_text_) return;
+  readout_text_ = t;
+  // The C call takes the buffer as is; Gtk::Label::set_text() would copy it
+  // into a Glib::ustring first.
+  gtk_label_set_text(readout_.gobj(), readout_text_.c_str());
+}
+
+void WindInstrumentPanel::set_target_twa(std::optional<double> twa_deg) {
+  if (twa_deg == target_twa_) return;
+  target_twa_ = twa_deg;
+  update_marks_();
+}
+
+void WindInstrumentPanel::update_marks_() {
+  using Mark = GaugeFace::Mark;
+  const auto one_min = stats_.window(1);
+  const auto ten_min = stats_.window(2);
+  // Sectors and mean bugs need data; the needle and target marks don't.
+  const bool have_stats = one_min.count > 0;
+
+  // The 10 min sector sits under the 1 min one, fainter and wider.
+  Gdk::RGBA sector = theme_.gauge.style.subtext;
+  sector.set_alpha(sector.get_alpha() * 0.45);
+  Gdk::RGBA sector_10m = theme_.gauge.style.subtext;
+  sector_10m.set_alpha(sector_10m.get_alpha() * 0.2);
+  const Gdk::RGBA& mean_1m  = theme_.gauge.style.subtext;
+  const Gdk::RGBA& mean_10m = theme_.gauge.style.text;
+
+  std::array<Mark, 7> awa_marks;
+  std::size_t n_awa = 0;
+  if (have_stats) {
+    awa_marks[n_awa++] = {Mark::Kind::range, ten_min.awa.min_deg, ten_min.awa.max_deg, sector_10m, 1.8, -1};
+    awa_marks[n_awa++] = {Mark::Kind::range, one_min.awa.min_deg, one_min.awa.max_deg, sector};
+    awa_marks[n_awa++] = {Mark::Kind::bug,   one_min.awa.mean_deg, 0.0, mean_1m};
+    awa_marks[n_awa++] = {Mark::Kind::bug,   ten_min.awa.mean_deg, 0.0, mean_10m};
+  }
+  if (true_wind_) awa_marks[n_awa++] = {Mark::Kind::needle, true_wind_->twa_deg, 0.0, theme_.accent_true_wind};
+  // A target set by the user wins over the polar's.
+  if (const auto& target = target_twa_ ? target_twa_ : polar_target_twa_) {
+    const double t = std::abs(*target);
+    awa_marks[n_awa++] = {Mark::Kind::tick, -t, 0.0, theme_.accent_target, 1.0, 1};
+    awa_marks[n_awa++] = {Mark::Kind::tick,  t, 0.0, theme_.accent_target, 1.0, 1};
+  }
+  angle_->set_marks(std::span<const Mark>(awa_marks.data(), n_awa));
+
+  std::array<Mark, 5> aws_marks;
+  std::size_t n = 0;
+  if (have_stats) {
+    aws_marks[n++] = {Mark::Kind::range, ten_min.aws.min, ten_min.aws.max, sector_10m, 1.8, -1};
+    aws_marks[n++] = {Mark::Kind::range, one_min.aws.min, one_min.aws.max, sector};
+    aws_marks[n++] = {Mark::Kind::bug,   one_min.aws.mean, 0.0, mean_1m};
+    aws_marks[n++] = {Mark::Kind::bug,   ten_min.aws.mean, 0.0, mean_10m};
+  }
+  if (stats_.gust() != WindStats::Gust::none) {
+    const bool gust = stats_.gust() == WindStats::Gust::gust;
+    aws_marks[n++] = {Mark::Kind::bug, stats_.gust_peak_kn(), 0.0, gust ? theme_.accent_gust : theme_.accent_lull};
+  }
+  speed_->set_marks(std::span<const Mark>(aws_marks.data(), n));
 
-  std::ostringstream ss;
-  ss << "AWA " << static_cast<int>(std::lround(std::clamp(awa_deg, -180.0, 180.0))) << "°"
-     << "   |   AWS " << std::fixed << std::setprecision(1) << aws_kn << " kn";
-  readout_.set_text(ss.str());
+  if (!polar_) return;
+  std::array<Mark, 2> boat_marks;
+  std::size_t n_boat = 0;
+  if (perf_ && perf_->target_kn > 0.0) {
+    boat_marks[n_boat++] = {Mark::Kind::needle, perf_->target_kn, 0.0, theme_.accent_target};
+  }
+  if (perf_ && perf_->vmg.bsp_kn > 0.0) {
+    boat_marks[n_boat++] = {Mark::Kind::bug, perf_->vmg.bsp_kn, 0.0, theme_.accent_target};
+  }
+  boat_->set_marks(std::span<const Mark>(boat_marks.data(), n_boat));
+}
+
+// ---------------- HUD ----------------
+
+void WindInstrumentPanel::set_hud_visible(bool visible) {
+  if (visible == hud_.get_visible()) return;
+
+  for (GaugeControl* g : {angle_, speed_, boat_}) g->set_profiling(visible);
+  hud_.set_visible(visible);
+
+  hud_timer_.disconnect();
+  hud_intervals_.reset();
+  hud_last_frame_us_ = 0;
+  hud_window_start_us_ = g_get_monotonic_time();
+  connect_after_paint_();
+  if (!visible) return;
+
+  hud_.set_text("measuring…");
+  hud_timer_ = Glib::signal_timeout().connect(sigc::mem_fun(*this, &WindInstrumentPanel::on_hud_timer_), 1000);
+}
+
+// Runs after frames the window actually paints rather than driving its own
+// tick callback, which would keep an idle panel redrawing.
+void WindInstrumentPanel::connect_after_paint_() {
+  after_paint_.disconnect();
+  hud_last_frame_us_ = 0;
+
+  bool wanted = hud_.get_visible();
+#if GAUGES_HAVE_FRAME_RING
+  wanted = wanted || frame_output_;
+#endif
+  if (!wanted) return;
+  if (auto clock = get_frame_clock()) {
+    after_paint_ = clock->signal_after_paint().connect(sigc::mem_fun(*this, &WindInstrumentPanel::on_after_paint_));
+  }
+}
+
+void WindInstrumentPanel::on_after_paint_() {
+  const gint64 now = get_frame_clock()->get_frame_time();
+  if (hud_.get_visible()) on_hud_paint_(now);
+#if GAUGES_HAVE_FRAME_RING
+  if (frame_output_) frame_output_->publish(now);
+#endif
+}
+
+void WindInstrumentPanel::on_hud_paint_(gint64 now) {
+  if (hud_last_frame_us_ != 0) hud_intervals_.add((now - hud_last_frame_us_) * 1000);
+  hud_last_frame_us_ = now;
+}
+
+bool WindInstrumentPanel::on_hud_timer_() {
+  const gint64 now = g_get_monotonic_time();
+  const double window_s = std::max(1e-3, (now - hud_window_start_us_) / 1e6);
+  const auto interval = RenderProfiler::summarize(hud_intervals_);
+
+  const RenderProfiler* gauges[] = {angle_->profiler(), speed_->profiler(), boat_->profiler()};
+  double draw_p99 = 0.0;
+  std::int64_t phase_ns[kRenderPhaseCount] = {};
+  std::uint64_t phase_n[kRenderPhaseCount] = {};
+  for (const RenderProfiler* p : gauges) {
+    if (!p) continue;
+    draw_p99 = std::max(draw_p99, p->frame_summary().p99_ms);
+    for (std::size_t i = 0; i < kRenderPhaseCount; ++i) {
+      phase_ns[i] += p->phase(static_cast<RenderPhase>(i)).total_ns();
+      phase_n[i]  += p->phase(static_cast<RenderPhase>(i)).count();
+    }
+  }
+  const std::size_t top = static_cast<std::size_t>(std::max_element(phase_ns, phase_ns + kRenderPhaseCount) - phase_ns);
+
+  char buf[192];
+  std::snprintf(buf, sizeof(buf),
+                "%5.1f fps   frame p99 %5.1f ms\n"
+                "draw p99 %.2f ms   top: %s %.3f ms",
+                interval.count / window_s, interval.p99_ms, draw_p99,
+                to_string(static_cast<RenderPhase>(top)),
+                phase_n[top] ? phase_ns[top] / 1e6 / static_cast<double>(phase_n[top]) : 0.0);
+  hud_.set_text(buf);
+
+  // Frame rate and interval are per refresh; draw timings accumulate (see profiler()).
+  hud_intervals_.reset();
+  hud_window_start_us_ = now;
+  return true;
+}
+
+// ---------------- Shared-memory frame output ----------------
+
+#if GAUGES_HAVE_FRAME_RING
+bool WindInstrumentPanel::set_frame_output(const std::string& shm_name, int gauge_px, std::string* error) {
+  frame_output_.reset();
+  if (!shm_name.empty()) {
+    gauge_px = std::max(16, gauge_px);
+    auto out = std::make_unique<FrameRingOutput>();
+    if (!out->open(shm_name, gauge_px * 2, gauge_px, 1, 3, error)) {
+      connect_after_paint_();
+      return false;
+    }
+    out->set_background(theme_.panel_bg);
+    out->add_gauge(angle_->face(), angle_->face().create_mirror(), 0, 0, gauge_px, gauge_px);
+    out->add_gauge(speed_->face(), speed_->face().create_mirror(), gauge_px, 0, gauge_px, gauge_px);
+    frame_output_ = std::move(out);
+  }
+  connect_after_paint_();
+  return true;
 }
+#endif
@@ -1,6 +1,25 @@
 #pragma once
 
+#include "channel_binder.hpp"
 #include "circular_gauge.hpp"
+#include "dial_surface_cache.hpp"
+#include "fixed_text.hpp"
+#include "polar.hpp"
+#include "snapshot_gauge.hpp"
+#include "true_wind.hpp"
+#include "wind_face.hpp"
+#include "wind_history.hpp"
+#include "wind_sample.hpp"
+#include "wind_stats.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+#if GAUGES_HAVE_FRAME_RING
+#include "frame_output.hpp"
+#endif
 
 // LVGL-ish theme bundle for the demo
 struct SailTheme {
@@ -13,54 +32,190 @@ struct SailTheme {
 
   // "No-go" should be a usual caution color (not red)
   Gdk::RGBA accent_no_go = Gdk::RGBA("#ff9f0a"); // amber
-};
-
-// Apparent wind angle: -180..+180 (port -, starboard +).
-class WindAngleGauge final : public CircularGauge {
-public:
-  WindAngleGauge();
 
-  void set_angle_deg(double deg); // clamps to [-180, 180]
-  void set_speed_kn(double kn) { speed_kn_ = kn; queue_draw(); }
+  // Statistics marks
+  Gdk::RGBA accent_gust = Gdk::RGBA("#ff9f0a");
+  Gdk::RGBA accent_lull = Gdk::RGBA("#0a84ff");
 
-  // IMPORTANT: theme application overwrites style_, so we re-apply gauge geometry after theming.
-  void apply_theme(const CircularGauge::Theme& theme);
+  // True wind needle on the AWA gauge
+  Gdk::RGBA accent_true_wind = Gdk::RGBA("#64d2ff");
 
-protected:
-  double value_to_angle_rad(double v) const override;
-  std::string format_major_label(int major_index, double major_value) const override;
-  std::string format_value_readout(double v) const override;
-
-private:
-  static double clamp_180(double deg);
-  void apply_geometry_overrides_();
+  // Target angle markers on the AWA gauge
+  Gdk::RGBA accent_target = Gdk::RGBA("#30d158");
+};
 
-  double speed_kn_ = 0.0;
+// Apparent wind angle: -180..+180 (port -, starboard +).
+// Host is the widget implementation: CircularGauge or SnapshotGauge.
+template <class Host>
+class BasicWindAngleGauge final : public Host {
+public:
+  BasicWindAngleGauge() : Host(std::make_unique<WindAngleFace>()) {}
+
+  // The face clamps to [-180, 180]; going through set_value() keeps smoothing.
+  void set_angle_deg(double deg) { this->set_value(deg); }
+  void set_speed_kn(double kn) {
+    static_cast<WindAngleFace&>(this->face()).set_speed_kn(kn);
+    this->request_update();
+  }
 };
 
 // Wind speed gauge: standard arc gauge
-class WindSpeedGauge final : public CircularGauge {
+template <class Host>
+class BasicWindSpeedGauge final : public Host {
 public:
-  WindSpeedGauge();
-  void set_speed_kn(double kn) { set_value(kn); }
-
-  void apply_theme(const CircularGauge::Theme& theme);
+  BasicWindSpeedGauge() : Host(std::make_unique<WindSpeedFace>()) {}
+  void set_speed_kn(double kn) { this->set_value(kn); }
+};
 
-private:
-  void apply_geometry_overrides_();
+// Boat speed, with the polar's target speed as marks.
+template <class Host>
+class BasicBoatSpeedGauge final : public Host {
+public:
+  BasicBoatSpeedGauge() : Host(std::make_unique<BoatSpeedFace>()) {}
+  void set_speed_kn(double kn) { this->set_value(kn); }
 };
 
+using WindAngleGauge = BasicWindAngleGauge<CircularGauge>;
+using WindSpeedGauge = BasicWindSpeedGauge<CircularGauge>;
+using WindAngleSnapshotGauge = BasicWindAngleGauge<SnapshotGauge>;
+using WindSpeedSnapshotGauge = BasicWindSpeedGauge<SnapshotGauge>;
+using BoatSpeedGauge = BasicBoatSpeedGauge<CircularGauge>;
+using BoatSpeedSnapshotGauge = BasicBoatSpeedGauge<SnapshotGauge>;
+
 class WindInstrumentPanel final : public Gtk::Box {
 public:
-  WindInstrumentPanel();
-
+  // Which gauge widget implementation to build.
+  enum class Backend {
+    cairo,         // CircularGauge (Gtk::DrawingArea)
+    render_nodes,  // SnapshotGauge (GSK render nodes)
+  };
+
+  explicit WindInstrumentPanel(Backend backend = Backend::cairo);
+  ~WindInstrumentPanel() override;
+
+  // Cheap to call again: only what differs from the current theme is
+  // redone (see GaugeFace::set_style()), and the panel's CSS provider is
+  // reloaded in place. Dials of recent themes stay cached, so switching
+  // between day and night re-renders nothing after the first time.
   void apply_theme(const SailTheme& t);
-  void set_wind(double awa_deg, double aws_kn);
+  const SailTheme& theme() const { return theme_; }
+  // Persisted dial rasters (see DialDiskCache); may be shared between panels.
+  void set_dial_disk_cache(std::shared_ptr<DialDiskCache> disk) { dial_cache_->set_disk_cache(std::move(disk)); }
+  // time_us is the sample clock (WindSample::time_us); negative means now.
+  // Apparent wind only: clears any true wind shown.
+  void set_wind(double awa_deg, double aws_kn, std::int64_t time_us = -1);
+  // Apparent wind plus, when the sample carries STW and heading, true wind:
+  // TWA as a second needle on the angle gauge, TWA/TWS/TWD in the readout.
+  void set_sample(const WindSample& s);
+
+  // Pulls wind and boat motion from the bus's well-known channels (see
+  // WindChannels) instead of set_sample(): at most once per frame, and at
+  // most max_rate_hz times per second (0: every frame with new data).
+  // Stale wind greys out the gauges. Several panels, in any windows, may
+  // bind to one bus.
+  void bind_channels(ChannelBus& bus, double max_rate_hz = 0.0);
+
+  void set_true_wind_config(const TrueWindConfig& c) { true_wind_config_ = c; }
+  const std::optional<TrueWind>& true_wind() const { return true_wind_; }
+
+  // Target true wind angle (e.g. the upwind or downwind target from the
+  // polars), marked on both tacks of the angle gauge over the needles.
+  // Nullopt removes the markers, falling back to the polar's VMG angle when
+  // a polar is set. Takes precedence over the polar's target.
+  void set_target_twa(std::optional<double> twa_deg);
+  const std::optional<double>& target_twa() const { return target_twa_; }
+
+  // Boat polar. Shows the boat speed gauge: STW as the needle, the polar
+  // speed for the current TWA and TWS as a second needle, and the best VMG
+  // speed for this leg as a bug. The target TWA markers follow the polar's
+  // upwind or downwind VMG angle unless set_target_twa() set one. Null
+  // hides the gauge and drops the polar's targets again.
+  void set_polar(std::shared_ptr<const PolarTable> polar);
+  const std::shared_ptr<const PolarTable>& polar() const { return polar_; }
+
+  // Render diagnostics: turns on per-phase profiling in all gauges and
+  // overlays FPS, p99 frame interval, p99 draw time and the most expensive
+  // phase, refreshed every second. Off by default.
+  void set_hud_visible(bool visible);
+  bool hud_visible() const { return hud_.get_visible(); }
+
+#if GAUGES_HAVE_FRAME_RING
+  // Mirrors both gauges, side by side at gauge_px each, into the POSIX
+  // shared-memory frame ring `shm_name` for external displays (see
+  // FrameRingOutput). A frame is published after each window paint that
+  // changed a gauge. An empty name closes the output.
+  bool set_frame_output(const std::string& shm_name, int gauge_px = 240, std::string* error = nullptr);
+  const FrameRingOutput* frame_output() const { return frame_output_.get(); }
+#endif
+
+  GaugeControl& angle_gauge() { return *angle_; }
+  GaugeControl& speed_gauge() { return *speed_; }
+  GaugeControl& boat_speed_gauge() { return *boat_; }
+
+  // Needle deadband for all gauges (see CircularGauge::Deadband).
+  void set_deadband(const CircularGauge::Deadband& d);
+
+  // Rolling statistics over every set_wind() sample. Shown as marks: the
+  // 1 min and 10 min min/max sectors and means on both gauges, and the
+  // running gust or lull extreme on the speed gauge.
+  const WindStats& stats() const { return stats_; }
+  void set_stats_config(const WindStats::Config& c) { stats_.set_config(c); }
 
 private:
-  WindAngleGauge angle_;
-  WindSpeedGauge speed_;
+  template <class Host>
+  Gtk::Widget& create_gauges_();
+  void show_(double awa_deg, double aws_kn, std::int64_t time_us);
+  void update_perf_(const WindSample& s);
+  void show_bound_();
+  void update_marks_();
+  void clear_perf_();
+  void connect_after_paint_();
+  void on_after_paint_();
+  void on_hud_paint_(gint64 frame_time_us);
+  bool on_hud_timer_();
+
+  // Owned by the gauge row (managed widgets).
+  GaugeControl* angle_ = nullptr;
+  GaugeControl* speed_ = nullptr;
+  GaugeControl* boat_ = nullptr;
+  Gtk::Widget* boat_widget_ = nullptr;  // the same gauge; hidden without a polar
+
+  Gtk::Overlay gauge_overlay_;
+  Gtk::Label hud_;
+  sigc::connection after_paint_;  // HUD and frame output; only while either is on
+  sigc::connection hud_timer_;
+  LatencyHistogram hud_intervals_;  // frame-clock intervals since the last refresh
+  gint64 hud_last_frame_us_ = 0;
+  gint64 hud_window_start_us_ = 0;
 
   Gtk::Label readout_;
+  FixedText<192> readout_text_;  // as last set on readout_
+  WindHistoryStrip history_;
+  WindStats stats_;
+  TrueWindConfig true_wind_config_;
+  std::optional<TrueWind> true_wind_;
+  std::optional<double> target_twa_;        // set_target_twa()
+  std::optional<double> polar_target_twa_;  // VMG angle from the polar, per sample
+
+  // Boat speed against the polar, from the last sample with true wind and STW.
+  struct Performance {
+    double stw_kn = 0.0;
+    double target_kn = 0.0;     // polar speed at this TWA and TWS
+    PolarTable::Targets vmg;    // best VMG angle on this leg
+  };
+  std::shared_ptr<const PolarTable> polar_;
+  std::optional<Performance> perf_;
   SailTheme theme_;
+  Glib::RefPtr<Gtk::CssProvider> css_;  // added to the display once, reloaded by apply_theme()
+  std::string css_text_;
+  std::shared_ptr<DialSurfaceCache> dial_cache_ = std::make_shared<DialSurfaceCache>(16u << 20);
+
+  // Channel binding: one sample merged from the channels' latest values.
+  std::unique_ptr<ChannelBinder> binder_;
+  WindSample bound_;
+  bool bound_wind_new_ = false;  // AWA or AWS delivered since the last show
+
+#if GAUGES_HAVE_FRAME_RING
+  std::unique_ptr<FrameRingOutput> frame_output_;
+#endif
 };
@@ -0,0 +1,25 @@
+#pragma once
+
+#include <cstdint>
+
+// One apparent-wind observation as delivered by an instrument source, plus
+// the latest boat motion known at that time (needed for true wind).
+// Fields are optional: a sentence may carry only an angle or only a speed.
+struct WindSample {
+  std::int64_t time_us = 0;  // steady_clock, microseconds
+  double awa_deg = 0.0;      // -180..+180 (port -, starboard +)
+  double aws_kn  = 0.0;
+  bool has_angle = false;
+  bool has_speed = false;
+
+  double stw_kn      = 0.0;  // speed through water
+  double heading_deg = 0.0;  // true, 0..360
+  double cog_deg     = 0.0;  // true, 0..360
+  double sog_kn      = 0.0;
+  bool has_stw = false;
+  bool has_heading = false;
+  bool has_ground = false;   // cog_deg and sog_kn
+
+  bool has_wind() const { return has_angle && has_speed; }
+  bool has_boat() const { return has_stw && has_heading; }
+};
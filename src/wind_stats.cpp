@@ -0,0 +1,190 @@
+#include "wind_stats.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+namespace {
+
+constexpr double kDegToRad = std::numbers::pi / 180.0;
+constexpr double kRadToDeg = 180.0 / std::numbers::pi;
+
+double wrap_180(double deg) {
+  return std::remainder(deg, 360.0);  // [-180, 180]
+}
+
+} // namespace
+
+// ---------------- RollingScalar ----------------
+
+void RollingScalar::push(std::int64_t time_us, double v) {
+  const Entry e{time_us, next_seq_++, v};
+
+  samples_.push_back(e);
+  sum_ += v;
+  sum_sq_ += v * v;
+
+  while (!minq_.empty() && minq_.back().v >= v) minq_.pop_back();
+  minq_.push_back(e);
+  while (!maxq_.empty() && maxq_.back().v <= v) maxq_.pop_back();
+  maxq_.push_back(e);
+
+  // Evict everything that fell out of the window.
+  const std::int64_t cutoff = time_us - window_us_;
+  while (!samples_.empty() && samples_.front().t <= cutoff) {
+    const double old = samples_.front().v;
+    sum_ -= old;
+    sum_sq_ -= old * old;
+    samples_.pop_front();
+  }
+  if (samples_.empty()) {
+    sum_ = sum_sq_ = 0.0;  // also drops accumulated rounding error
+    minq_.clear();
+    maxq_.clear();
+    return;
+  }
+  const std::uint64_t oldest = samples_.front().seq;
+  while (minq_.front().seq < oldest) minq_.pop_front();
+  while (maxq_.front().seq < oldest) maxq_.pop_front();
+}
+
+void RollingScalar::clear() {
+  samples_.clear();
+  minq_.clear();
+  maxq_.clear();
+  sum_ = sum_sq_ = 0.0;
+}
+
+double RollingScalar::mean() const {
+  return samples_.empty() ? 0.0 : sum_ / static_cast<double>(samples_.size());
+}
+
+double RollingScalar::stddev() const {
+  const auto n = static_cast<double>(samples_.size());
+  if (n < 2.0) return 0.0;
+  const double m = sum_ / n;
+  return std::sqrt(std::max(0.0, sum_sq_ / n - m * m));
+}
+
+// ---------------- WindStats ----------------
+
+WindStats::WindStats() : WindStats(Config{}) {}
+
+WindStats::WindStats(const Config& config) {
+  set_config(config);
+}
+
+void WindStats::set_config(const Config& config) {
+  config_ = config;
+  config_.short_window = std::min(config_.short_window, kWindows - 1);
+  config_.long_window  = std::min(config_.long_window, kWindows - 1);
+
+  awa_.clear();
+  aws_.clear();
+  for (const auto w : config_.windows_us) {
+    awa_.emplace_back(w);
+    aws_.emplace_back(w);
+  }
+  clear();
+}
+
+void WindStats::clear() {
+  for (auto& a : awa_) {
+    a.unwrapped.clear();
+    a.vecs.clear();
+    a.sum_c = a.sum_s = 0.0;
+  }
+  for (auto& s : aws_) s.clear();
+  have_last_ = false;
+  gust_ = Gust::none;
+  gust_peak_kn_ = 0.0;
+}
+
+void WindStats::push(std::int64_t time_us, double awa_deg, double aws_kn) {
+  awa_deg = wrap_180(awa_deg);
+
+  // Continuous angle track: each step takes the short way round.
+  unwrapped_awa_ = have_last_ ? unwrapped_awa_ + wrap_180(awa_deg - last_awa_) : awa_deg;
+  last_awa_ = awa_deg;
+  have_last_ = true;
+
+  const double c = std::cos(awa_deg * kDegToRad);
+  const double s = std::sin(awa_deg * kDegToRad);
+
+  for (auto& a : awa_) {
+    a.unwrapped.push(time_us, unwrapped_awa_);
+
+    a.vecs.push_back({static_cast<double>(time_us), c, s});
+    a.sum_c += c;
+    a.sum_s += s;
+    const double cutoff = static_cast<double>(time_us - a.unwrapped.window_us());
+    while (!a.vecs.empty() && a.vecs.front()[0] <= cutoff) {
+      a.sum_c -= a.vecs.front()[1];
+      a.sum_s -= a.vecs.front()[2];
+      a.vecs.pop_front();
+    }
+  }
+  for (auto& w : aws_) w.push(time_us, aws_kn);
+
+  update_gust_(aws_kn);
+}
+
+WindStats::Window WindStats::window(std::size_t i) const {
+  Window w;
+  if (i >= awa_.size()) return w;
+
+  const auto& a = awa_[i];
+  const auto& s = aws_[i];
+  w.window_us = s.window_us();
+  w.count = s.count();
+  if (w.count == 0) return w;
+
+  const double n = static_cast<double>(a.vecs.size());
+  const double r = std::min(1.0, std::hypot(a.sum_c, a.sum_s) / n);
+  w.awa.resultant = r;
+  w.awa.mean_deg = std::atan2(a.sum_s, a.sum_c) * kRadToDeg;
+  w.awa.stddev_deg = r > 0.0 ? std::sqrt(-2.0 * std::log(r)) * kRadToDeg : 180.0;
+  w.awa.min_deg = wrap_180(a.unwrapped.min());
+  w.awa.max_deg = wrap_180(a.unwrapped.max());
+
+  w.aws.mean = s.mean();
+  w.aws.stddev = s.stddev();
+  w.aws.min = s.min();
+  w.aws.max = s.max();
+  return w;
+}
+
+void WindStats::update_gust_(double aws_kn) {
+  const auto& ref = aws_[config_.long_window];
+  const auto& recent = aws_[config_.short_window];
+  if (ref.count() < config_.min_reference_samples) return;
+
+  const double mean = ref.mean();
+  const double gust_at = mean + config_.gust_delta_kn;
+  const double lull_at = mean - config_.lull_delta_kn;
+
+  switch (gust_) {
+    case Gust::gust:
+      gust_peak_kn_ = std::max(gust_peak_kn_, aws_kn);
+      if (recent.max() < gust_at) gust_ = Gust::none;
+      break;
+    case Gust::lull:
+      gust_peak_kn_ = std::min(gust_peak_kn_, aws_kn);
+      if (recent.min() > lull_at) gust_ = Gust::none;
+      break;
+    case Gust::none:
+      break;
+  }
+
+  if (gust_ == Gust::none) {
+    if (aws_kn >= gust_at) {
+      gust_ = Gust::gust;
+      gust_peak_kn_ = aws_kn;
+      ++gust_count_;
+    } else if (aws_kn <= lull_at) {
+      gust_ = Gust::lull;
+      gust_peak_kn_ = aws_kn;
+      ++lull_count_;
+    }
+  }
+}
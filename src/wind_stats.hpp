@@ -0,0 +1,165 @@
+#pragma once
+
+#include "wind_sample.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Growable FIFO/deque on one contiguous buffer. Capacity doubles when full
+// and is then reused, so a window in steady state never allocates.
+template <class T>
+class SampleQueue {
+public:
+  bool empty() const { return size_ == 0; }
+  std::size_t size() const { return size_; }
+
+  T& front() { return buf_[head_]; }
+  const T& front() const { return buf_[head_]; }
+  T& back() { return buf_[(head_ + size_ - 1) & (buf_.size() - 1)]; }
+  const T& back() const { return buf_[(head_ + size_ - 1) & (buf_.size() - 1)]; }
+
+  void push_back(const T& v) {
+    if (size_ == buf_.size()) grow_();
+    buf_[(head_ + size_) & (buf_.size() - 1)] = v;
+    ++size_;
+  }
+  void pop_front() {
+    head_ = (head_ + 1) & (buf_.size() - 1);
+    --size_;
+  }
+  void pop_back() { --size_; }
+  void clear() { head_ = size_ = 0; }
+
+private:
+  void grow_() {
+    std::vector<T> next(buf_.empty() ? 16 : buf_.size() * 2);
+    for (std::size_t i = 0; i < size_; ++i) next[i] = buf_[(head_ + i) & (buf_.size() - 1)];
+    buf_.swap(next);
+    head_ = 0;
+  }
+
+  std::vector<T> buf_;  // power-of-two size
+  std::size_t head_ = 0;
+  std::size_t size_ = 0;
+};
+
+// Time-windowed mean / stddev / min / max with O(1) amortized updates:
+// running sums for the moments, monotonic queues for the extrema.
+class RollingScalar {
+public:
+  explicit RollingScalar(std::int64_t window_us) : window_us_(window_us) {}
+
+  void push(std::int64_t time_us, double v);
+  void clear();
+
+  std::int64_t window_us() const { return window_us_; }
+  std::size_t count() const { return samples_.size(); }
+  double mean() const;
+  double stddev() const;
+  double min() const { return minq_.empty() ? 0.0 : minq_.front().v; }
+  double max() const { return maxq_.empty() ? 0.0 : maxq_.front().v; }
+
+private:
+  struct Entry {
+    std::int64_t t;
+    std::uint64_t seq;
+    double v;
+  };
+
+  std::int64_t window_us_;
+  std::uint64_t next_seq_ = 0;
+  SampleQueue<Entry> samples_;
+  SampleQueue<Entry> minq_;  // increasing values
+  SampleQueue<Entry> maxq_;  // decreasing values
+  double sum_ = 0.0;
+  double sum_sq_ = 0.0;
+};
+
+// Rolling wind statistics over a few windows (10 s / 1 min / 10 min by
+// default), updated per sample in O(1) amortized.
+//
+// AWA is averaged as a vector sum of unit vectors, so -179° and +179°
+// average to 180°, not 0°; its spread is the circular standard deviation.
+// AWA min/max are taken on the unwrapped angle track, so a sector that
+// crosses ±180° stays contiguous (min may then be numerically larger than
+// max once wrapped back into -180..180).
+//
+// Gust/lull: a gust starts when AWS exceeds the long-window mean by
+// gust_delta_kn and lasts until the short window holds no such sample;
+// lulls likewise below the mean.
+class WindStats {
+public:
+  static constexpr std::size_t kWindows = 3;
+
+  struct Config {
+    std::array<std::int64_t, kWindows> windows_us = {10'000'000, 60'000'000, 600'000'000};
+    std::size_t short_window = 0;  // gust/lull persistence
+    std::size_t long_window  = 2;  // gust/lull reference mean
+    double gust_delta_kn = 5.0;
+    double lull_delta_kn = 5.0;
+    std::size_t min_reference_samples = 20;  // no events until the reference has data
+  };
+
+  struct Scalar {
+    double mean = 0.0, stddev = 0.0, min = 0.0, max = 0.0;
+  };
+  struct Angle {
+    double mean_deg = 0.0;
+    double stddev_deg = 0.0;  // circular
+    double min_deg = 0.0;
+    double max_deg = 0.0;
+    double resultant = 0.0;   // mean resultant length R in [0, 1]
+  };
+  struct Window {
+    std::int64_t window_us = 0;
+    std::size_t count = 0;
+    Angle awa;
+    Scalar aws;
+  };
+
+  enum class Gust { none, gust, lull };
+
+  WindStats();
+  explicit WindStats(const Config& config);
+
+  void set_config(const Config& config);
+  const Config& config() const { return config_; }
+
+  // Samples need an angle and a speed; time_us must not decrease.
+  void push(std::int64_t time_us, double awa_deg, double aws_kn);
+  void clear();
+
+  // O(1) snapshot of window i.
+  Window window(std::size_t i) const;
+
+  Gust gust() const { return gust_; }
+  double gust_peak_kn() const { return gust_peak_kn_; }  // extreme of the current/last event
+  std::uint64_t gust_count() const { return gust_count_; }
+  std::uint64_t lull_count() const { return lull_count_; }
+
+private:
+  struct AngleWindow {
+    explicit AngleWindow(std::int64_t w) : unwrapped(w) {}
+    RollingScalar unwrapped;  // for min/max
+    SampleQueue<std::array<double, 3>> vecs;  // {t, cos, sin}
+    double sum_c = 0.0;
+    double sum_s = 0.0;
+  };
+
+  void update_gust_(double aws_kn);
+
+  Config config_;
+  std::vector<AngleWindow> awa_;
+  std::vector<RollingScalar> aws_;
+
+  bool have_last_ = false;
+  double last_awa_ = 0.0;
+  double unwrapped_awa_ = 0.0;
+
+  Gust gust_ = Gust::none;
+  double gust_peak_kn_ = 0.0;
+  std::uint64_t gust_count_ = 0;
+  std::uint64_t lull_count_ = 0;
+};
@@ -0,0 +1,263 @@
+// Steady-state allocation test for the value update -> draw path.
+//
+// Counts operator new calls (replaced below) while:
+//   faces  - every face kind takes a new value and marks, syncs a mirror
+//            (as in raster mode) and draws both into an image surface:
+//            what a gauge's draw func runs per frame. Headless.
+//   panel  - a WindInstrumentPanel in a window takes one sample per frame,
+//            through set_sample() and through bound channels, with a polar
+//            set. Counted are the calls themselves and the frame clock's
+//            update phase, where every tick callback runs (GaugeControl,
+//            ChannelBinder delivery, WindStats, wind history, readout
+//            label). The paint phase is not counted: gtkmm wraps each draw
+//            func's cairo_t in a new Cairo::Context. Needs a display, and is
+//            skipped without one.
+//
+// Allocations inside Cairo, Pango and GTK use malloc and are not counted.
+// Exits 1 if any steady-state frame allocated.
+
+#include "gauge_face.hpp"
+#include "polar.hpp"
+#include "wind_face.hpp"
+#include "wind_instrument.hpp"
+
+#include <gtkmm.h>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <string>
+
+static std::atomic<bool> g_counting{false};
+static std::atomic<std::uint64_t> g_allocations{0};
+
+// The array and sized forms forward here.
+void* operator new(std::size_t n) {
+  if (g_counting.load(std::memory_order_relaxed)) g_allocations.fetch_add(1, std::memory_order_relaxed);
+  if (void* p = std::malloc(n ? n : 1)) return p;
+  throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+namespace {
+
+constexpr int kWarmup = 20;
+constexpr int kFrames = 200;
+
+// Counts the allocations made while alive.
+class Counting {
+public:
+  Counting() { g_counting.store(true, std::memory_order_relaxed); }
+  ~Counting() { g_counting.store(false, std::memory_order_relaxed); }
+};
+
+bool report(const char* what, std::uint64_t n) {
+  std::printf("%-28s %s (%llu allocations over %d frames)\n", what, n == 0 ? "ok" : "FAIL",
+              static_cast<unsigned long long>(n), kFrames);
+  return n == 0;
+}
+
+// ---------------- faces ----------------
+
+bool check_face(const char* what, std::unique_ptr<GaugeFace> face) {
+  constexpr int kSize = 256;
+  auto mirror = face->create_mirror();
+  auto surface = Cairo::ImageSurface::create(Cairo::Surface::Format::ARGB32, kSize, kSize);
+  auto cr = Cairo::Context::create(surface);
+
+  using Mark = GaugeFace::Mark;
+  std::array<Mark, 3> marks = {{
+      {Mark::Kind::range, 0.0, 0.0, Gdk::RGBA("#8e8e93"), 1.0, -1},
+      {Mark::Kind::needle, 0.0, 0.0, Gdk::RGBA("#0a84ff")},
+      {Mark::Kind::bug, 0.0, 0.0, Gdk::RGBA("#ff9f0a"), 1.0, 1},
+  }};
+
+  auto frame = [&](int i) {
+    const double lo = face->min_value(), span = face->max_value() - face->min_value();
+    const double s = 0.5 + 0.5 * std::sin(i * 0.05);
+    if (auto* w = dynamic_cast<WindAngleFace*>(face.get())) w->set_speed_kn(40.0 * s);
+    face->set_value(lo + span * s);
+    face->set_stale(i % 50 == 49);
+    marks[0].value = lo + span * (0.25 + 0.05 * std::sin(i * 0.03));
+    marks[0].to_value = lo + span * (0.6 + 0.05 * std::cos(i * 0.04));
+    marks[1].value = lo + span * (0.4 + 0.1 * std::sin(i * 0.02));
+    marks[2].value = lo + span * (0.7 + 0.1 * std::cos(i * 0.02));
+    face->set_marks(marks);
+
+    cr->save();
+    cr->set_operator(Cairo::Context::Operator::CLEAR);
+    cr->paint();
+    cr->restore();
+    face->draw(cr, kSize, kSize);
+    face->mirror_to(*mirror);
+    mirror->draw(cr, kSize, kSize);
+    surface->flush();
+  };
+
+  for (int i = 0; i < kWarmup; ++i) frame(i);
+  const std::uint64_t before = g_allocations.load();
+  {
+    Counting counting;
+    for (int i = 0; i < kFrames; ++i) frame(kWarmup + i);
+  }
+  return report(what, g_allocations.load() - before);
+}
+
+bool check_faces() {
+  auto circular = std::make_unique<GaugeFace>();
+  circular->set_title("ENG TEMP");
+  circular->set_unit("°C");
+  circular->set_range(40.0, 120.0);
+  circular->set_zones({{100.0, 120.0, Gdk::RGBA("#ff3b30"), 1.0}});
+
+  auto ramp = std::make_unique<GaugeFace>();
+  GaugeFace::ZoneRamp r;
+  r.stops = {{0.0, Gdk::RGBA("#ff3b30")}, {50.0, Gdk::RGBA("#34c759")}, {100.0, Gdk::RGBA("#ff9f0a")}};
+  ramp->set_zone_ramp(std::move(r));
+
+  bool ok = check_face("faces: circular", std::move(circular));
+  ok = check_face("faces: zone ramp", std::move(ramp)) && ok;
+  ok = check_face("faces: wind angle", std::make_unique<WindAngleFace>()) && ok;
+  ok = check_face("faces: wind speed", std::make_unique<WindSpeedFace>()) && ok;
+  ok = check_face("faces: boat speed", std::make_unique<BoatSpeedFace>()) && ok;
+  return ok;
+}
+
+// ---------------- panel ----------------
+
+constexpr const char* kPolar =
+    "twa/tws 6 8 10 12 16 20\n"
+    "40  4.6 5.6 6.2 6.5 6.7 6.8\n"
+    "52  5.6 6.5 7.0 7.3 7.5 7.6\n"
+    "60  5.9 6.8 7.3 7.5 7.8 8.0\n"
+    "90  6.2 7.1 7.6 7.9 8.3 8.6\n"
+    "120 5.8 6.9 7.5 7.9 8.6 9.2\n"
+    "150 4.6 5.7 6.6 7.3 8.2 9.0\n"
+    "180 3.9 4.9 5.8 6.6 7.7 8.6\n";
+
+// Counts from the end of a frame's before-paint phase to its layout phase,
+// which spans the update phase and its tick callbacks.
+struct FrameCounter {
+  std::uint64_t frames = 0;
+  static void update_begin(GdkFrameClock*, gpointer) { g_counting.store(true, std::memory_order_relaxed); }
+  static void update_end(GdkFrameClock*, gpointer) { g_counting.store(false, std::memory_order_relaxed); }
+  static void painted(GdkFrameClock*, gpointer self) { ++static_cast<FrameCounter*>(self)->frames; }
+};
+
+// Runs the main loop until one more frame was painted (or a frame's time
+// passed without one, when nothing changed).
+void pump_frame(const FrameCounter& fc) {
+  const std::uint64_t target = fc.frames + 1;
+  const gint64 give_up = g_get_monotonic_time() + 100'000;
+  while (fc.frames < target && g_get_monotonic_time() < give_up) {
+    if (!g_main_context_iteration(nullptr, FALSE)) g_usleep(500);
+  }
+}
+
+// One sample per second of sample time, starting in the future so the
+// bound channels never go stale meanwhile.
+WindSample sample(std::int64_t t0_us, int i) {
+  WindSample s;
+  s.time_us = t0_us + static_cast<std::int64_t>(i) * 1'000'000;
+  s.awa_deg = 42.0 + 8.0 * std::sin(i * 0.07);
+  s.aws_kn = 14.0 + 3.0 * std::sin(i * 0.05) + (i % 17 == 0 ? 4.0 : 0.0);
+  s.has_angle = s.has_speed = true;
+  s.stw_kn = 6.8 + 0.4 * std::sin(i * 0.03);
+  s.heading_deg = std::fmod(200.0 + 5.0 * std::sin(i * 0.02) + 360.0, 360.0);
+  s.cog_deg = s.heading_deg + 2.0;
+  s.sog_kn = s.stw_kn - 0.3;
+  s.has_stw = s.has_heading = s.has_ground = true;
+  return s;
+}
+
+bool check_panel() {
+  auto polar = std::make_shared<PolarTable>();
+  std::string err;
+  if (!polar->parse(kPolar, &err)) {
+    std::printf("panel: polar: %s\n", err.c_str());
+    return false;
+  }
+
+  ChannelBus bus;  // outlives the panel's binding
+  Gtk::Window window;
+  WindInstrumentPanel panel;
+  window.set_default_size(720, 540);
+  window.set_child(panel);
+  panel.set_polar(polar);
+  window.present();
+
+  FrameCounter fc;
+  while (!window.get_mapped()) g_main_context_iteration(nullptr, TRUE);
+  GdkFrameClock* clock = gtk_widget_get_frame_clock(GTK_WIDGET(window.gobj()));
+  g_signal_connect(clock, "before-paint", G_CALLBACK(&FrameCounter::update_begin), &fc);
+  g_signal_connect(clock, "layout", G_CALLBACK(&FrameCounter::update_end), &fc);
+  g_signal_connect(clock, "after-paint", G_CALLBACK(&FrameCounter::painted), &fc);
+
+  const std::int64_t t0_us = g_get_monotonic_time() + 3'600'000'000;
+  int i = 0;
+
+  // Fill the statistics windows (10 min at one sample per second) so their
+  // rings have reached full size, then let everything settle on screen.
+  const int fill = static_cast<int>(panel.stats().config().windows_us.back() / 1'000'000) + 10;
+  for (; i < fill; ++i) panel.set_sample(sample(t0_us, i));
+  for (int k = 0; k < kWarmup; ++k, ++i) {
+    panel.set_sample(sample(t0_us, i));
+    pump_frame(fc);
+  }
+
+  bool ok = true;
+  {
+    const std::uint64_t before = g_allocations.load();
+    for (int k = 0; k < kFrames; ++k, ++i) {
+      {
+        Counting counting;
+        panel.set_sample(sample(t0_us, i));
+      }
+      pump_frame(fc);
+    }
+    ok = report("panel: set_sample", g_allocations.load() - before) && ok;
+  }
+
+  WindChannels channels(bus);
+  panel.bind_channels(bus);
+  for (int k = 0; k < kWarmup; ++k, ++i) {
+    channels.publish(sample(t0_us, i));
+    pump_frame(fc);
+  }
+  {
+    const std::uint64_t before = g_allocations.load();
+    for (int k = 0; k < kFrames; ++k, ++i) {
+      {
+        Counting counting;
+        channels.publish(sample(t0_us, i));
+      }
+      pump_frame(fc);
+    }
+    ok = report("panel: bound channels", g_allocations.load() - before) && ok;
+  }
+
+  g_signal_handlers_disconnect_by_data(clock, &fc);
+  window.unset_child();
+  return ok;
+}
+
+} // namespace
+
+int main() {
+  bool ok = check_faces();
+
+  if (gtk_init_check()) {
+    Gtk::init_gtkmm_internals();
+    ok = check_panel() && ok;
+  } else {
+    std::printf("%-28s skipped (no display)\n", "panel");
+  }
+
+  if (!ok) std::fprintf(stderr, "alloc_test: steady-state frames allocated\n");
+  return ok ? 0 : 1;
+}